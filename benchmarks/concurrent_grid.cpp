@@ -0,0 +1,81 @@
+// Throughput of ConcurrentGrid from 1 to 64 threads: each thread moves its
+// share of the entities to random positions and queries around every
+// hundredth of them, then the grid is compacted, as once per frame.
+
+#include <ecosnail/flat/grid.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+int main()
+{
+    constexpr std::size_t entityCount = 1 << 20;
+    constexpr std::size_t frameCount = 10;
+    const Rectangle<float> region{{0, 0}, {1000, 1000}};
+
+    std::printf("%8s %14s %14s %12s %14s\n",
+        "threads", "moves/s", "queries/s", "compact ms", "neighbors");
+    for (std::size_t threadCount = 1; threadCount <= 64; threadCount *= 2) {
+        ConcurrentGrid<float> grid(region, 4, entityCount);
+        std::vector<std::size_t> found(threadCount);
+        double updateSeconds = 0;
+        double compactSeconds = 0;
+
+        for (std::size_t frame = 0; frame < frameCount; frame++) {
+            const auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads;
+            for (std::size_t t = 0; t < threadCount; t++) {
+                threads.emplace_back([&, t] {
+                    std::mt19937 random(
+                        static_cast<unsigned>(frame * threadCount + t));
+                    std::uniform_real_distribution<float> coordinate(0, 1000);
+                    const std::size_t begin = entityCount * t / threadCount;
+                    const std::size_t end =
+                        entityCount * (t + 1) / threadCount;
+                    std::size_t neighbors = 0;
+                    for (std::size_t id = begin; id < end; id++) {
+                        const Point<float> point{
+                            coordinate(random), coordinate(random)};
+                        grid.move(id, point);
+                        if (id % 100 == 0) {
+                            grid.forEachWithin(point, 8, [&] (
+                                    std::size_t, const Point<float>&) {
+                                neighbors++;
+                            });
+                        }
+                    }
+                    found[t] += neighbors;
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            const auto updated = std::chrono::steady_clock::now();
+            grid.compact();
+            const auto compacted = std::chrono::steady_clock::now();
+
+            updateSeconds +=
+                std::chrono::duration<double>(updated - start).count();
+            compactSeconds +=
+                std::chrono::duration<double>(compacted - updated).count();
+        }
+
+        const double moves = double(entityCount) * frameCount;
+        std::size_t neighbors = 0;
+        for (auto count : found) {
+            neighbors += count;
+        }
+        std::printf("%8zu %14.0f %14.0f %12.2f %14zu\n",
+            threadCount,
+            moves / updateSeconds,
+            moves / 100 / updateSeconds,
+            1000 * compactSeconds / frameCount,
+            neighbors);
+    }
+}
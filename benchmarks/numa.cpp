@@ -0,0 +1,75 @@
+// Memory bandwidth of NumaBuffer passes with each partition placed on the
+// node whose threads process it, against pages interleaved over all nodes.
+// On a single-node machine both placements should perform the same.
+
+#include <ecosnail/flat/numa.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+constexpr std::size_t pointCount = std::size_t{1} << 24;
+constexpr int passCount = 10;
+
+// Seconds per pass of f over the buffer
+template <class F>
+double timePasses(NumaPointBuffer<float>& points, F&& f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passCount; pass++) {
+        points.parallelFor(f);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count() / passCount;
+}
+
+void run(const char* name, NumaPlacement placement)
+{
+    NumaPointBuffer<float> points(pointCount, placement);
+    points.parallelFor([] (
+            Point<float>* first, Point<float>* last, std::size_t offset) {
+        for (auto* point = first; point != last; point++) {
+            const auto i = static_cast<float>(offset + (point - first));
+            *point = {i, -i};
+        }
+    });
+
+    const double bytes = double(pointCount) * sizeof(Point<float>);
+    const double translate = timePasses(points, [] (
+            Point<float>* first, Point<float>* last, std::size_t) {
+        for (auto* point = first; point != last; point++) {
+            point->x += 1;
+            point->y -= 1;
+        }
+    });
+
+    std::atomic<double> total{0};
+    const double sum = timePasses(points, [&total] (
+            Point<float>* first, Point<float>* last, std::size_t) {
+        double partial = 0;
+        for (auto* point = first; point != last; point++) {
+            partial += point->x;
+        }
+        double expected = total.load();
+        while (!total.compare_exchange_weak(expected, expected + partial)) { }
+    });
+
+    std::printf("%-12s %10zu %16.2f %16.2f %14g\n",
+        name, points.partitionCount(),
+        2 * bytes / translate / 1e9, bytes / sum / 1e9, total.load());
+}
+
+} // namespace
+
+int main()
+{
+    std::printf("%-12s %10s %16s %16s %14s\n",
+        "placement", "partitions", "translate GB/s", "sum GB/s", "checksum");
+    run("local", NumaPlacement::Local);
+    run("interleaved", NumaPlacement::Interleaved);
+}
@@ -1,4 +1,11 @@
 #pragma once
 
+// Core types only, cheap enough to include everywhere. The other modules
+// (projections, clustering, triangulation, pipelines, tiles, ...) pull in
+// threads, system headers or large algorithms, and are included one by one
+// from <ecosnail/flat/...> where they are used; the ecosnail.flat module
+// exports all of them.
+
+#include <ecosnail/flat/instantiations.hpp>
 #include <ecosnail/flat/point.hpp>
 #include <ecosnail/flat/vector.hpp>
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <ecosnail/flat/coordinates.hpp>
+#include <ecosnail/flat/point.hpp>
+#include <ecosnail/flat/vector.hpp>
+
+#include <cmath>
+#include <cstddef>
+
+namespace ecosnail::flat::batch {
+
+// Kernels over contiguous arrays of points and vectors. The per-component
+// work is unrolled at compile time for each dimension, which leaves plain
+// loops over the elements for the compiler to vectorize.
+
+template <class T, std::size_t N>
+void translate(
+    Point<T, N>* points, std::size_t count, const Vector<T, N>& offset)
+{
+    for (std::size_t i = 0; i < count; i++) {
+        detail::unroll<N>([&] (auto c) {
+            get<c>(points[i]) += get<c>(offset);
+        });
+    }
+}
+
+template <class T, std::size_t N>
+void scale(Vector<T, N>* vectors, std::size_t count, const T& scalar)
+{
+    for (std::size_t i = 0; i < count; i++) {
+        detail::unroll<N>([&] (auto c) {
+            get<c>(vectors[i]) *= scalar;
+        });
+    }
+}
+
+template <class T, std::size_t N>
+void dot(
+    const Vector<T, N>* lhs, const Vector<T, N>* rhs, std::size_t count, T* out)
+{
+    for (std::size_t i = 0; i < count; i++) {
+        out[i] = detail::sum<N>([&] (auto c) {
+            return get<c>(lhs[i]) * get<c>(rhs[i]);
+        });
+    }
+}
+
+template <class T, std::size_t N>
+void length(const Vector<T, N>* vectors, std::size_t count, T* out)
+{
+    using std::sqrt;
+    for (std::size_t i = 0; i < count; i++) {
+        out[i] = sqrt(detail::sum<N>([&] (auto c) {
+            return get<c>(vectors[i]) * get<c>(vectors[i]);
+        }));
+    }
+}
+
+template <class T, std::size_t N>
+void normalize(Vector<T, N>* vectors, std::size_t count)
+{
+    using std::sqrt;
+    for (std::size_t i = 0; i < count; i++) {
+        T l = sqrt(detail::sum<N>([&] (auto c) {
+            return get<c>(vectors[i]) * get<c>(vectors[i]);
+        }));
+        T factor = l == 0 ? T{} : T{1} / l;
+        detail::unroll<N>([&] (auto c) {
+            get<c>(vectors[i]) *= factor;
+        });
+    }
+}
+
+template <class T, std::size_t N>
+void distance(
+    const Point<T, N>* lhs, const Point<T, N>* rhs, std::size_t count, T* out)
+{
+    using std::sqrt;
+    for (std::size_t i = 0; i < count; i++) {
+        out[i] = sqrt(detail::sum<N>([&] (auto c) {
+            T d = get<c>(lhs[i]) - get<c>(rhs[i]);
+            return d * d;
+        }));
+    }
+}
+
+} // namespace ecosnail::flat::batch
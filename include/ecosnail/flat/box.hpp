@@ -0,0 +1,348 @@
+#pragma once
+
+#include <ecosnail/flat/enclosing.hpp>
+#include <ecosnail/flat/parallel.hpp>
+#include <ecosnail/flat/point.hpp>
+#include <ecosnail/flat/vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+namespace ecosnail::flat {
+
+// Box with orthonormal axes, extending halfExtents[i] from the center along
+// each of axes[i] in both directions.
+template <class T, std::size_t N = 2>
+struct OrientedBox {
+    Point<T, N> center;
+    Vector<T, N> axes[N];
+    Vector<T, N> halfExtents;
+};
+
+template <class T>
+OrientedBox<T, 2> orientedBox(const OrientedRectangle<T>& rectangle)
+{
+    return {
+        rectangle.center,
+        {rectangle.axis, Vector<T>{-rectangle.axis.y, rectangle.axis.x}},
+        Vector<T>{rectangle.halfLength, rectangle.halfWidth}};
+}
+
+namespace detail {
+
+template <class T, std::size_t N>
+struct Moments {
+    Point<T, N> mean;
+    T covariance[N][N];
+};
+
+// Mean and covariance in two passes, for accuracy far from the origin. Each
+// pass accumulates points in groups of Lanes into independent partial sums,
+// which the compiler keeps in vector registers without having to reorder
+// floating-point additions.
+template <class T, std::size_t N>
+Moments<T, N> moments(const Point<T, N>* points, std::size_t count)
+{
+    constexpr std::size_t lanes = 4;
+    const std::size_t blocked = count - count % lanes;
+
+    T sums[N][lanes] = {};
+    for (std::size_t i = 0; i < blocked; i += lanes) {
+        for (std::size_t l = 0; l < lanes; l++) {
+            unroll<N>([&] (auto d) {
+                sums[d][l] += get<d>(points[i + l]);
+            });
+        }
+    }
+    for (std::size_t i = blocked; i < count; i++) {
+        unroll<N>([&] (auto d) { sums[d][0] += get<d>(points[i]); });
+    }
+
+    Moments<T, N> result {};
+    unroll<N>([&] (auto d) {
+        T sum = 0;
+        for (std::size_t l = 0; l < lanes; l++) {
+            sum += sums[d][l];
+        }
+        get<d>(result.mean) = sum / T(count);
+    });
+
+    T products[N][N][lanes] = {};
+    auto accumulate = [&] (const Point<T, N>& point, std::size_t lane) {
+        const auto offset = point - result.mean;
+        unroll<N>([&] (auto r) {
+            unroll<N>([&] (auto c) {
+                if constexpr (c >= r) {
+                    products[r][c][lane] += get<r>(offset) * get<c>(offset);
+                }
+            });
+        });
+    };
+    for (std::size_t i = 0; i < blocked; i += lanes) {
+        for (std::size_t l = 0; l < lanes; l++) {
+            accumulate(points[i + l], l);
+        }
+    }
+    for (std::size_t i = blocked; i < count; i++) {
+        accumulate(points[i], 0);
+    }
+
+    for (std::size_t r = 0; r < N; r++) {
+        for (std::size_t c = r; c < N; c++) {
+            T sum = 0;
+            for (std::size_t l = 0; l < lanes; l++) {
+                sum += products[r][c][l];
+            }
+            result.covariance[r][c] = result.covariance[c][r] =
+                sum / T(count);
+        }
+    }
+    return result;
+}
+
+// Eigenvectors of a symmetric matrix by cyclic Jacobi rotations, sorted by
+// decreasing eigenvalue. The matrix is diagonalized in place.
+template <class T, std::size_t N>
+void symmetricEigenvectors(T (&matrix)[N][N], Vector<T, N> (&vectors)[N])
+{
+    using std::abs;
+    using std::sqrt;
+
+    T basis[N][N] = {};
+    for (std::size_t i = 0; i < N; i++) {
+        basis[i][i] = 1;
+    }
+
+    for (int sweep = 0; sweep < 32; sweep++) {
+        T off = 0;
+        T diagonal = 0;
+        for (std::size_t p = 0; p < N; p++) {
+            diagonal += matrix[p][p] * matrix[p][p];
+            for (std::size_t q = p + 1; q < N; q++) {
+                off += matrix[p][q] * matrix[p][q];
+            }
+        }
+        if (off <= std::numeric_limits<T>::epsilon() *
+                std::numeric_limits<T>::epsilon() * diagonal) {
+            break;
+        }
+
+        for (std::size_t p = 0; p < N; p++) {
+            for (std::size_t q = p + 1; q < N; q++) {
+                if (matrix[p][q] == 0) {
+                    continue;
+                }
+                const T theta =
+                    (matrix[q][q] - matrix[p][p]) / (2 * matrix[p][q]);
+                const T t = (theta < 0 ? -1 : 1) /
+                    (abs(theta) + sqrt(theta * theta + 1));
+                const T c = 1 / sqrt(t * t + 1);
+                const T s = t * c;
+                for (std::size_t k = 0; k < N; k++) {
+                    const T kp = matrix[k][p];
+                    const T kq = matrix[k][q];
+                    matrix[k][p] = c * kp - s * kq;
+                    matrix[k][q] = s * kp + c * kq;
+                }
+                for (std::size_t k = 0; k < N; k++) {
+                    const T pk = matrix[p][k];
+                    const T qk = matrix[q][k];
+                    matrix[p][k] = c * pk - s * qk;
+                    matrix[q][k] = s * pk + c * qk;
+                }
+                for (std::size_t k = 0; k < N; k++) {
+                    const T kp = basis[k][p];
+                    const T kq = basis[k][q];
+                    basis[k][p] = c * kp - s * kq;
+                    basis[k][q] = s * kp + c * kq;
+                }
+            }
+        }
+    }
+
+    std::size_t order[N];
+    for (std::size_t i = 0; i < N; i++) {
+        order[i] = i;
+    }
+    std::sort(order, order + N, [&] (std::size_t a, std::size_t b) {
+        return matrix[a][a] > matrix[b][b];
+    });
+    for (std::size_t i = 0; i < N; i++) {
+        for (std::size_t k = 0; k < N; k++) {
+            vectors[i][k] = basis[k][order[i]];
+        }
+    }
+}
+
+// Tightest box with the given axes; box.axes must be set.
+template <class T, std::size_t N>
+void fitExtents(
+    OrientedBox<T, N>& box,
+    const Point<T, N>& origin,
+    const Point<T, N>* points,
+    std::size_t count)
+{
+    T low[N];
+    T high[N];
+    std::fill(low, low + N, std::numeric_limits<T>::infinity());
+    std::fill(high, high + N, -std::numeric_limits<T>::infinity());
+    for (std::size_t i = 0; i < count; i++) {
+        const auto offset = points[i] - origin;
+        for (std::size_t d = 0; d < N; d++) {
+            const T projection = dot(offset, box.axes[d]);
+            low[d] = std::min(low[d], projection);
+            high[d] = std::max(high[d], projection);
+        }
+    }
+    box.center = origin;
+    for (std::size_t d = 0; d < N; d++) {
+        box.center += box.axes[d] * ((low[d] + high[d]) / 2);
+        box.halfExtents[d] = (high[d] - low[d]) / 2;
+    }
+}
+
+} // namespace detail
+
+// Box along the principal axes of the points (eigenvectors of their
+// covariance), largest spread first. Linear time, but not the tightest box
+// for skewed distributions; see minimumAreaBox() for that in 2D.
+template <class T, std::size_t N>
+OrientedBox<T, N> principalAxesBox(
+    const Point<T, N>* points, std::size_t count)
+{
+    static_assert(std::is_floating_point_v<T>);
+
+    if (count == 0) {
+        return {};
+    }
+    auto moments = detail::moments(points, count);
+    OrientedBox<T, N> box;
+    detail::symmetricEigenvectors(moments.covariance, box.axes);
+    detail::fitExtents(box, moments.mean, points, count);
+    return box;
+}
+
+// Minimum-area box, from rotating calipers over the convex hull; scratch
+// must hold count points.
+template <class T>
+OrientedBox<T, 2> minimumAreaBox(
+    const Point<T>* points, std::size_t count, Point<T>* scratch)
+{
+    const auto size = convexHull(points, count, scratch);
+    return orientedBox(minimumAreaRectangle(scratch, size));
+}
+
+// Overlap test by the separating axis theorem: the face normals of both
+// boxes, and in 3D also the cross products of their edges. Coordinates are
+// taken relative to the axes of the first box, so only N * N dot products
+// are computed up front.
+template <class T, std::size_t N>
+bool overlaps(const OrientedBox<T, N>& a, const OrientedBox<T, N>& b)
+{
+    static_assert(N == 2 || N == 3,
+        "separating axes are only enumerated for 2D and 3D boxes");
+    using std::abs;
+
+    // rotation from b to a; the epsilon keeps nearly parallel edges in 3D
+    // from producing spurious separating axes
+    constexpr T epsilon = 64 * std::numeric_limits<T>::epsilon();
+    T rotation[N][N];
+    T absRotation[N][N];
+    for (std::size_t i = 0; i < N; i++) {
+        for (std::size_t j = 0; j < N; j++) {
+            rotation[i][j] = dot(a.axes[i], b.axes[j]);
+            absRotation[i][j] = abs(rotation[i][j]) + epsilon;
+        }
+    }
+
+    const auto offset = b.center - a.center;
+    T t[N];
+    for (std::size_t i = 0; i < N; i++) {
+        t[i] = dot(offset, a.axes[i]);
+    }
+
+    for (std::size_t i = 0; i < N; i++) {
+        T rb = 0;
+        for (std::size_t j = 0; j < N; j++) {
+            rb += b.halfExtents[j] * absRotation[i][j];
+        }
+        if (abs(t[i]) > a.halfExtents[i] + rb) {
+            return false;
+        }
+    }
+
+    for (std::size_t j = 0; j < N; j++) {
+        T ra = 0;
+        T distance = 0;
+        for (std::size_t i = 0; i < N; i++) {
+            ra += a.halfExtents[i] * absRotation[i][j];
+            distance += t[i] * rotation[i][j];
+        }
+        if (abs(distance) > ra + b.halfExtents[j]) {
+            return false;
+        }
+    }
+
+    if constexpr (N == 3) {
+        for (std::size_t i = 0; i < 3; i++) {
+            const std::size_t i1 = (i + 1) % 3;
+            const std::size_t i2 = (i + 2) % 3;
+            for (std::size_t j = 0; j < 3; j++) {
+                const std::size_t j1 = (j + 1) % 3;
+                const std::size_t j2 = (j + 2) % 3;
+                const T ra = a.halfExtents[i1] * absRotation[i2][j] +
+                    a.halfExtents[i2] * absRotation[i1][j];
+                const T rb = b.halfExtents[j1] * absRotation[i][j2] +
+                    b.halfExtents[j2] * absRotation[i][j1];
+                const T distance =
+                    t[i2] * rotation[i1][j] - t[i1] * rotation[i2][j];
+                if (abs(distance) > ra + rb) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+namespace batch {
+
+// Boxes of clusters stored back to back: cluster i is points
+// [clusterOffsets[i], clusterOffsets[i + 1]).
+template <class T, std::size_t N>
+void principalAxesBox(
+    const Point<T, N>* points,
+    const std::size_t* clusterOffsets,
+    std::size_t clusterCount,
+    OrientedBox<T, N>* boxes)
+{
+    parallelFor(clusterCount, [&] (std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            boxes[i] = flat::principalAxesBox(
+                points + clusterOffsets[i],
+                clusterOffsets[i + 1] - clusterOffsets[i]);
+        }
+    }, 256);
+}
+
+// Overlap of each box with one query box, e.g. for culling
+template <class T, std::size_t N>
+void overlaps(
+    const OrientedBox<T, N>* boxes,
+    std::size_t count,
+    const OrientedBox<T, N>& query,
+    bool* results)
+{
+    parallelFor(count, [&] (std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            results[i] = flat::overlaps(query, boxes[i]);
+        }
+    }, 4096);
+}
+
+} // namespace batch
+
+} // namespace ecosnail::flat
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <ecosnail/flat/parallel.hpp>
+#include <ecosnail/flat/point.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<sys/mman.h>)
+    #include <sys/mman.h>
+#endif
+
+// Bulk storage for large point arrays that are about to be overwritten, e.g.
+// by a loader: nothing is zero-filled, memory comes straight from the
+// operating system in transparent huge pages where possible, and pages are
+// first touched in parallel so that each lands on the NUMA node of the
+// thread that will process it.
+
+namespace ecosnail::flat {
+
+// Allocator whose value-initialization default-initializes instead, so that
+// std::vector<Point<float>, DefaultInitAllocator<Point<float>>>(count)
+// leaves the points uninitialized.
+template <class T, class Base = std::allocator<T>>
+class DefaultInitAllocator : public Base {
+    using Traits = std::allocator_traits<Base>;
+
+public:
+    template <class U>
+    struct rebind {
+        using other = DefaultInitAllocator<
+            U, typename Traits::template rebind_alloc<U>>;
+    };
+
+    using Base::Base;
+
+    template <class U>
+    void construct(U* target)
+        noexcept(std::is_nothrow_default_constructible_v<U>)
+    {
+        ::new (static_cast<void*>(target)) U;
+    }
+
+    template <class U, class... Args>
+    void construct(U* target, Args&&... args)
+    {
+        Traits::construct(
+            static_cast<Base&>(*this), target, std::forward<Args>(args)...);
+    }
+};
+
+namespace detail {
+
+constexpr std::size_t hugePageSize = std::size_t{2} << 20;
+constexpr std::size_t smallPageSize = 4096;
+
+// Returns the mapping and the number of bytes mapped. Throws std::bad_alloc
+// if the mapping fails or its size does not fit in std::size_t.
+inline std::pair<void*, std::size_t> mapMemory(std::size_t bytes)
+{
+    // room for rounding up and over-mapping below
+    if (bytes > std::numeric_limits<std::size_t>::max() - 2 * hugePageSize) {
+        throw std::bad_alloc{};
+    }
+    const bool huge = bytes >= hugePageSize;
+    const std::size_t page = huge ? hugePageSize : smallPageSize;
+    bytes = (bytes + page - 1) / page * page;
+
+#if __has_include(<sys/mman.h>)
+    // over-map to cut out a range aligned to a huge page
+    const std::size_t mapped = huge ? bytes + hugePageSize : bytes;
+    void* memory = mmap(
+        nullptr, mapped,
+        PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        throw std::bad_alloc{};
+    }
+    if (!huge) {
+        return {memory, bytes};
+    }
+
+    const auto address = reinterpret_cast<std::uintptr_t>(memory);
+    const auto aligned = (address + hugePageSize - 1) & ~(hugePageSize - 1);
+    const std::size_t head = aligned - address;
+    const std::size_t tail = mapped - head - bytes;
+    if (head > 0) {
+        munmap(memory, head);
+    }
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+    }
+    #ifdef MADV_HUGEPAGE
+        // only a hint: without transparent huge pages this fails harmlessly
+        madvise(reinterpret_cast<void*>(aligned), bytes, MADV_HUGEPAGE);
+    #endif
+    return {reinterpret_cast<void*>(aligned), bytes};
+#else
+    return {::operator new(bytes, std::align_val_t{page}), bytes};
+#endif
+}
+
+inline void unmapMemory(void* memory, std::size_t bytes)
+{
+#if __has_include(<sys/mman.h>)
+    munmap(memory, bytes);
+#else
+    const std::size_t page =
+        bytes >= hugePageSize ? hugePageSize : smallPageSize;
+    ::operator delete(memory, std::align_val_t{page});
+#endif
+}
+
+} // namespace detail
+
+// Fixed-size array of trivial elements, left uninitialized. With firstTouch,
+// the constructor writes one byte per page, splitting the array between
+// threads like parallelFor() does for any large count; code that later
+// fills the buffer with parallelFor() then mostly writes to node-local
+// memory. Throws std::bad_alloc if the memory cannot be mapped, including
+// when size * sizeof(T) overflows.
+template <class T>
+class UninitializedBuffer {
+    static_assert(std::is_trivially_default_constructible_v<T>);
+    static_assert(std::is_trivially_destructible_v<T>);
+
+public:
+    UninitializedBuffer() = default;
+
+    explicit UninitializedBuffer(std::size_t size, bool firstTouch = true)
+        : _size(size)
+    {
+        if (size == 0) {
+            return;
+        }
+        if (size > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_alloc{};
+        }
+        auto [memory, bytes] = detail::mapMemory(size * sizeof(T));
+        _data = static_cast<T*>(memory);
+        _bytes = bytes;
+        if (firstTouch) {
+            touch();
+        }
+    }
+
+    UninitializedBuffer(UninitializedBuffer&& other) noexcept
+        : _data(std::exchange(other._data, nullptr))
+        , _size(std::exchange(other._size, 0))
+        , _bytes(std::exchange(other._bytes, 0))
+    { }
+
+    UninitializedBuffer& operator=(UninitializedBuffer&& other) noexcept
+    {
+        if (this != &other) {
+            release();
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+            _bytes = std::exchange(other._bytes, 0);
+        }
+        return *this;
+    }
+
+    ~UninitializedBuffer()
+    {
+        release();
+    }
+
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    T* data()
+    {
+        return _data;
+    }
+
+    const T* data() const
+    {
+        return _data;
+    }
+
+    T& operator[](std::size_t i)
+    {
+        return _data[i];
+    }
+
+    const T& operator[](std::size_t i) const
+    {
+        return _data[i];
+    }
+
+    T* begin()
+    {
+        return _data;
+    }
+
+    T* end()
+    {
+        return _data + _size;
+    }
+
+    const T* begin() const
+    {
+        return _data;
+    }
+
+    const T* end() const
+    {
+        return _data + _size;
+    }
+
+private:
+    void touch()
+    {
+        auto* bytes = reinterpret_cast<volatile unsigned char*>(_data);
+        parallelFor(_size, [&] (std::size_t begin, std::size_t end) {
+            const std::size_t first = begin * sizeof(T);
+            const std::size_t last = end * sizeof(T);
+            for (std::size_t offset = first; offset < last;
+                    offset += detail::smallPageSize) {
+                bytes[offset] = 0;
+            }
+        });
+    }
+
+    void release()
+    {
+        if (_data) {
+            detail::unmapMemory(_data, _bytes);
+        }
+    }
+
+    T* _data = nullptr;
+    std::size_t _size = 0;
+    std::size_t _bytes = 0;
+};
+
+template <class T, std::size_t N = 2>
+using UninitializedPointBuffer = UninitializedBuffer<Point<T, N>>;
+
+} // namespace ecosnail::flat
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <ecosnail/flat/grid.hpp>
+#include <ecosnail/flat/parallel.hpp>
+#include <ecosnail/flat/point.hpp>
+#include <ecosnail/flat/vector.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <vector>
+
+namespace ecosnail::flat {
+
+// k-means
+
+template <class T>
+struct KMeansResult {
+    std::vector<Point<T>> centers;
+    // index of the center of each point
+    std::vector<std::size_t> labels;
+    std::size_t iterations = 0;
+};
+
+namespace detail {
+
+template <class T>
+T squaredDistance(const Point<T>& lhs, const Point<T>& rhs)
+{
+    const T dx = lhs.x - rhs.x;
+    const T dy = lhs.y - rhs.y;
+    return dx * dx + dy * dy;
+}
+
+// k-means++ seeding: each next center is a point picked with probability
+// proportional to its squared distance from the closest center so far.
+template <class T>
+std::vector<Point<T>> kMeansPlusPlus(
+    const Point<T>* points, std::size_t count, std::size_t k,
+    std::mt19937_64& random)
+{
+    std::vector<Point<T>> centers;
+    centers.reserve(k);
+    centers.push_back(points[
+        std::uniform_int_distribution<std::size_t>(0, count - 1)(random)]);
+
+    std::vector<double> weights(count);
+    for (std::size_t i = 0; i < count; i++) {
+        weights[i] = squaredDistance(points[i], centers.back());
+    }
+    while (centers.size() < k) {
+        std::discrete_distribution<std::size_t> pick(
+            weights.begin(), weights.end());
+        centers.push_back(points[pick(random)]);
+        parallelFor(count, [&] (std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                weights[i] = std::min<double>(
+                    weights[i], squaredDistance(points[i], centers.back()));
+            }
+        });
+    }
+    return centers;
+}
+
+} // namespace detail
+
+// Lloyd's k-means with k-means++ seeding, accelerated with Hamerly's bounds:
+// each point keeps an upper bound on the distance to its center and a lower
+// bound on the distance to any other center, and is only compared against
+// all centers when the bounds no longer prove its assignment. Requires
+// 0 < k <= count.
+template <class T>
+KMeansResult<T> kMeans(
+    const Point<T>* points,
+    std::size_t count,
+    std::size_t k,
+    std::size_t maxIterations = 100,
+    std::uint64_t seed = 0)
+{
+    assert(k > 0 && k <= count);
+    using std::sqrt;
+
+    std::mt19937_64 random(seed);
+    KMeansResult<T> result;
+    result.centers = detail::kMeansPlusPlus(points, count, k, random);
+    result.labels.assign(count, 0);
+
+    std::vector<T> upper(count, std::numeric_limits<T>::max());
+    std::vector<T> lower(count, 0);
+    std::vector<T> halfSeparation(k);
+    std::vector<T> movement(k);
+    std::mutex mergeMutex;
+
+    for (; result.iterations < maxIterations; result.iterations++) {
+        const auto& centers = result.centers;
+        for (std::size_t c = 0; c < k; c++) {
+            T closest = std::numeric_limits<T>::max();
+            for (std::size_t other = 0; other < k; other++) {
+                if (other != c) {
+                    closest = std::min(closest, length(
+                        centers[c] - centers[other]));
+                }
+            }
+            halfSeparation[c] = closest / 2;
+        }
+
+        std::atomic<std::size_t> changes {0};
+        parallelFor(count, [&] (std::size_t begin, std::size_t end) {
+            std::size_t localChanges = 0;
+            for (std::size_t i = begin; i < end; i++) {
+                auto& label = result.labels[i];
+                const T bound = std::max(halfSeparation[label], lower[i]);
+                if (upper[i] <= bound) {
+                    continue;
+                }
+                upper[i] = sqrt(detail::squaredDistance(
+                    points[i], centers[label]));
+                if (upper[i] <= bound) {
+                    continue;
+                }
+
+                T best = std::numeric_limits<T>::max();
+                T second = std::numeric_limits<T>::max();
+                std::size_t bestCenter = 0;
+                for (std::size_t c = 0; c < k; c++) {
+                    const T d = detail::squaredDistance(points[i], centers[c]);
+                    if (d < best) {
+                        second = best;
+                        best = d;
+                        bestCenter = c;
+                    } else if (d < second) {
+                        second = d;
+                    }
+                }
+                if (bestCenter != label) {
+                    label = bestCenter;
+                    localChanges++;
+                }
+                upper[i] = sqrt(best);
+                lower[i] = sqrt(second);
+            }
+            changes += localChanges;
+        });
+
+        if (changes == 0 && result.iterations > 0) {
+            break;
+        }
+
+        std::vector<Vector<double>> sums(k);
+        std::vector<std::size_t> sizes(k, 0);
+        parallelFor(count, [&] (std::size_t begin, std::size_t end) {
+            std::vector<Vector<double>> localSums(k);
+            std::vector<std::size_t> localSizes(k, 0);
+            for (std::size_t i = begin; i < end; i++) {
+                const auto label = result.labels[i];
+                localSums[label] += Vector<double>{
+                    static_cast<double>(points[i].x),
+                    static_cast<double>(points[i].y)};
+                localSizes[label]++;
+            }
+            std::lock_guard lock(mergeMutex);
+            for (std::size_t c = 0; c < k; c++) {
+                sums[c] += localSums[c];
+                sizes[c] += localSizes[c];
+            }
+        });
+
+        // the two largest movements, for the lower bound update
+        std::size_t farthest = 0;
+        T maxMovement = 0;
+        T secondMovement = 0;
+        for (std::size_t c = 0; c < k; c++) {
+            auto center = result.centers[c];
+            if (sizes[c] > 0) {
+                center = {
+                    static_cast<T>(sums[c].x / sizes[c]),
+                    static_cast<T>(sums[c].y / sizes[c])};
+            }
+            movement[c] = length(center - result.centers[c]);
+            result.centers[c] = center;
+            if (movement[c] > maxMovement) {
+                secondMovement = maxMovement;
+                maxMovement = movement[c];
+                farthest = c;
+            } else if (movement[c] > secondMovement) {
+                secondMovement = movement[c];
+            }
+        }
+
+        parallelFor(count, [&] (std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                const auto label = result.labels[i];
+                upper[i] += movement[label];
+                lower[i] -= label == farthest ? secondMovement : maxMovement;
+            }
+        });
+    }
+
+    return result;
+}
+
+// DBSCAN
+
+// Label of points that belong to no cluster.
+inline constexpr std::size_t noise = std::numeric_limits<std::size_t>::max();
+
+namespace detail {
+
+// Union-find safe for concurrent unite() calls: roots are only ever linked
+// to a smaller index, with compare-and-swap, so no cycles can form.
+class ConcurrentDisjointSets {
+public:
+    explicit ConcurrentDisjointSets(std::size_t count)
+        : _parents(count)
+    {
+        for (std::size_t i = 0; i < count; i++) {
+            _parents[i].store(i, std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t find(std::size_t x)
+    {
+        for (;;) {
+            auto parent = _parents[x].load();
+            if (parent == x) {
+                return x;
+            }
+            const auto grandparent = _parents[parent].load();
+            if (parent != grandparent) {
+                _parents[x].compare_exchange_weak(parent, grandparent);
+            }
+            x = grandparent;
+        }
+    }
+
+    void unite(std::size_t a, std::size_t b)
+    {
+        for (;;) {
+            a = find(a);
+            b = find(b);
+            if (a == b) {
+                return;
+            }
+            if (a < b) {
+                std::swap(a, b);
+            }
+            auto expected = a;
+            if (_parents[a].compare_exchange_strong(expected, b)) {
+                return;
+            }
+        }
+    }
+
+private:
+    std::vector<std::atomic<std::size_t>> _parents;
+};
+
+} // namespace detail
+
+// Density-based clustering: points with at least minPoints points (counting
+// themselves) within eps are core points; core points within eps of each
+// other share a cluster, and other points within eps of a core point join
+// the cluster of the lowest-indexed such core point. Returns the cluster of
+// each point, numbered from 0 in order of first appearance, or `noise`.
+template <class T>
+std::vector<std::size_t> dbscan(
+    const Point<T>* points, std::size_t count, T eps, std::size_t minPoints)
+{
+    const GridIndex<T> grid(points, count, eps);
+
+    std::vector<char> core(count);
+    parallelFor(count, [&] (std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            core[i] = grid.countWithin(points[i], eps, minPoints) >= minPoints;
+        }
+    });
+
+    detail::ConcurrentDisjointSets sets(count);
+    std::vector<std::size_t> labels(count, noise);
+    parallelFor(count, [&] (std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            grid.forEachWithin(points[i], eps, [&] (std::size_t j) {
+                if (core[i] && core[j] && j < i) {
+                    sets.unite(i, j);
+                } else if (!core[i] && core[j] && j < labels[i]) {
+                    // border point: remember its lowest core neighbor
+                    labels[i] = j;
+                }
+            });
+        }
+    });
+
+    std::vector<std::size_t> clusterOfRoot(count, noise);
+    std::size_t clusters = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        const auto owner = core[i] ? i : labels[i];
+        if (owner == noise) {
+            continue;
+        }
+        auto& cluster = clusterOfRoot[sets.find(owner)];
+        if (cluster == noise) {
+            cluster = clusters++;
+        }
+        labels[i] = cluster;
+    }
+    return labels;
+}
+
+} // namespace ecosnail::flat
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <ecosnail/flat/parallel.hpp>
+#include <ecosnail/flat/point.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Stream compaction: filtering of point arrays by predicate, in parallel
+// and preserving order, into index lists or packed copies. Arrays of
+// structures are given as Point pointers, structures of arrays as one
+// pointer per coordinate, like loadSoa() and storeSoa().
+//
+// The dispatch library provides the same compaction from precomputed flags
+// with AVX2 and AVX-512 compress kernels.
+
+namespace ecosnail::flat {
+
+namespace detail {
+
+constexpr std::size_t compactionBlock = 16384;
+constexpr std::size_t compactionBatch = 512;
+
+// Compacts the items i in [0, count) for which keep(i, list) holds, for
+// each of listCount outputs. store(list, position, i) writes item i at a
+// position of an output, move(list, to, from, size) moves a range within
+// it; sizes receives the compacted sizes.
+//
+// Blocks are compacted in parallel into their own ranges of the outputs,
+// then moved together. Within a block, the predicate is first evaluated
+// into byte flags for a batch of items, in a loop free of branches that the
+// compiler can vectorize; items are then stored from the flags, eight at a
+// time, skipping groups with nothing to keep.
+template <class Keep, class Store, class Move>
+void compactBlocks(
+    std::size_t count,
+    std::size_t listCount,
+    Keep&& keep,
+    Store&& store,
+    Move&& move,
+    std::size_t* sizes)
+{
+    const std::size_t blockCount =
+        (count + compactionBlock - 1) / compactionBlock;
+    std::vector<std::size_t> blockSizes(blockCount * listCount);
+
+    parallelFor(blockCount, [&] (std::size_t firstBlock, std::size_t last) {
+        alignas(64) std::uint8_t flags[compactionBatch];
+        for (std::size_t block = firstBlock; block < last; block++) {
+            const std::size_t begin = block * compactionBlock;
+            const std::size_t end = std::min(begin + compactionBlock, count);
+            for (std::size_t list = 0; list < listCount; list++) {
+                std::size_t size = begin;
+                for (std::size_t batch = begin; batch < end;
+                        batch += compactionBatch) {
+                    const std::size_t batchSize =
+                        std::min(compactionBatch, end - batch);
+                    for (std::size_t j = 0; j < batchSize; j++) {
+                        flags[j] = static_cast<bool>(keep(batch + j, list));
+                    }
+                    std::fill(flags + batchSize, flags + compactionBatch, 0);
+
+                    for (std::size_t j = 0; j < batchSize; j += 8) {
+                        std::uint64_t group;
+                        std::memcpy(&group, flags + j, sizeof(group));
+                        if (group == 0) {
+                            continue;
+                        }
+                        const std::size_t groupEnd = std::min(j + 8, batchSize);
+                        for (std::size_t k = j; k < groupEnd; k++) {
+                            store(list, size, batch + k);
+                            size += flags[k];
+                        }
+                    }
+                }
+                blockSizes[block * listCount + list] = size - begin;
+            }
+        }
+    }, 1);
+
+    for (std::size_t list = 0; list < listCount; list++) {
+        std::size_t size = 0;
+        for (std::size_t block = 0; block < blockCount; block++) {
+            const std::size_t blockSize = blockSizes[block * listCount + list];
+            const std::size_t begin = block * compactionBlock;
+            if (begin != size) {
+                move(list, size, begin, blockSize);
+            }
+            size += blockSize;
+        }
+        sizes[list] = size;
+    }
+}
+
+// Indices i in [0, count) for which keep(i, list) holds, for each of
+// listCount outputs of capacity count.
+template <class Keep>
+void compactIndices(
+    std::size_t count,
+    std::size_t listCount,
+    Keep&& keep,
+    std::uint32_t* const* indices,
+    std::size_t* sizes)
+{
+    compactBlocks(
+        count,
+        listCount,
+        keep,
+        [indices] (std::size_t list, std::size_t position, std::size_t i) {
+            indices[list][position] = static_cast<std::uint32_t>(i);
+        },
+        [indices] (
+                std::size_t list,
+                std::size_t to,
+                std::size_t from,
+                std::size_t size) {
+            std::copy(
+                indices[list] + from,
+                indices[list] + from + size,
+                indices[list] + to);
+        },
+        sizes);
+}
+
+// Stable partition of the items i in [0, count) by keep(i): copy(to, i)
+// places the kept items first, then the others, each in input order.
+// Returns the number of kept items.
+template <class Keep, class Copy>
+std::size_t partitionBlocks(std::size_t count, Keep&& keep, Copy&& copy)
+{
+    const std::size_t blockCount =
+        (count + compactionBlock - 1) / compactionBlock;
+    std::vector<std::uint8_t> flags(count);
+    std::vector<std::size_t> offsets(blockCount + 1);
+
+    parallelFor(blockCount, [&] (std::size_t firstBlock, std::size_t last) {
+        for (std::size_t b = firstBlock; b < last; b++) {
+            const std::size_t end = std::min((b + 1) * compactionBlock, count);
+            std::size_t selected = 0;
+            for (std::size_t i = b * compactionBlock; i < end; i++) {
+                flags[i] = static_cast<bool>(keep(i));
+                selected += flags[i];
+            }
+            offsets[b + 1] = selected;
+        }
+    }, 1);
+    for (std::size_t b = 0; b < blockCount; b++) {
+        offsets[b + 1] += offsets[b];
+    }
+    const std::size_t selected = offsets[blockCount];
+
+    parallelFor(blockCount, [&] (std::size_t firstBlock, std::size_t last) {
+        for (std::size_t b = firstBlock; b < last; b++) {
+            const std::size_t begin = b * compactionBlock;
+            const std::size_t end = std::min(begin + compactionBlock, count);
+            std::size_t kept = offsets[b];
+            std::size_t rejected = selected + begin - offsets[b];
+            for (std::size_t i = begin; i < end; i++) {
+                copy(flags[i] ? kept++ : rejected++, i);
+            }
+        }
+    }, 1);
+    return selected;
+}
+
+template <class T, std::size_t N>
+Point<T, N> gather(const T* const (&source)[N], std::size_t i)
+{
+    Point<T, N> point;
+    unroll<N>([&] (auto c) { get<c>(point) = source[c][i]; });
+    return point;
+}
+
+} // namespace detail
+
+// Indices of the points satisfying predicate(point); indices must hold
+// count elements. Returns the number of indices written.
+template <class T, std::size_t N, class Predicate>
+std::size_t filterIndices(
+    const Point<T, N>* points,
+    std::size_t count,
+    Predicate&& predicate,
+    std::uint32_t* indices)
+{
+    std::size_t size = 0;
+    detail::compactIndices(
+        count, 1,
+        [&] (std::size_t i, std::size_t) { return predicate(points[i]); },
+        &indices, &size);
+    return size;
+}
+
+template <class T, std::size_t N, class Predicate>
+std::size_t filterIndices(
+    const T* const (&source)[N],
+    std::size_t count,
+    Predicate&& predicate,
+    std::uint32_t* indices)
+{
+    std::size_t size = 0;
+    detail::compactIndices(
+        count, 1,
+        [&] (std::size_t i, std::size_t) {
+            return predicate(detail::gather(source, i));
+        },
+        &indices, &size);
+    return size;
+}
+
+// Copies of the points satisfying predicate(point), packed in input order;
+// out must hold count points. Returns the number of points written.
+template <class T, std::size_t N, class Predicate>
+std::size_t filter(
+    const Point<T, N>* points,
+    std::size_t count,
+    Predicate&& predicate,
+    Point<T, N>* out)
+{
+    std::size_t size = 0;
+    detail::compactBlocks(
+        count, 1,
+        [&] (std::size_t i, std::size_t) { return predicate(points[i]); },
+        [&] (std::size_t, std::size_t position, std::size_t i) {
+            out[position] = points[i];
+        },
+        [&] (std::size_t, std::size_t to, std::size_t from, std::size_t n) {
+            std::copy(out + from, out + from + n, out + to);
+        },
+        &size);
+    return size;
+}
+
+template <class T, std::size_t N, class Predicate>
+std::size_t filter(
+    const T* const (&source)[N],
+    std::size_t count,
+    Predicate&& predicate,
+    T* const (&target)[N])
+{
+    std::size_t size = 0;
+    detail::compactBlocks(
+        count, 1,
+        [&] (std::size_t i, std::size_t) {
+            return predicate(detail::gather(source, i));
+        },
+        [&] (std::size_t, std::size_t position, std::size_t i) {
+            for (std::size_t c = 0; c < N; c++) {
+                target[c][position] = source[c][i];
+            }
+        },
+        [&] (std::size_t, std::size_t to, std::size_t from, std::size_t n) {
+            for (std::size_t c = 0; c < N; c++) {
+                std::copy(target[c] + from, target[c] + from + n,
+                    target[c] + to);
+            }
+        },
+        &size);
+    return size;
+}
+
+// Stable partition into out: the points satisfying predicate(point) first,
+// then the others, each in input order. Returns the size of the first
+// group. Runs in two parallel passes over the input.
+template <class T, std::size_t N, class Predicate>
+std::size_t partitionCopy(
+    const Point<T, N>* points,
+    std::size_t count,
+    Predicate&& predicate,
+    Point<T, N>* out)
+{
+    return detail::partitionBlocks(
+        count,
+        [&] (std::size_t i) { return predicate(points[i]); },
+        [&] (std::size_t to, std::size_t from) { out[to] = points[from]; });
+}
+
+template <class T, std::size_t N, class Predicate>
+std::size_t partitionCopy(
+    const T* const (&source)[N],
+    std::size_t count,
+    Predicate&& predicate,
+    T* const (&target)[N])
+{
+    return detail::partitionBlocks(
+        count,
+        [&] (std::size_t i) { return predicate(detail::gather(source, i)); },
+        [&] (std::size_t to, std::size_t from) {
+            for (std::size_t c = 0; c < N; c++) {
+                target[c][to] = source[c][from];
+            }
+        });
+}
+
+} // namespace ecosnail::flat
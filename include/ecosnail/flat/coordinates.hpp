@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace ecosnail::flat::detail {
+
+// Storage for the components of an N-dimensional point or vector. The 2, 3
+// and 4-dimensional cases get named members, other dimensions use an array.
+
+template <class T, std::size_t N>
+struct Coordinates {
+    T& operator[](std::size_t idx)
+    {
+        assert(idx < N);
+        return coords[idx];
+    }
+
+    const T& operator[](std::size_t idx) const
+    {
+        assert(idx < N);
+        return coords[idx];
+    }
+
+    T coords[N];
+};
+
+template <class T>
+struct Coordinates<T, 2> {
+    T& operator[](std::size_t idx)
+    {
+        assert(idx < 2);
+        static T Coordinates::* const ptrs[] {&Coordinates::x, &Coordinates::y};
+        return this->*ptrs[idx];
+    }
+
+    const T& operator[](std::size_t idx) const
+    {
+        assert(idx < 2);
+        static T Coordinates::* const ptrs[] {&Coordinates::x, &Coordinates::y};
+        return this->*ptrs[idx];
+    }
+
+    T x;
+    T y;
+};
+
+// 3-dimensional arithmetic coordinates are aligned as if they had four
+// components, so that each of them fills a whole SIMD register. The padding
+// is part of the size: Point<float, 3> takes 16 bytes, not 12, and
+// Point<double, 3> takes 32, so arrays of 3D points use a third more memory
+// than packed xyz triples, and such triples cannot be reinterpreted as
+// points (see layout.hpp).
+template <class T>
+constexpr std::size_t coordinatesAlignment()
+{
+    return std::is_arithmetic_v<T> ? 4 * sizeof(T) : alignof(T);
+}
+
+template <class T>
+struct alignas(coordinatesAlignment<T>()) Coordinates<T, 3> {
+    T& operator[](std::size_t idx)
+    {
+        assert(idx < 3);
+        static T Coordinates::* const ptrs[] {
+            &Coordinates::x, &Coordinates::y, &Coordinates::z};
+        return this->*ptrs[idx];
+    }
+
+    const T& operator[](std::size_t idx) const
+    {
+        assert(idx < 3);
+        static T Coordinates::* const ptrs[] {
+            &Coordinates::x, &Coordinates::y, &Coordinates::z};
+        return this->*ptrs[idx];
+    }
+
+    T x;
+    T y;
+    T z;
+};
+
+template <class T>
+struct Coordinates<T, 4> {
+    T& operator[](std::size_t idx)
+    {
+        assert(idx < 4);
+        static T Coordinates::* const ptrs[] {
+            &Coordinates::x, &Coordinates::y, &Coordinates::z, &Coordinates::w};
+        return this->*ptrs[idx];
+    }
+
+    const T& operator[](std::size_t idx) const
+    {
+        assert(idx < 4);
+        static T Coordinates::* const ptrs[] {
+            &Coordinates::x, &Coordinates::y, &Coordinates::z, &Coordinates::w};
+        return this->*ptrs[idx];
+    }
+
+    T x;
+    T y;
+    T z;
+    T w;
+};
+
+// compile-time component access
+
+template <std::size_t I, class T, std::size_t N>
+constexpr T& component(Coordinates<T, N>& c)
+{
+    static_assert(I < N);
+    if constexpr (N > 4) {
+        return c.coords[I];
+    } else if constexpr (I == 0) {
+        return c.x;
+    } else if constexpr (I == 1) {
+        return c.y;
+    } else if constexpr (I == 2) {
+        return c.z;
+    } else {
+        return c.w;
+    }
+}
+
+template <std::size_t I, class T, std::size_t N>
+constexpr const T& component(const Coordinates<T, N>& c)
+{
+    return component<I>(const_cast<Coordinates<T, N>&>(c));
+}
+
+template <std::size_t I, class T, std::size_t N>
+constexpr T&& component(Coordinates<T, N>&& c)
+{
+    return std::move(component<I>(c));
+}
+
+// compile-time unrolling
+
+template <class F, std::size_t... I>
+constexpr void unroll(F&& f, std::index_sequence<I...>)
+{
+    (f(std::integral_constant<std::size_t, I>{}), ...);
+}
+
+template <std::size_t N, class F>
+constexpr void unroll(F&& f)
+{
+    unroll(std::forward<F>(f), std::make_index_sequence<N>{});
+}
+
+template <
+    template <class, std::size_t> class Result, class T, std::size_t N,
+    class F, std::size_t... I>
+constexpr Result<T, N> generate(F&& f, std::index_sequence<I...>)
+{
+    return Result<T, N>{T(f(std::integral_constant<std::size_t, I>{}))...};
+}
+
+template <
+    template <class, std::size_t> class Result, class T, std::size_t N,
+    class F>
+constexpr Result<T, N> generate(F&& f)
+{
+    return generate<Result, T, N>(
+        std::forward<F>(f), std::make_index_sequence<N>{});
+}
+
+template <class F, std::size_t... I>
+constexpr auto all(F&& f, std::index_sequence<I...>)
+{
+    return (f(std::integral_constant<std::size_t, I>{}) && ...);
+}
+
+template <std::size_t N, class F>
+constexpr auto all(F&& f)
+{
+    return all(std::forward<F>(f), std::make_index_sequence<N>{});
+}
+
+template <class F, std::size_t... I>
+constexpr auto sum(F&& f, std::index_sequence<I...>)
+{
+    return (f(std::integral_constant<std::size_t, I>{}) + ...);
+}
+
+template <std::size_t N, class F>
+constexpr auto sum(F&& f)
+{
+    return sum(std::forward<F>(f), std::make_index_sequence<N>{});
+}
+
+template <std::size_t N, class C>
+constexpr bool lexicographicalLess(const C& lhs, const C& rhs)
+{
+    bool less = false;
+    bool decided = false;
+    unroll<N>([&] (auto i) {
+        if (!decided) {
+            const auto& l = component<i>(lhs);
+            const auto& r = component<i>(rhs);
+            if (l < r) {
+                less = decided = true;
+            } else if (r < l) {
+                decided = true;
+            }
+        }
+    });
+    return less;
+}
+
+// SIMD packets (such as std::experimental::simd) used as coordinates: their
+// comparisons produce masks instead of bool, so branches become blends.
+
+template <class T, class = void>
+struct IsPacket : std::false_type { };
+
+template <class T>
+struct IsPacket<
+        T, std::void_t<typename T::mask_type, decltype(T::size())>>
+    : std::true_type { };
+
+template <class T>
+constexpr bool isPacket = IsPacket<T>::value;
+
+template <class Mask, class T>
+T select(const Mask& mask, const T& ifTrue, const T& ifFalse)
+{
+    if constexpr (isPacket<T>) {
+        auto result = ifFalse;
+        where(mask, result) = ifTrue;
+        return result;
+    } else {
+        return mask ? ifTrue : ifFalse;
+    }
+}
+
+template <class T, class... Us>
+constexpr bool allConvertible =
+    (std::is_convertible_v<Us, T> && ...);
+
+} // namespace ecosnail::flat::detail
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <ecosnail/flat/compaction.hpp>
+#include <ecosnail/flat/enclosing.hpp>
+#include <ecosnail/flat/point.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// Culling of points and circles against axis-aligned rectangles, e.g.
+// viewports. Visible items are written as compacted lists of indices, in
+// input order.
+
+namespace ecosnail::flat {
+
+template <class T>
+struct Rectangle {
+    Point<T> min;
+    Point<T> max;
+};
+
+template <class T>
+bool contains(const Rectangle<T>& rectangle, const Point<T>& point)
+{
+    // non-short-circuit operators keep the test free of branches
+    return (point.x >= rectangle.min.x) & (point.x <= rectangle.max.x) &
+        (point.y >= rectangle.min.y) & (point.y <= rectangle.max.y);
+}
+
+template <class T>
+bool intersects(const Rectangle<T>& rectangle, const Circle<T>& circle)
+{
+    // distance from the center to the rectangle along each axis
+    const T dx = std::max(
+        std::max(rectangle.min.x - circle.center.x, T(0)),
+        circle.center.x - rectangle.max.x);
+    const T dy = std::max(
+        std::max(rectangle.min.y - circle.center.y, T(0)),
+        circle.center.y - rectangle.max.y);
+    return dx * dx + dy * dy <= circle.radius * circle.radius;
+}
+
+// Indices of the points inside the viewport; indices must hold count
+// elements. Returns the number of visible points.
+template <class T>
+std::size_t cull(
+    const Point<T>* points,
+    std::size_t count,
+    const Rectangle<T>& viewport,
+    std::uint32_t* indices)
+{
+    std::size_t size = 0;
+    detail::compactIndices(
+        count, 1,
+        [&] (std::size_t i, std::size_t) {
+            return contains(viewport, points[i]);
+        },
+        &indices, &size);
+    return size;
+}
+
+template <class T>
+std::size_t cull(
+    const Circle<T>* circles,
+    std::size_t count,
+    const Rectangle<T>& viewport,
+    std::uint32_t* indices)
+{
+    std::size_t size = 0;
+    detail::compactIndices(
+        count, 1,
+        [&] (std::size_t i, std::size_t) {
+            return intersects(viewport, circles[i]);
+        },
+        &indices, &size);
+    return size;
+}
+
+// Culling against several viewports in one pass over the input: indices[v]
+// receives the items visible in viewports[v], and must hold count elements;
+// sizes[v] receives their number.
+template <class T>
+void cull(
+    const Point<T>* points,
+    std::size_t count,
+    const Rectangle<T>* viewports,
+    std::size_t viewportCount,
+    std::uint32_t* const* indices,
+    std::size_t* sizes)
+{
+    detail::compactIndices(
+        count, viewportCount,
+        [&] (std::size_t i, std::size_t v) {
+            return contains(viewports[v], points[i]);
+        },
+        indices, sizes);
+}
+
+template <class T>
+void cull(
+    const Circle<T>* circles,
+    std::size_t count,
+    const Rectangle<T>* viewports,
+    std::size_t viewportCount,
+    std::uint32_t* const* indices,
+    std::size_t* sizes)
+{
+    detail::compactIndices(
+        count, viewportCount,
+        [&] (std::size_t i, std::size_t v) {
+            return intersects(viewports[v], circles[i]);
+        },
+        indices, sizes);
+}
+
+} // namespace ecosnail::flat
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <ecosnail/flat/point.hpp>
+#include <ecosnail/flat/vector.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace ecosnail::flat {
+
+template <class T>
+struct QuadraticBezier {
+    Point<T> operator()(T t) const
+    {
+        const T s = 1 - t;
+        return {
+            s * s * p0.x + 2 * s * t * p1.x + t * t * p2.x,
+            s * s * p0.y + 2 * s * t * p1.y + t * t * p2.y};
+    }
+
+    Vector<T> derivative(T t) const
+    {
+        return 2 * (1 - t) * (p1 - p0) + 2 * t * (p2 - p1);
+    }
+
+    Point<T> p0;
+    Point<T> p1;
+    Point<T> p2;
+};
+
+template <class T>
+struct CubicBezier {
+    Point<T> operator()(T t) const
+    {
+        const T s = 1 - t;
+        const T b0 = s * s * s;
+        const T b1 = 3 * s * s * t;
+        const T b2 = 3 * s * t * t;
+        const T b3 = t * t * t;
+        return {
+            b0 * p0.x + b1 * p1.x + b2 * p2.x + b3 * p3.x,
+            b0 * p0.y + b1 * p1.y + b2 * p2.y + b3 * p3.y};
+    }
+
+    Vector<T> derivative(T t) const
+    {
+        const T s = 1 - t;
+        return 3 * s * s * (p1 - p0) + 6 * s * t * (p2 - p1) +
+            3 * t * t * (p3 - p2);
+    }
+
+    Point<T> p0;
+    Point<T> p1;
+    Point<T> p2;
+    Point<T> p3;
+};
+
+// Segment of a uniform Catmull-Rom spline, running from p1 to p2.
+template <class T>
+CubicBezier<T> catmullRomSegment(
+    const Point<T>& p0,
+    const Point<T>& p1,
+    const Point<T>& p2,
+    const Point<T>& p3)
+{
+    return {p1, p1 + (p2 - p0) / T{6}, p2 - (p3 - p1) / T{6}, p2};
+}
+
+// Segment of a uniform cubic B-spline with control points p0..p3.
+template <class T>
+CubicBezier<T> bSplineSegment(
+    const Point<T>& p0,
+    const Point<T>& p1,
+    const Point<T>& p2,
+    const Point<T>& p3)
+{
+    const auto third = (p2 - p1) / T{3};
+    return {
+        p1 + (p0 - p1) / T{6} + (p2 - p1) / T{6},
+        p1 + third,
+        p2 - third,
+        p2 + (p1 - p2) / T{6} + (p3 - p2) / T{6}};
+}
+
+// Upper bound of segmentCount(), reached when the tolerance is tiny
+// compared to the curve or a control point is infinite; NaN control points
+// give a single segment
+inline constexpr std::size_t maxSegmentCount = std::size_t{1} << 20;
+
+namespace detail {
+
+template <class T>
+std::size_t segmentCount(T secondDifference, T tolerance)
+{
+    if (!(tolerance > 0)) {
+        throw std::invalid_argument("flattening tolerance must be positive");
+    }
+    using std::ceil;
+    using std::sqrt;
+    const T n = ceil(sqrt(secondDifference / tolerance));
+    if (!(n >= 1)) {
+        // also NaN
+        return 1;
+    }
+    if (!(n < static_cast<T>(maxSegmentCount))) {
+        return maxSegmentCount;
+    }
+    return static_cast<std::size_t>(n);
+}
+
+} // namespace detail
+
+// Number of equal parameter steps after which a polyline stays within
+// `tolerance` of the curve (Wang's formula), at most maxSegmentCount.
+// Throws std::invalid_argument unless tolerance > 0.
+template <class T>
+std::size_t segmentCount(const QuadraticBezier<T>& curve, T tolerance)
+{
+    const T m = length((curve.p2 - curve.p1) - (curve.p1 - curve.p0));
+    return detail::segmentCount(m / 4, tolerance);
+}
+
+template <class T>
+std::size_t segmentCount(const CubicBezier<T>& curve, T tolerance)
+{
+    const T m = std::max(
+        length((curve.p2 - curve.p1) - (curve.p1 - curve.p0)),
+        length((curve.p3 - curve.p2) - (curve.p2 - curve.p1)));
+    return detail::segmentCount(3 * m / 4, tolerance);
+}
+
+// Appends a polyline within `tolerance` of the curve to `out`, without the
+// start point, so that consecutive curves chain without duplicates. Points
+// are generated by forward differencing: a few additions per point.
+template <class T>
+void flatten(
+    const QuadraticBezier<T>& curve, T tolerance, std::vector<Point<T>>& out)
+{
+    const std::size_t n = segmentCount(curve, tolerance);
+    const T h = T{1} / n;
+
+    // p(t) = a t^2 + b t + p0
+    const auto a = (curve.p2 - curve.p1) - (curve.p1 - curve.p0);
+    const auto b = 2 * (curve.p1 - curve.p0);
+    auto point = curve.p0;
+    auto d1 = a * (h * h) + b * h;
+    const auto d2 = a * (2 * h * h);
+
+    for (std::size_t i = 1; i < n; i++) {
+        point += d1;
+        d1 += d2;
+        out.push_back(point);
+    }
+    out.push_back(curve.p2);
+}
+
+template <class T>
+void flatten(
+    const CubicBezier<T>& curve, T tolerance, std::vector<Point<T>>& out)
+{
+    const std::size_t n = segmentCount(curve, tolerance);
+    const T h = T{1} / n;
+
+    // p(t) = a t^3 + b t^2 + c t + p0
+    const auto c = 3 * (curve.p1 - curve.p0);
+    const auto b = 3 * ((curve.p2 - curve.p1) - (curve.p1 - curve.p0));
+    const auto a = (curve.p3 - curve.p0) - 3 * (curve.p2 - curve.p1);
+    auto point = curve.p0;
+    auto d1 = a * (h * h * h) + b * (h * h) + c * h;
+    auto d2 = a * (6 * h * h * h) + b * (2 * h * h);
+    const auto d3 = a * (6 * h * h * h);
+
+    for (std::size_t i = 1; i < n; i++) {
+        point += d1;
+        d1 += d2;
+        d2 += d3;
+        out.push_back(point);
+    }
+    out.push_back(curve.p3);
+}
+
+// Flattens the Catmull-Rom spline through `count` points, duplicating the
+// end points to get tangents there.
+template <class T>
+std::vector<Point<T>> flattenCatmullRom(
+    const Point<T>* points, std::size_t count, T tolerance)
+{
+    std::vector<Point<T>> out;
+    if (count == 0) {
+        return out;
+    }
+    out.push_back(points[0]);
+    for (std::size_t i = 0; i + 1 < count; i++) {
+        const auto& p0 = points[i == 0 ? 0 : i - 1];
+        const auto& p3 = points[i + 2 < count ? i + 2 : count - 1];
+        flatten(
+            catmullRomSegment(p0, points[i], points[i + 1], p3),
+            tolerance,
+            out);
+    }
+    return out;
+}
+
+// Table mapping arc length to curve parameter, built from `samples` equal
+// parameter steps.
+template <class T>
+class ArcLengthTable {
+public:
+    template <class Curve>
+    ArcLengthTable(const Curve& curve, std::size_t samples = 64)
+        : _lengths(samples + 1)
+    {
+        assert(samples > 0);
+        auto previous = curve(T{0});
+        _lengths[0] = 0;
+        for (std::size_t i = 1; i <= samples; i++) {
+            const auto point = curve(static_cast<T>(i) / samples);
+            _lengths[i] = _lengths[i - 1] + flat::length(point - previous);
+            previous = point;
+        }
+    }
+
+    T length() const
+    {
+        return _lengths.back();
+    }
+
+    // Parameter at which the arc length from the start reaches `distance`,
+    // interpolated linearly between samples.
+    T parameter(T distance) const
+    {
+        if (distance <= 0) {
+            return 0;
+        }
+        if (distance >= length()) {
+            return 1;
+        }
+        const auto it =
+            std::upper_bound(_lengths.begin(), _lengths.end(), distance);
+        const auto i = static_cast<std::size_t>(it - _lengths.begin()) - 1;
+        const T fraction =
+            (distance - _lengths[i]) / (_lengths[i + 1] - _lengths[i]);
+        return (i + fraction) / (_lengths.size() - 1);
+    }
+
+private:
+    std::vector<T> _lengths;
+};
+
+namespace batch {
+
+// Evaluates the curve at `count` parameters. The per-parameter work is
+// branch-free, so the loop vectorizes.
+template <class Curve, class T>
+void evaluate(const Curve& curve, const T* ts, std::size_t count, Point<T>* out)
+{
+    for (std::size_t i = 0; i < count; i++) {
+        out[i] = curve(ts[i]);
+    }
+}
+
+} // namespace batch
+
+} // namespace ecosnail::flat
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <ecosnail/flat/point.hpp>
+#include <ecosnail/flat/vector.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+// Batch kernels compiled for several instruction sets, selected at run time.
+// Only available when linking the ecosnail-flat-dispatch library.
+
+namespace ecosnail::flat::dispatch {
+
+enum class Target {
+    Generic,
+    Avx2,
+    Avx512,
+};
+
+// The best target supported by the running CPU. Kernels are resolved to it
+// on the first call, so they may be used during static initialization.
+Target bestTarget();
+
+bool isSupported(Target target);
+
+// Override the resolved kernels, e.g. to test each path; safe to call while
+// other threads run kernels. Throws std::invalid_argument if the running CPU
+// does not support the target.
+void setTarget(Target target);
+
+Target currentTarget();
+
+const char* name(Target target);
+
+void length(const Vector<float>* vectors, std::size_t count, float* out);
+void length(const Vector<double>* vectors, std::size_t count, double* out);
+
+void normalize(Vector<float>* vectors, std::size_t count);
+void normalize(Vector<double>* vectors, std::size_t count);
+
+void distance(
+    const Point<float>* lhs,
+    const Point<float>* rhs,
+    std::size_t count,
+    float* out);
+void distance(
+    const Point<double>* lhs,
+    const Point<double>* rhs,
+    std::size_t count,
+    double* out);
+
+// Stream compaction: the elements whose flags are nonzero, packed in input
+// order. Outputs must hold count elements; whole vectors are stored past
+// the returned size. compactIndices() writes the indices of the elements.
+std::size_t compactIndices(
+    const std::uint8_t* flags, std::size_t count, std::uint32_t* indices);
+
+std::size_t compact(
+    const float* values,
+    const std::uint8_t* flags,
+    std::size_t count,
+    float* out);
+std::size_t compact(
+    const double* values,
+    const std::uint8_t* flags,
+    std::size_t count,
+    double* out);
+std::size_t compact(
+    const Point<float>* points,
+    const std::uint8_t* flags,
+    std::size_t count,
+    Point<float>* out);
+std::size_t compact(
+    const Point<double>* points,
+    const std::uint8_t* flags,
+    std::size_t count,
+    Point<double>* out);
+
+} // namespace ecosnail::flat::dispatch
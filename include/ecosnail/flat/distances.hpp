@@ -0,0 +1,194 @@
+#pragma once
+
+#include <ecosnail/flat/coordinates.hpp>
+#include <ecosnail/flat/parallel.hpp>
+#include <ecosnail/flat/point.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Distances between every point of one array and every point of another.
+//
+// The second array is transposed into per-component arrays once, and the
+// matrix is computed in tiles of rows x columns small enough for a column
+// tile to stay in cache while all rows of a row tile go over it. Tiles run
+// in parallel. Differences are taken per component rather than through
+// |a|^2 + |b|^2 - 2ab: for low dimensions this costs the same number of
+// multiply-adds and avoids cancellation for nearby points.
+
+namespace ecosnail::flat {
+
+namespace detail {
+
+constexpr std::size_t distanceRowTile = 64;
+constexpr std::size_t distanceColumnTile = 1024;
+
+template <class T, std::size_t N>
+struct TransposedPoints {
+    TransposedPoints(const Point<T, N>* points, std::size_t count)
+    {
+        unroll<N>([&] (auto c) {
+            components[c].resize(count);
+            for (std::size_t i = 0; i < count; i++) {
+                components[c][i] = get<c>(points[i]);
+            }
+        });
+    }
+
+    std::array<std::vector<T>, N> components;
+};
+
+// Squared distances from `point` to columns [begin, end), written to
+// out[0, end - begin).
+template <class T, std::size_t N>
+void squaredDistanceRow(
+    const Point<T, N>& point,
+    const TransposedPoints<T, N>& columns,
+    std::size_t begin,
+    std::size_t end,
+    T* out)
+{
+    std::fill(out, out + (end - begin), T{});
+    unroll<N>([&] (auto c) {
+        const T coordinate = get<c>(point);
+        const T* column = columns.components[c].data() + begin;
+        for (std::size_t j = 0; j < end - begin; j++) {
+            const T d = column[j] - coordinate;
+            out[j] += d * d;
+        }
+    });
+}
+
+template <class T, std::size_t N, class F>
+void forEachDistanceTile(
+    const Point<T, N>* from,
+    std::size_t fromCount,
+    const Point<T, N>* to,
+    std::size_t toCount,
+    F&& tile)
+{
+    const TransposedPoints<T, N> columns(to, toCount);
+    const std::size_t rowTiles =
+        (fromCount + distanceRowTile - 1) / distanceRowTile;
+    parallelFor(rowTiles, [&] (std::size_t firstTile, std::size_t lastTile) {
+        const std::size_t rowBegin = firstTile * distanceRowTile;
+        const std::size_t rowEnd =
+            std::min(fromCount, lastTile * distanceRowTile);
+        for (std::size_t columnBegin = 0; columnBegin < toCount;
+                columnBegin += distanceColumnTile) {
+            const std::size_t columnEnd =
+                std::min(toCount, columnBegin + distanceColumnTile);
+            for (std::size_t i = rowBegin; i < rowEnd; i++) {
+                tile(i, columnBegin, columnEnd, from[i], columns);
+            }
+        }
+    }, 1);
+}
+
+} // namespace detail
+
+namespace batch {
+
+// Row-major fromCount x toCount matrix of squared distances.
+template <class T, std::size_t N>
+void squaredDistanceMatrix(
+    const Point<T, N>* from,
+    std::size_t fromCount,
+    const Point<T, N>* to,
+    std::size_t toCount,
+    T* out)
+{
+    detail::forEachDistanceTile(from, fromCount, to, toCount,
+        [&] (std::size_t row, std::size_t begin, std::size_t end,
+                const Point<T, N>& point, const auto& columns) {
+            detail::squaredDistanceRow(
+                point, columns, begin, end, out + row * toCount + begin);
+        });
+}
+
+// Row-major fromCount x toCount matrix of distances.
+template <class T, std::size_t N>
+void distanceMatrix(
+    const Point<T, N>* from,
+    std::size_t fromCount,
+    const Point<T, N>* to,
+    std::size_t toCount,
+    T* out)
+{
+    detail::forEachDistanceTile(from, fromCount, to, toCount,
+        [&] (std::size_t row, std::size_t begin, std::size_t end,
+                const Point<T, N>& point, const auto& columns) {
+            T* rowOut = out + row * toCount + begin;
+            detail::squaredDistanceRow(point, columns, begin, end, rowOut);
+            using std::sqrt;
+            for (std::size_t j = 0; j < end - begin; j++) {
+                rowOut[j] = sqrt(rowOut[j]);
+            }
+        });
+}
+
+// The k nearest points of `to` for each point of `from`, without
+// materializing the whole matrix. k is clamped to toCount, and the clamped
+// value is returned; row i of the fromCount x k outputs holds indices into
+// `to` and distances, nearest first.
+template <class T, std::size_t N>
+std::size_t nearest(
+    const Point<T, N>* from,
+    std::size_t fromCount,
+    const Point<T, N>* to,
+    std::size_t toCount,
+    std::size_t k,
+    std::size_t* indices,
+    T* distances)
+{
+    k = std::min(k, toCount);
+    if (k == 0) {
+        return 0;
+    }
+
+    // per row max-heap of (squared distance, index), kept across tiles
+    std::vector<std::pair<T, std::size_t>> heaps(fromCount * k);
+    std::vector<std::size_t> heapSizes(fromCount, 0);
+
+    detail::forEachDistanceTile(from, fromCount, to, toCount,
+        [&] (std::size_t row, std::size_t begin, std::size_t end,
+                const Point<T, N>& point, const auto& columns) {
+            thread_local std::vector<T> buffer;
+            buffer.resize(detail::distanceColumnTile);
+            detail::squaredDistanceRow(
+                point, columns, begin, end, buffer.data());
+
+            auto heap = heaps.begin() + row * k;
+            auto& size = heapSizes[row];
+            for (std::size_t j = begin; j < end; j++) {
+                const T d = buffer[j - begin];
+                if (size < k) {
+                    heap[size++] = {d, j};
+                    std::push_heap(heap, heap + size);
+                } else if (d < heap->first) {
+                    std::pop_heap(heap, heap + k);
+                    heap[k - 1] = {d, j};
+                    std::push_heap(heap, heap + k);
+                }
+            }
+        });
+
+    using std::sqrt;
+    for (std::size_t row = 0; row < fromCount; row++) {
+        auto heap = heaps.begin() + row * k;
+        std::sort_heap(heap, heap + k);
+        for (std::size_t j = 0; j < k; j++) {
+            indices[row * k + j] = heap[j].second;
+            distances[row * k + j] = sqrt(heap[j].first);
+        }
+    }
+    return k;
+}
+
+} // namespace batch
+
+} // namespace ecosnail::flat
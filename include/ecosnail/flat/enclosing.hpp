@@ -0,0 +1,398 @@
+#pragma once
+
+#include <ecosnail/flat/parallel.hpp>
+#include <ecosnail/flat/point.hpp>
+#include <ecosnail/flat/vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+// Enclosing shapes and extents of point sets: convex hull, minimum enclosing
+// circle, and rotating-calipers diameter, width and minimum-area rectangle.
+// None of these allocate; the hull is built in a caller-provided buffer.
+
+namespace ecosnail::flat {
+
+template <class T>
+struct Circle {
+    Point<T> center;
+    T radius = 0;
+};
+
+// Rectangle with sides along axis and its perpendicular; axis is a unit
+// vector.
+template <class T>
+struct OrientedRectangle {
+    Point<T> center;
+    Vector<T> axis;
+    T halfLength = 0;
+    T halfWidth = 0;
+};
+
+namespace detail {
+
+template <class T>
+T orientation(const Point<T>& a, const Point<T>& b, const Point<T>& c)
+{
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+template <class T>
+struct SquaredCircle {
+    Point<T> center;
+    T squaredRadius;
+
+    bool contains(const Point<T>& point) const
+    {
+        constexpr T slack = 1 + 64 * std::numeric_limits<T>::epsilon();
+        return squaredLength(point - center) <= squaredRadius * slack;
+    }
+};
+
+template <class T>
+SquaredCircle<T> circleOf(const Point<T>& a, const Point<T>& b)
+{
+    const auto center = a + (b - a) / T(2);
+    return {center, squaredLength(a - center)};
+}
+
+// Circumcircle; for collinear points, the circle over the farthest pair
+template <class T>
+SquaredCircle<T> circleOf(
+    const Point<T>& a, const Point<T>& b, const Point<T>& c)
+{
+    const auto ab = b - a;
+    const auto ac = c - a;
+    const T d = 2 * (ab.x * ac.y - ab.y * ac.x);
+    if (d == 0) {
+        const T lab = squaredLength(ab);
+        const T lac = squaredLength(ac);
+        const T lbc = squaredLength(c - b);
+        if (lab >= lac && lab >= lbc) {
+            return circleOf(a, b);
+        }
+        return lac >= lbc ? circleOf(a, c) : circleOf(b, c);
+    }
+    const T lab = squaredLength(ab);
+    const T lac = squaredLength(ac);
+    const Vector<T> offset {
+        (ac.y * lab - ab.y * lac) / d,
+        (ab.x * lac - ac.x * lab) / d};
+    return {a + offset, squaredLength(offset)};
+}
+
+} // namespace detail
+
+// Convex hull of points (Andrew's monotone chain), written counterclockwise
+// to hull without collinear vertices. The hull buffer must hold count
+// points, and is used as scratch space. Returns the number of hull points.
+template <class T>
+std::size_t convexHull(
+    const Point<T>* points, std::size_t count, Point<T>* hull)
+{
+    if (count == 0) {
+        return 0;
+    }
+    std::copy(points, points + count, hull);
+    std::sort(hull, hull + count, std::less<Point<T>>{});
+    const auto first = hull[0];
+    const auto last = hull[count - 1];
+    if (first == last) {
+        return 1;
+    }
+
+    // Lay out the lower chain left to right, then the upper chain right to
+    // left, so that both chains are scanned in one pass over the buffer and
+    // the hull can overwrite it in place.
+    const auto middle = std::partition(
+        hull + 1, hull + count - 1,
+        [&] (const Point<T>& p) {
+            return detail::orientation(first, last, p) < 0;
+        });
+    std::rotate(middle, hull + count - 1, hull + count);
+    std::sort(hull + 1, middle, std::less<Point<T>>{});
+    std::sort(middle + 1, hull + count, std::greater<Point<T>>{});
+
+    const auto upperBegin = static_cast<std::size_t>(middle - hull) + 1;
+    std::size_t size = 0;
+    auto scan = [&] (std::size_t i, std::size_t floor) {
+        const auto point = hull[i];
+        while (size >= floor && detail::orientation(
+                hull[size - 2], hull[size - 1], point) <= 0) {
+            size--;
+        }
+        hull[size++] = point;
+    };
+    for (std::size_t i = 0; i < upperBegin; i++) {
+        scan(i, 2);
+    }
+    const std::size_t lowerSize = size;
+    for (std::size_t i = upperBegin; i < count; i++) {
+        scan(i, lowerSize + 1);
+    }
+    while (size >= lowerSize + 1 && detail::orientation(
+            hull[size - 2], hull[size - 1], first) <= 0) {
+        size--;
+    }
+    return size;
+}
+
+namespace detail {
+
+// Pseudo-random permutation of [0, 2^bits): odd multiplications and
+// xor-shifts are both invertible modulo 2^bits.
+class IndexPermutation {
+public:
+    explicit IndexPermutation(std::size_t count)
+    {
+        while (count > (std::uint64_t{1} << _bits)) {
+            _bits++;
+        }
+        _mask = (std::uint64_t{1} << _bits) - 1;
+    }
+
+    std::uint64_t domain() const
+    {
+        return _mask + 1;
+    }
+
+    std::uint64_t operator()(std::uint64_t i) const
+    {
+        const unsigned shift = _bits / 2 + 1;
+        i = (i * 0x9e3779b97f4a7c15) & _mask;
+        i ^= i >> shift;
+        i = (i * 0xbf58476d1ce4e5b9) & _mask;
+        i ^= i >> shift;
+        return i;
+    }
+
+private:
+    unsigned _bits = 0;
+    std::uint64_t _mask = 0;
+};
+
+} // namespace detail
+
+// Smallest circle containing all points, by Welzl's algorithm in its
+// iterative form; expected linear time for points in random order. Instead
+// of shuffling a copy of the input, points are visited in the order of a
+// bijective hash, skipping hashes past the end.
+template <class T>
+Circle<T> minimumEnclosingCircle(const Point<T>* points, std::size_t count)
+{
+    static_assert(std::is_floating_point_v<T>);
+
+    if (count == 0) {
+        return {};
+    }
+
+    const detail::IndexPermutation permutation(count);
+    detail::SquaredCircle<T> circle {points[permutation(0)], 0};
+    for (std::uint64_t i = 0; i < permutation.domain(); i++) {
+        const auto pi = permutation(i);
+        if (pi >= count || circle.contains(points[pi])) {
+            continue;
+        }
+        const auto& p = points[pi];
+        circle = {p, 0};
+        for (std::uint64_t j = 0; j < i; j++) {
+            const auto qi = permutation(j);
+            if (qi >= count || circle.contains(points[qi])) {
+                continue;
+            }
+            const auto& q = points[qi];
+            circle = detail::circleOf(p, q);
+            for (std::uint64_t k = 0; k < j; k++) {
+                const auto ri = permutation(k);
+                if (ri < count && !circle.contains(points[ri])) {
+                    circle = detail::circleOf(p, q, points[ri]);
+                }
+            }
+        }
+    }
+
+    using std::sqrt;
+    return {circle.center, sqrt(circle.squaredRadius)};
+}
+
+// The calipers functions below take a convex polygon in counterclockwise
+// order without collinear vertices, as produced by convexHull().
+
+// Largest distance between two points
+template <class T>
+T diameter(const Point<T>* hull, std::size_t size)
+{
+    using std::sqrt;
+
+    if (size < 2) {
+        return 0;
+    }
+    if (size == 2) {
+        return length(hull[1] - hull[0]);
+    }
+
+    T best = 0;
+    std::size_t j = 1;
+    for (std::size_t i = 0; i < size; i++) {
+        const auto& a = hull[i];
+        const auto& b = hull[(i + 1) % size];
+        while (detail::orientation(a, b, hull[(j + 1) % size]) >
+                detail::orientation(a, b, hull[j])) {
+            j = (j + 1) % size;
+        }
+        best = std::max({
+            best,
+            squaredLength(hull[j] - a),
+            squaredLength(hull[j] - b)});
+    }
+    return sqrt(best);
+}
+
+// Smallest distance between two parallel lines enclosing the points
+template <class T>
+T width(const Point<T>* hull, std::size_t size)
+{
+    if (size < 3) {
+        return 0;
+    }
+
+    T best = std::numeric_limits<T>::infinity();
+    std::size_t j = 1;
+    for (std::size_t i = 0; i < size; i++) {
+        const auto& a = hull[i];
+        const auto& b = hull[(i + 1) % size];
+        while (detail::orientation(a, b, hull[(j + 1) % size]) >
+                detail::orientation(a, b, hull[j])) {
+            j = (j + 1) % size;
+        }
+        best = std::min(
+            best, detail::orientation(a, b, hull[j]) / length(b - a));
+    }
+    return best;
+}
+
+// Minimum-area enclosing rectangle. One of its sides lies on a hull edge,
+// so each edge is tried, with the extreme points along and across it
+// tracked by three calipers rotating together.
+template <class T>
+OrientedRectangle<T> minimumAreaRectangle(
+    const Point<T>* hull, std::size_t size)
+{
+    if (size == 0) {
+        return {};
+    }
+    if (size == 1) {
+        return {hull[0], Vector<T>{1, 0}, 0, 0};
+    }
+    if (size == 2) {
+        const auto side = hull[1] - hull[0];
+        const T sideLength = length(side);
+        return {hull[0] + side / T(2), side / sideLength, sideLength / 2, 0};
+    }
+
+    auto next = [size] (std::size_t i) { return (i + 1) % size; };
+
+    OrientedRectangle<T> best;
+    T bestArea = std::numeric_limits<T>::infinity();
+    std::size_t right = 1;
+    std::size_t top = 1;
+    std::size_t left = 1;
+    for (std::size_t i = 0; i < size; i++) {
+        const auto& origin = hull[i];
+        const auto axis = normalized(hull[next(i)] - origin);
+        const Vector<T> normal {-axis.y, axis.x};
+
+        if (i == 0) {
+            right = next(i);
+        }
+        while (dot(hull[next(right)] - hull[right], axis) > 0) {
+            right = next(right);
+        }
+        if (i == 0) {
+            top = right;
+        }
+        while (dot(hull[next(top)] - hull[top], normal) > 0) {
+            top = next(top);
+        }
+        if (i == 0) {
+            left = top;
+        }
+        while (dot(hull[next(left)] - hull[left], axis) < 0) {
+            left = next(left);
+        }
+
+        const T maxAlong = dot(hull[right] - origin, axis);
+        const T minAlong = dot(hull[left] - origin, axis);
+        const T height = dot(hull[top] - origin, normal);
+        const T area = (maxAlong - minAlong) * height;
+        if (area < bestArea) {
+            bestArea = area;
+            best.center = origin + axis * ((maxAlong + minAlong) / 2) +
+                normal * (height / 2);
+            best.axis = axis;
+            best.halfLength = (maxAlong - minAlong) / 2;
+            best.halfWidth = height / 2;
+        }
+    }
+    return best;
+}
+
+template <class T>
+struct HullMetrics {
+    T diameter = 0;
+    T width = 0;
+    OrientedRectangle<T> rectangle;
+};
+
+namespace batch {
+
+// Many clusters stored back to back: cluster i is points
+// [clusterOffsets[i], clusterOffsets[i + 1]). Clusters are processed in
+// parallel; scratch must hold as many points as the clusters together.
+
+template <class T>
+void minimumEnclosingCircle(
+    const Point<T>* points,
+    const std::size_t* clusterOffsets,
+    std::size_t clusterCount,
+    Circle<T>* circles)
+{
+    parallelFor(clusterCount, [&] (std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            circles[i] = flat::minimumEnclosingCircle(
+                points + clusterOffsets[i],
+                clusterOffsets[i + 1] - clusterOffsets[i]);
+        }
+    }, 256);
+}
+
+template <class T>
+void hullMetrics(
+    const Point<T>* points,
+    const std::size_t* clusterOffsets,
+    std::size_t clusterCount,
+    Point<T>* scratch,
+    HullMetrics<T>* metrics)
+{
+    parallelFor(clusterCount, [&] (std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            auto* hull = scratch + clusterOffsets[i];
+            const auto size = convexHull(
+                points + clusterOffsets[i],
+                clusterOffsets[i + 1] - clusterOffsets[i],
+                hull);
+            metrics[i].diameter = flat::diameter(hull, size);
+            metrics[i].width = flat::width(hull, size);
+            metrics[i].rectangle = flat::minimumAreaRectangle(hull, size);
+        }
+    }, 256);
+}
+
+} // namespace batch
+
+} // namespace ecosnail::flat
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Branch-free approximations of elementary functions, for batch kernels.
+// Unlike the <cmath> functions these are plain inline arithmetic, so loops
+// calling them can be vectorized by the compiler. Relative error is within
+// a few ulp (below 1e-15) over the stated domains.
+//
+// Selections go through blend() rather than the conditional operator: with
+// the default -ftrapping-math, GCC moves arithmetic used by only one side of
+// a conditional into a branch, and then cannot vectorize the loop.
+
+namespace ecosnail::flat::detail {
+
+constexpr double pi = 3.14159265358979323846;
+
+inline std::int64_t toBits(double x)
+{
+    std::int64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+inline double fromBits(std::int64_t bits)
+{
+    double x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+// Bitwise selection between two values.
+inline double blend(bool condition, double ifTrue, double ifFalse)
+{
+    const std::int64_t mask = -static_cast<std::int64_t>(condition);
+    return fromBits((toBits(ifTrue) & mask) | (toBits(ifFalse) & ~mask));
+}
+
+// Adding this to a double with |x| < 2^51 rounds it to an integer, which
+// then sits in the low bits of the representation. Conversions between
+// int64 and double done this way vectorize without AVX-512.
+constexpr double roundingMagic = 6755399441055744.0; // 1.5 * 2^52
+
+inline double roundNearest(double x)
+{
+    return (x + roundingMagic) - roundingMagic;
+}
+
+// For an integral |x| < 2^51.
+inline std::int64_t toInteger(double x)
+{
+    return toBits(x + roundingMagic) - toBits(roundingMagic);
+}
+
+// For 0 <= i < 2^52.
+inline double fromInteger(std::int64_t i)
+{
+    constexpr double twoPow52 = 4503599627370496.0;
+    return fromBits(i | toBits(twoPow52)) - twoPow52;
+}
+
+inline double sinPolynomial(double r)
+{
+    const double r2 = r * r;
+    return r + r * r2 * (-1.0 / 6 + r2 * (1.0 / 120 + r2 * (-1.0 / 5040 +
+        r2 * (1.0 / 362880 + r2 * (-1.0 / 39916800 + r2 * (1.0 / 6227020800 +
+        r2 * (-1.0 / 1307674368000 + r2 * (1.0 / 355687428096000))))))));
+}
+
+inline double cosPolynomial(double r)
+{
+    const double r2 = r * r;
+    return 1 + r2 * (-1.0 / 2 + r2 * (1.0 / 24 + r2 * (-1.0 / 720 +
+        r2 * (1.0 / 40320 + r2 * (-1.0 / 3628800 + r2 * (1.0 / 479001600 +
+        r2 * (-1.0 / 87178291200 + r2 * (1.0 / 20922789888000 +
+        r2 * (-1.0 / 6402373705728000)))))))));
+}
+
+// Sine and cosine, for |x| < 1e5.
+inline void fastSinCos(double x, double& sin, double& cos)
+{
+    // Cody-Waite reduction to [-pi/4, pi/4] with pi/2 split in three parts
+    constexpr double pio2a = 1.57079632673412561417e+00;
+    constexpr double pio2b = 6.07710050630396597660e-11;
+    constexpr double pio2c = 2.02226624879595063154e-21;
+
+    const double q = roundNearest(x * (2 / pi));
+    const double r = ((x - q * pio2a) - q * pio2b) - q * pio2c;
+    const std::int64_t quadrant = toInteger(q);
+
+    const double s = sinPolynomial(r);
+    const double c = cosPolynomial(r);
+    const bool swap = quadrant & 1;
+    sin = blend(swap, c, s);
+    cos = blend(swap, s, c);
+    sin = blend(quadrant & 2, -sin, sin);
+    cos = blend((quadrant + 1) & 2, -cos, cos);
+}
+
+inline double fastSin(double x)
+{
+    double sin, cos;
+    fastSinCos(x, sin, cos);
+    return sin;
+}
+
+inline double fastCos(double x)
+{
+    double sin, cos;
+    fastSinCos(x, sin, cos);
+    return cos;
+}
+
+constexpr double ln2Hi = 6.93147180369123816490e-01;
+constexpr double ln2Lo = 1.90821492927058770002e-10;
+
+// Natural logarithm, for positive normal x.
+inline double fastLog(double x)
+{
+    constexpr std::int64_t mantissaMask = (std::int64_t{1} << 52) - 1;
+    constexpr std::int64_t one = std::int64_t{1023} << 52;
+    constexpr double sqrt2 = 1.41421356237309504880;
+
+    const std::int64_t bits = toBits(x);
+    double exponent = fromInteger((bits >> 52) & 0x7ff) - 1023;
+    double m = fromBits((bits & mantissaMask) | one);
+    const bool halve = m > sqrt2;
+    const double halved = m * 0.5;
+    const double incremented = exponent + 1;
+    m = blend(halve, halved, m);
+    exponent = blend(halve, incremented, exponent);
+
+    // log(m) = 2 atanh(s), |s| < 0.172
+    const double s = (m - 1) / (m + 1);
+    const double s2 = s * s;
+    const double series = 1 + s2 * (1.0 / 3 + s2 * (1.0 / 5 + s2 * (1.0 / 7 +
+        s2 * (1.0 / 9 + s2 * (1.0 / 11 + s2 * (1.0 / 13 + s2 * (1.0 / 15 +
+        s2 * (1.0 / 17 + s2 * (1.0 / 19)))))))));
+    return exponent * ln2Hi + (exponent * ln2Lo + 2 * s * series);
+}
+
+// Exponential, for |x| < 708.
+inline double fastExp(double x)
+{
+    constexpr double log2e = 1.44269504088896338700;
+
+    const double k = roundNearest(x * log2e);
+    const double r = (x - k * ln2Hi) - k * ln2Lo;
+    const double p = 1 + r * (1 + r * (1.0 / 2 + r * (1.0 / 6 + r * (1.0 / 24 +
+        r * (1.0 / 120 + r * (1.0 / 720 + r * (1.0 / 5040 +
+        r * (1.0 / 40320 + r * (1.0 / 362880 + r * (1.0 / 3628800 +
+        r * (1.0 / 39916800 + r * (1.0 / 479001600 +
+        r * (1.0 / 6227020800)))))))))))));
+    const double scale = fromBits((toInteger(k) + 1023) << 52);
+    return p * scale;
+}
+
+// Arc tangent, for any finite x.
+inline double fastAtan(double x)
+{
+    constexpr double tanPio12 = 0.26794919243112270647;
+    constexpr double sqrt3 = 1.73205080756887729353;
+
+    double a = std::fabs(x);
+    const bool invert = a > 1;
+    const double inverse = 1 / a;
+    a = blend(invert, inverse, a);
+    const bool shift = a > tanPio12;
+    const double shifted = (a * sqrt3 - 1) / (a + sqrt3);
+    a = blend(shift, shifted, a);
+
+    // Taylor series, |a| <= tan(pi/12)
+    const double a2 = a * a;
+    double p = -1.0 / 27;
+    p = p * a2 + 1.0 / 25;
+    p = p * a2 - 1.0 / 23;
+    p = p * a2 + 1.0 / 21;
+    p = p * a2 - 1.0 / 19;
+    p = p * a2 + 1.0 / 17;
+    p = p * a2 - 1.0 / 15;
+    p = p * a2 + 1.0 / 13;
+    p = p * a2 - 1.0 / 11;
+    p = p * a2 + 1.0 / 9;
+    p = p * a2 - 1.0 / 7;
+    p = p * a2 + 1.0 / 5;
+    p = p * a2 - 1.0 / 3;
+    double result = a + a * a2 * p;
+
+    const double unshifted = result + pi / 6;
+    result = blend(shift, unshifted, result);
+    const double uninverted = pi / 2 - result;
+    result = blend(invert, uninverted, result);
+    return std::copysign(result, x);
+}
+
+} // namespace ecosnail::flat::detail
@@ -0,0 +1,400 @@
+#pragma once
+
+#include <ecosnail/flat/fastmath.hpp>
+#include <ecosnail/flat/parallel.hpp>
+#include <ecosnail/flat/point.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Distances in meters between lon/lat points given in degrees.
+//
+// haversineDistance() treats the Earth as a sphere of the mean radius (error
+// up to about 0.5%). vincentyDistance() solves the inverse geodesic problem
+// on the WGS 84 ellipsoid to within 0.1 mm. Vincenty's iteration does not
+// converge for nearly antipodal points; these are solved instead with
+// Karney's series for the geodesic integrals ("Algorithms for geodesics",
+// 2013), finding the start azimuth by bisection.
+
+namespace ecosnail::flat {
+
+inline constexpr double meanEarthRadius = 6371008.8;
+
+namespace wgs84 {
+
+inline constexpr double semiMajorAxis = 6378137.0;
+inline constexpr double flattening = 1 / 298.257223563;
+inline constexpr double semiMinorAxis = semiMajorAxis * (1 - flattening);
+
+} // namespace wgs84
+
+inline double haversineDistance(
+    const Point<double>& from, const Point<double>& to)
+{
+    constexpr double radians = detail::pi / 180;
+    const double sinHalfPhi = std::sin((to.y - from.y) * radians / 2);
+    const double sinHalfLambda = std::sin((to.x - from.x) * radians / 2);
+    const double h = sinHalfPhi * sinHalfPhi +
+        std::cos(from.y * radians) * std::cos(to.y * radians) *
+        sinHalfLambda * sinHalfLambda;
+    return 2 * meanEarthRadius * std::asin(std::sqrt(std::min(h, 1.0)));
+}
+
+namespace detail {
+
+// Sum of c[l] sin(2 l sigma) for l = 1..N-1, by Clenshaw summation
+template <std::size_t N>
+double sineSeries(const double (&c)[N], double sigma)
+{
+    const double x = 2 * std::cos(2 * sigma);
+    double b1 = 0;
+    double b2 = 0;
+    for (std::size_t l = N - 1; l >= 1; l--) {
+        const double b = c[l] + x * b1 - b2;
+        b2 = b1;
+        b1 = b;
+    }
+    return b1 * std::sin(2 * sigma);
+}
+
+// Series expansions, to sixth order in epsilon, of the distance integral
+// I1 = a1 (sigma + sum c1[l] sin(2 l sigma)) and the longitude integral
+// I3 = a3 (sigma + sum c3[l] sin(2 l sigma)) of a geodesic whose equator
+// crossing has azimuth alpha0.
+struct GeodesicSeries {
+    explicit GeodesicSeries(double cosAlpha0)
+    {
+        using namespace wgs84;
+        const double n = flattening / (2 - flattening);
+        const double secondEccentricity2 =
+            (semiMajorAxis * semiMajorAxis - semiMinorAxis * semiMinorAxis) /
+            (semiMinorAxis * semiMinorAxis);
+        const double k2 = cosAlpha0 * cosAlpha0 * secondEccentricity2;
+        const double e = k2 / (2 * (1 + std::sqrt(1 + k2)) + k2);
+        const double e2 = e * e;
+        const double e3 = e2 * e;
+        const double e4 = e3 * e;
+        const double e5 = e4 * e;
+        const double e6 = e5 * e;
+
+        a1 = (1 + e2 / 4 + e4 / 64 + e6 / 256) / (1 - e);
+        c1[1] = -e / 2 + 3 * e3 / 16 - e5 / 32;
+        c1[2] = -e2 / 16 + e4 / 32 - 9 * e6 / 2048;
+        c1[3] = -e3 / 48 + 3 * e5 / 256;
+        c1[4] = -5 * e4 / 512 + 3 * e6 / 512;
+        c1[5] = -7 * e5 / 1280;
+        c1[6] = -7 * e6 / 2048;
+
+        a3 = 1 - (1 - n) / 2 * e - (1 + n / 2 - 3 * n * n / 2) / 4 * e2 -
+            (1 + 3 * n + n * n) / 16 * e3 - (3 + 2 * n) / 64 * e4 -
+            3 * e5 / 128;
+        c3[1] = (1 - n) / 4 * e + (1 - n * n) / 8 * e2 +
+            (3 + 3 * n - n * n) / 64 * e3 + (5 + 2 * n) / 128 * e4 +
+            3 * e5 / 128;
+        c3[2] = (2 - 3 * n + n * n) / 32 * e2 +
+            (3 - 2 * n - 3 * n * n) / 64 * e3 + (3 + n) / 128 * e4 +
+            5 * e5 / 256;
+        c3[3] = (5 - 9 * n + 5 * n * n) / 192 * e3 +
+            (9 - 10 * n) / 384 * e4 + 7 * e5 / 512;
+        c3[4] = (7 - 14 * n) / 512 * e4 + 7 * e5 / 512;
+        c3[5] = 21 * e5 / 2560;
+    }
+
+    double a1;
+    double c1[7] = {};
+    double a3;
+    double c3[6] = {};
+};
+
+// Karney's inverse solution. Points are first reduced by symmetry to
+// latitude1 <= 0, |latitude2| <= |latitude1| and a longitude difference in
+// [0, 180]; the longitude difference reached at latitude2 then grows
+// monotonically with the start azimuth, from 0 (due north) to 180 (due
+// south, over the pole), so the azimuth is found by bisection.
+inline double karneyDistance(
+    const Point<double>& from, const Point<double>& to)
+{
+    using namespace wgs84;
+    constexpr double radians = pi / 180;
+    constexpr double tiny = 1e-150;
+
+    double phi1 = from.y;
+    double phi2 = to.y;
+    if (std::abs(phi1) < std::abs(phi2)) {
+        std::swap(phi1, phi2);
+    }
+    if (phi1 > 0) {
+        phi1 = -phi1;
+        phi2 = -phi2;
+    }
+    const double lambda12 =
+        std::abs(std::remainder(to.x - from.x, 360.0)) * radians;
+
+    // reduced latitudes
+    auto reduce = [&] (double phi, double& sinBeta, double& cosBeta) {
+        sinBeta = (1 - flattening) * std::sin(phi * radians);
+        cosBeta = std::cos(phi * radians);
+        const double norm = std::hypot(sinBeta, cosBeta);
+        sinBeta /= norm;
+        cosBeta = std::max(cosBeta / norm, tiny);
+    };
+    double sinBeta1;
+    double cosBeta1;
+    double sinBeta2;
+    double cosBeta2;
+    reduce(phi1, sinBeta1, cosBeta1);
+    reduce(phi2, sinBeta2, cosBeta2);
+    if (std::abs(sinBeta2) == -sinBeta1) {
+        cosBeta2 = cosBeta1;
+    }
+
+    if (sinBeta1 == 0 && lambda12 <= (1 - flattening) * pi) {
+        // along the equator
+        return semiMajorAxis * lambda12;
+    }
+
+    // Longitude difference reached at latitude2 with start azimuth alpha1,
+    // and the arc lengths and series needed for the distance
+    double sigma1 = 0;
+    double sigma2 = 0;
+    double sigma12 = 0;
+    auto lambdaAt = [&] (double alpha1) -> std::pair<double, GeodesicSeries> {
+        const double sinAlpha1 = std::sin(alpha1);
+        const double cosAlpha1 = std::cos(alpha1);
+        const double sinAlpha0 = sinAlpha1 * cosBeta1;
+        const double cosAlpha0 = std::hypot(cosAlpha1, sinAlpha1 * sinBeta1);
+
+        // alpha2 follows from Clairaut's relation; the geodesic is heading
+        // north when it reaches latitude2
+        const double cosAlpha2 = cosBeta2 != cosBeta1 ||
+                std::abs(sinBeta2) != -sinBeta1 ?
+            std::sqrt(
+                cosAlpha1 * cosAlpha1 * cosBeta1 * cosBeta1 +
+                (cosBeta2 - cosBeta1) * (cosBeta2 + cosBeta1)) / cosBeta2 :
+            std::abs(cosAlpha1);
+
+        const double sinSigma1 = sinBeta1;
+        const double cosSigma1 = cosAlpha1 * cosBeta1;
+        const double sinOmega1 = sinAlpha0 * sinBeta1;
+        const double sinSigma2 = sinBeta2;
+        const double cosSigma2 = cosAlpha2 * cosBeta2;
+        const double sinOmega2 = sinAlpha0 * sinBeta2;
+        sigma1 = std::atan2(sinSigma1, cosSigma1);
+        sigma2 = std::atan2(sinSigma2, cosSigma2);
+        sigma12 = std::atan2(
+            std::max(0.0, cosSigma1 * sinSigma2 - sinSigma1 * cosSigma2),
+            cosSigma1 * cosSigma2 + sinSigma1 * sinSigma2);
+        const double omega12 = std::atan2(
+            std::max(0.0, cosSigma1 * sinOmega2 - sinOmega1 * cosSigma2),
+            cosSigma1 * cosSigma2 + sinOmega1 * sinOmega2);
+
+        const GeodesicSeries series(cosAlpha0);
+        const double lambda = omega12 - flattening * series.a3 * sinAlpha0 *
+            (sigma12 + sineSeries(series.c3, sigma2) -
+                sineSeries(series.c3, sigma1));
+        return {lambda, series};
+    };
+
+    double low = 0;
+    double high = pi;
+    double alpha1 = pi / 2;
+    for (int i = 0; i < 64; i++) {
+        alpha1 = (low + high) / 2;
+        if (alpha1 == low || alpha1 == high) {
+            break;
+        }
+        if (lambdaAt(alpha1).first < lambda12) {
+            low = alpha1;
+        } else {
+            high = alpha1;
+        }
+    }
+    const auto series = lambdaAt(alpha1).second;
+    return semiMinorAxis * series.a1 * (sigma12 +
+        sineSeries(series.c1, sigma2) - sineSeries(series.c1, sigma1));
+}
+
+} // namespace detail
+
+inline double vincentyDistance(
+    const Point<double>& from, const Point<double>& to)
+{
+    using namespace wgs84;
+    constexpr double radians = detail::pi / 180;
+    constexpr int maxIterations = 200;
+
+    const double lambdaDelta = (to.x - from.x) * radians;
+    const double u1 = std::atan((1 - flattening) * std::tan(from.y * radians));
+    const double u2 = std::atan((1 - flattening) * std::tan(to.y * radians));
+    const double sinU1 = std::sin(u1);
+    const double cosU1 = std::cos(u1);
+    const double sinU2 = std::sin(u2);
+    const double cosU2 = std::cos(u2);
+
+    double lambda = lambdaDelta;
+    double sinSigma = 0;
+    double cosSigma = 1;
+    double sigma = 0;
+    double cos2Alpha = 1;
+    double cos2SigmaM = 0;
+    bool converged = false;
+    for (int i = 0; i < maxIterations; i++) {
+        const double sinLambda = std::sin(lambda);
+        const double cosLambda = std::cos(lambda);
+        const double a = cosU2 * sinLambda;
+        const double b = cosU1 * sinU2 - sinU1 * cosU2 * cosLambda;
+        sinSigma = std::sqrt(a * a + b * b);
+        if (sinSigma == 0) {
+            return 0;
+        }
+        cosSigma = sinU1 * sinU2 + cosU1 * cosU2 * cosLambda;
+        sigma = std::atan2(sinSigma, cosSigma);
+        const double sinAlpha = cosU1 * cosU2 * sinLambda / sinSigma;
+        cos2Alpha = 1 - sinAlpha * sinAlpha;
+        // on the equator cos2Alpha is zero and cos2SigmaM is not used
+        cos2SigmaM = cos2Alpha != 0 ?
+            cosSigma - 2 * sinU1 * sinU2 / cos2Alpha : 0;
+        const double c = flattening / 16 * cos2Alpha *
+            (4 + flattening * (4 - 3 * cos2Alpha));
+        const double previous = lambda;
+        lambda = lambdaDelta + (1 - c) * flattening * sinAlpha *
+            (sigma + c * sinSigma * (cos2SigmaM + c * cosSigma *
+                (-1 + 2 * cos2SigmaM * cos2SigmaM)));
+        if (std::abs(lambda - previous) < 1e-12) {
+            converged = true;
+            break;
+        }
+    }
+    if (!converged) {
+        return detail::karneyDistance(from, to);
+    }
+
+    const double uSquared = cos2Alpha *
+        (semiMajorAxis * semiMajorAxis - semiMinorAxis * semiMinorAxis) /
+        (semiMinorAxis * semiMinorAxis);
+    const double a = 1 + uSquared / 16384 *
+        (4096 + uSquared * (-768 + uSquared * (320 - 175 * uSquared)));
+    const double b = uSquared / 1024 *
+        (256 + uSquared * (-128 + uSquared * (74 - 47 * uSquared)));
+    const double deltaSigma = b * sinSigma * (cos2SigmaM + b / 4 *
+        (cosSigma * (-1 + 2 * cos2SigmaM * cos2SigmaM) -
+            b / 6 * cos2SigmaM * (-3 + 4 * sinSigma * sinSigma) *
+            (-3 + 4 * cos2SigmaM * cos2SigmaM)));
+    return semiMinorAxis * a * (sigma - deltaSigma);
+}
+
+namespace detail {
+
+// Latitude, longitude (in radians) and cosine of latitude, the per-point
+// terms of the haversine formula.
+struct HaversineTerms {
+    explicit HaversineTerms(const Point<double>* points, std::size_t count)
+        : phi(count), lambda(count), cosPhi(count)
+    {
+        for (std::size_t i = 0; i < count; i++) {
+            phi[i] = points[i].y * (pi / 180);
+            lambda[i] = points[i].x * (pi / 180);
+            cosPhi[i] = fastCos(phi[i]);
+        }
+    }
+
+    std::vector<double> phi;
+    std::vector<double> lambda;
+    std::vector<double> cosPhi;
+};
+
+// Distances from one point to points [begin, end) of `to`.
+inline void haversineRow(
+    const Point<double>& from,
+    const HaversineTerms& to,
+    std::size_t begin,
+    std::size_t end,
+    double* out)
+{
+    const double phi = from.y * (pi / 180);
+    const double lambda = from.x * (pi / 180);
+    const double cosPhi = fastCos(phi);
+    const double* toPhi = to.phi.data();
+    const double* toLambda = to.lambda.data();
+    const double* toCosPhi = to.cosPhi.data();
+    for (std::size_t j = begin; j < end; j++) {
+        const double sinHalfPhi = fastSin((toPhi[j] - phi) / 2);
+        const double sinHalfLambda = fastSin((toLambda[j] - lambda) / 2);
+        double h = sinHalfPhi * sinHalfPhi +
+            cosPhi * toCosPhi[j] * sinHalfLambda * sinHalfLambda;
+        h = blend(h > 1, 1, h);
+        // asin(sqrt(h)), with atan approximated more cheaply than asin
+        out[j] = 2 * meanEarthRadius *
+            fastAtan(std::sqrt(h) / std::sqrt(1 - h));
+    }
+}
+
+} // namespace detail
+
+namespace batch {
+
+// Distances from one point to each of `count` points.
+inline void haversineDistance(
+    const Point<double>& from,
+    const Point<double>* to,
+    std::size_t count,
+    double* out)
+{
+    const detail::HaversineTerms terms(to, count);
+    parallelFor(count, [&] (std::size_t begin, std::size_t end) {
+        detail::haversineRow(from, terms, begin, end, out);
+    }, 1 << 16);
+}
+
+// Row-major fromCount x toCount matrix of distances.
+inline void haversineDistanceMatrix(
+    const Point<double>* from,
+    std::size_t fromCount,
+    const Point<double>* to,
+    std::size_t toCount,
+    double* out)
+{
+    const detail::HaversineTerms terms(to, toCount);
+    parallelFor(fromCount, [&] (std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            detail::haversineRow(
+                from[i], terms, 0, toCount, out + i * toCount);
+        }
+    }, 1);
+}
+
+inline void vincentyDistance(
+    const Point<double>& from,
+    const Point<double>* to,
+    std::size_t count,
+    double* out)
+{
+    parallelFor(count, [&] (std::size_t begin, std::size_t end) {
+        for (std::size_t j = begin; j < end; j++) {
+            out[j] = flat::vincentyDistance(from, to[j]);
+        }
+    });
+}
+
+inline void vincentyDistanceMatrix(
+    const Point<double>* from,
+    std::size_t fromCount,
+    const Point<double>* to,
+    std::size_t toCount,
+    double* out)
+{
+    parallelFor(fromCount, [&] (std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            for (std::size_t j = 0; j < toCount; j++) {
+                out[i * toCount + j] = flat::vincentyDistance(from[i], to[j]);
+            }
+        }
+    }, 1);
+}
+
+} // namespace batch
+
+} // namespace ecosnail::flat
@@ -0,0 +1,448 @@
+#pragma once
+
+#include <ecosnail/flat/culling.hpp>
+#include <ecosnail/flat/parallel.hpp>
+#include <ecosnail/flat/point.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace ecosnail::flat {
+
+namespace detail {
+
+inline std::uint64_t cellKey(std::int64_t x, std::int64_t y)
+{
+    return (static_cast<std::uint64_t>(x) << 32) ^
+        (static_cast<std::uint32_t>(y));
+}
+
+} // namespace detail
+
+// Static uniform grid over a point array. Only occupied cells are stored,
+// as ranges of point indices sorted by cell, so memory does not depend on
+// the extent of the data. A copy of the points in cell order keeps the
+// distance checks of a query on contiguous memory.
+template <class T>
+class GridIndex {
+public:
+    GridIndex(const Point<T>* points, std::size_t count, T cellSize)
+        : _cellSize(cellSize)
+        , _indices(count)
+    {
+        assert(cellSize > 0);
+
+        std::vector<std::uint64_t> keys(count);
+        for (std::size_t i = 0; i < count; i++) {
+            keys[i] = key(points[i]);
+        }
+        std::iota(_indices.begin(), _indices.end(), std::size_t{0});
+        std::sort(_indices.begin(), _indices.end(),
+            [&] (std::size_t lhs, std::size_t rhs) {
+                return keys[lhs] < keys[rhs];
+            });
+
+        _sorted.reserve(count);
+        for (std::size_t i = 0; i < count; i++) {
+            _sorted.push_back(points[_indices[i]]);
+            const auto k = keys[_indices[i]];
+            if (_cells.empty() || _cells.back().key != k) {
+                _cells.push_back({k, i, i});
+            }
+            _cells.back().end = i + 1;
+        }
+    }
+
+    T cellSize() const
+    {
+        return _cellSize;
+    }
+
+    std::size_t cellCount() const
+    {
+        return _cells.size();
+    }
+
+    // Calls f(index) for each point whose distance to `center` is at most
+    // `radius`.
+    template <class F>
+    void forEachWithin(const Point<T>& center, T radius, F&& f) const
+    {
+        const T squaredRadius = radius * radius;
+        forEachCandidateSlot(center, radius, [&] (std::size_t slot) {
+            const T dx = _sorted[slot].x - center.x;
+            const T dy = _sorted[slot].y - center.y;
+            if (dx * dx + dy * dy <= squaredRadius) {
+                f(_indices[slot]);
+            }
+        });
+    }
+
+    // Number of points within `radius` of `center`, counting stops at limit.
+    std::size_t countWithin(
+        const Point<T>& center,
+        T radius,
+        std::size_t limit = std::numeric_limits<std::size_t>::max()) const
+    {
+        const T squaredRadius = radius * radius;
+        std::size_t count = 0;
+        forEachCandidateCell(center, radius, [&] (const Cell& cell) {
+            for (std::size_t i = cell.begin; i < cell.end; i++) {
+                const T dx = _sorted[i].x - center.x;
+                const T dy = _sorted[i].y - center.y;
+                count += dx * dx + dy * dy <= squaredRadius;
+            }
+            return count < limit;
+        });
+        return std::min(count, limit);
+    }
+
+    // Calls f(index) for each point in the cells overlapping the square of
+    // half-size `radius` around `center`, a superset of those within radius.
+    template <class F>
+    void forEachCandidate(const Point<T>& center, T radius, F&& f) const
+    {
+        forEachCandidateSlot(center, radius, [&] (std::size_t slot) {
+            f(_indices[slot]);
+        });
+    }
+
+private:
+    struct Cell {
+        std::uint64_t key;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    // positions in cell order of the candidate points
+    template <class F>
+    void forEachCandidateSlot(
+        const Point<T>& center, T radius, F&& f) const
+    {
+        forEachCandidateCell(center, radius, [&] (const Cell& cell) {
+            for (std::size_t i = cell.begin; i < cell.end; i++) {
+                f(i);
+            }
+            return true;
+        });
+    }
+
+    // occupied cells overlapping the query square, until f returns false
+    template <class F>
+    void forEachCandidateCell(
+        const Point<T>& center, T radius, F&& f) const
+    {
+        const auto minX = coordinate(center.x - radius);
+        const auto maxX = coordinate(center.x + radius);
+        const auto minY = coordinate(center.y - radius);
+        const auto maxY = coordinate(center.y + radius);
+        for (auto x = minX; x <= maxX; x++) {
+            for (auto y = minY; y <= maxY; y++) {
+                const auto* cell = find(detail::cellKey(x, y));
+                if (cell && !f(*cell)) {
+                    return;
+                }
+            }
+        }
+    }
+
+    std::int64_t coordinate(T value) const
+    {
+        using std::floor;
+        return static_cast<std::int64_t>(floor(value / _cellSize));
+    }
+
+    std::uint64_t key(const Point<T>& point) const
+    {
+        return detail::cellKey(coordinate(point.x), coordinate(point.y));
+    }
+
+    const Cell* find(std::uint64_t key) const
+    {
+        auto it = std::lower_bound(_cells.begin(), _cells.end(), key,
+            [] (const Cell& cell, std::uint64_t value) {
+                return cell.key < value;
+            });
+        return it != _cells.end() && it->key == key ? &*it : nullptr;
+    }
+
+    T _cellSize;
+    std::vector<std::size_t> _indices;
+    std::vector<Point<T>> _sorted;
+    std::vector<Cell> _cells;
+};
+
+// Dense uniform grid over a fixed region, for entities updated from many
+// threads at once. Entities are identified by indices below the capacity;
+// points outside the region fall into its border cells.
+//
+// Each cell holds a lock-free list of nodes, which are only ever pushed:
+// moving an entity to another cell pushes a new node there and makes it the
+// entity's current one, leaving the old node behind as garbage that queries
+// skip. Insert, move, remove and queries may all run concurrently, as long
+// as each entity is updated by one thread at a time. A query concurrent with
+// a move may report the moved entity twice, or miss it.
+//
+// Nodes come from a pool that compact() refills; it must run while no other
+// thread uses the grid, e.g. once per frame. Updates that need a node when
+// the pool is empty return false and change nothing. The pool, twice the
+// capacity by default, must have room for a node per entity.
+template <class T>
+class ConcurrentGrid {
+    static_assert(std::atomic<Point<T>>::is_always_lock_free,
+        "positions are stored in lock-free atomics");
+
+public:
+    ConcurrentGrid(
+        const Rectangle<T>& region,
+        T cellSize,
+        std::size_t capacity,
+        std::size_t nodeCapacity = 0)
+        : _origin(region.min)
+        , _cellSize(cellSize)
+        , _columns(cells(region.max.x - region.min.x, cellSize))
+        , _rows(cells(region.max.y - region.min.y, cellSize))
+        , _capacity(capacity)
+        , _nodeCapacity(nodeCapacity ? nodeCapacity : 2 * capacity)
+        , _heads(new std::atomic<std::uint32_t>[_columns * _rows])
+        , _nodes(new Node[_nodeCapacity])
+        , _current(new std::atomic<std::uint32_t>[capacity])
+        , _positions(new std::atomic<Point<T>>[capacity])
+    {
+        assert(cellSize > 0);
+        if (_nodeCapacity < capacity || _nodeCapacity >= none) {
+            throw std::invalid_argument(
+                "node capacity must be at least the capacity, and below 2^32");
+        }
+
+        for (std::size_t i = 0; i < _columns * _rows; i++) {
+            _heads[i].store(none, std::memory_order_relaxed);
+        }
+        for (std::size_t i = 0; i < capacity; i++) {
+            _current[i].store(none, std::memory_order_relaxed);
+        }
+    }
+
+    T cellSize() const
+    {
+        return _cellSize;
+    }
+
+    std::size_t capacity() const
+    {
+        return _capacity;
+    }
+
+    // Nodes in use, live or garbage, out of nodeCapacity()
+    std::size_t nodeCount() const
+    {
+        return _nodeCount.load(std::memory_order_relaxed);
+    }
+
+    std::size_t nodeCapacity() const
+    {
+        return _nodeCapacity;
+    }
+
+    bool contains(std::size_t id) const
+    {
+        return _current[id].load(std::memory_order_acquire) != none;
+    }
+
+    Point<T> position(std::size_t id) const
+    {
+        return _positions[id].load(std::memory_order_acquire);
+    }
+
+    // Adds an entity that is not in the grid, or moves one that is.
+    bool insert(std::size_t id, const Point<T>& point)
+    {
+        return move(id, point);
+    }
+
+    bool move(std::size_t id, const Point<T>& point)
+    {
+        const auto cell = cellIndex(point);
+        const auto current = _current[id].load(std::memory_order_acquire);
+        if (current != none && _nodes[current].cell == cell) {
+            _positions[id].store(point, std::memory_order_release);
+            return true;
+        }
+
+        const auto node = allocate();
+        if (node == none) {
+            return false;
+        }
+        _positions[id].store(point, std::memory_order_relaxed);
+        push(node, static_cast<std::uint32_t>(id), cell);
+        _current[id].store(node, std::memory_order_release);
+        return true;
+    }
+
+    void remove(std::size_t id)
+    {
+        _current[id].store(none, std::memory_order_release);
+    }
+
+    // Calls f(id, position) for each entity whose distance to `center` is
+    // at most `radius`.
+    template <class F>
+    void forEachWithin(const Point<T>& center, T radius, F&& f) const
+    {
+        const T squaredRadius = radius * radius;
+        forEachCandidate(center, radius, [&] (
+                std::size_t id, const Point<T>& point) {
+            const T dx = point.x - center.x;
+            const T dy = point.y - center.y;
+            if (dx * dx + dy * dy <= squaredRadius) {
+                f(id, point);
+            }
+        });
+    }
+
+    // Calls f(id, position) for each entity in the cells overlapping the
+    // square of half-size `radius` around `center`.
+    template <class F>
+    void forEachCandidate(const Point<T>& center, T radius, F&& f) const
+    {
+        const auto minX = column(center.x - radius);
+        const auto maxX = column(center.x + radius);
+        const auto minY = row(center.y - radius);
+        const auto maxY = row(center.y + radius);
+        for (auto y = minY; y <= maxY; y++) {
+            for (auto x = minX; x <= maxX; x++) {
+                auto node = _heads[y * _columns + x].load(
+                    std::memory_order_acquire);
+                while (node != none) {
+                    const auto& entry = _nodes[node];
+                    if (_current[entry.id].load(
+                            std::memory_order_acquire) == node) {
+                        f(std::size_t{entry.id}, _positions[entry.id].load(
+                            std::memory_order_acquire));
+                    }
+                    node = entry.next;
+                }
+            }
+        }
+    }
+
+    // Drops garbage nodes, rebuilding the cell lists from the entities in
+    // the grid in parallel. Not safe to call concurrently with anything.
+    void compact()
+    {
+        const std::size_t cellCount = _columns * _rows;
+        for (std::size_t i = 0; i < cellCount; i++) {
+            _heads[i].store(none, std::memory_order_relaxed);
+        }
+        _nodeCount.store(0, std::memory_order_relaxed);
+
+        parallelFor(_capacity, [this] (std::size_t begin, std::size_t end) {
+            for (std::size_t id = begin; id < end; id++) {
+                if (_current[id].load(std::memory_order_relaxed) == none) {
+                    continue;
+                }
+                // at most one node per entity, which the pool has room for
+                const auto node =
+                    _nodeCount.fetch_add(1, std::memory_order_relaxed);
+                push(
+                    node,
+                    static_cast<std::uint32_t>(id),
+                    cellIndex(_positions[id].load(std::memory_order_relaxed)));
+                _current[id].store(node, std::memory_order_relaxed);
+            }
+        }, 4096);
+    }
+
+private:
+    static constexpr std::uint32_t none = ~std::uint32_t{0};
+
+    // Written once before being published by the push into a cell list
+    struct Node {
+        std::uint32_t id;
+        std::uint32_t cell;
+        std::uint32_t next;
+    };
+
+    static std::size_t cells(T extent, T cellSize)
+    {
+        using std::ceil;
+        return std::max<std::size_t>(
+            1, static_cast<std::size_t>(ceil(extent / cellSize)));
+    }
+
+    // Takes a node from the pool, or returns none if it is empty. The count
+    // stops at the capacity, so failed updates cannot wrap it around.
+    std::uint32_t allocate()
+    {
+        auto node = _nodeCount.load(std::memory_order_relaxed);
+        do {
+            if (node >= _nodeCapacity) {
+                return none;
+            }
+        } while (!_nodeCount.compare_exchange_weak(
+            node, node + 1, std::memory_order_relaxed));
+        return node;
+    }
+
+    // Treiber stack push; nodes are never popped, so there is no ABA
+    void push(std::uint32_t node, std::uint32_t id, std::uint32_t cell)
+    {
+        auto& entry = _nodes[node];
+        entry.id = id;
+        entry.cell = cell;
+        entry.next = _heads[cell].load(std::memory_order_relaxed);
+        while (!_heads[cell].compare_exchange_weak(
+                entry.next, node,
+                std::memory_order_release, std::memory_order_relaxed)) { }
+    }
+
+    std::size_t clamp(T offset, std::size_t size) const
+    {
+        using std::floor;
+        const T cell = floor(offset / _cellSize);
+        if (!(cell > 0)) {
+            return 0;
+        }
+        return std::min(static_cast<std::size_t>(cell), size - 1);
+    }
+
+    std::size_t column(T x) const
+    {
+        return clamp(x - _origin.x, _columns);
+    }
+
+    std::size_t row(T y) const
+    {
+        return clamp(y - _origin.y, _rows);
+    }
+
+    std::uint32_t cellIndex(const Point<T>& point) const
+    {
+        return static_cast<std::uint32_t>(
+            row(point.y) * _columns + column(point.x));
+    }
+
+    Point<T> _origin;
+    T _cellSize;
+    std::size_t _columns;
+    std::size_t _rows;
+    std::size_t _capacity;
+    std::size_t _nodeCapacity;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> _heads;
+    std::unique_ptr<Node[]> _nodes;
+    std::atomic<std::uint32_t> _nodeCount {0};
+    std::unique_ptr<std::atomic<std::uint32_t>[]> _current;
+    std::unique_ptr<std::atomic<Point<T>>[]> _positions;
+};
+
+} // namespace ecosnail::flat
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <ecosnail/flat/coordinates.hpp>
+#include <ecosnail/flat/point.hpp>
+#include <ecosnail/flat/vector.hpp>
+
+#include <ostream>
+
+// Explicit instantiations for the common coordinate types. When linking the
+// ecosnail-flat-static library, ECOSNAIL_FLAT_EXTERN_TEMPLATES is defined and
+// these become extern declarations, so the out-of-line functions (length(),
+// normalized(), the stream operators) are compiled once in the library
+// instead of in every translation unit. Member templates, including the
+// constructors, are still instantiated wherever they are used, and most of
+// the rest is inlined anyway, so the saving is small. The library itself
+// defines ECOSNAIL_FLAT_INSTANTIATION_DEFINITIONS to compile them.
+
+#define ECOSNAIL_FLAT_INSTANTIATE(EXTERN, T, N)                               \
+    EXTERN template struct detail::Coordinates<T, N>;                         \
+    EXTERN template struct Vector<T, N>;                                      \
+    EXTERN template struct Point<T, N>;                                       \
+    EXTERN template T squaredLength(const Vector<T, N>&);                     \
+    EXTERN template T length(const Vector<T, N>&);                            \
+    EXTERN template Vector<T, N> normalized(const Vector<T, N>&);             \
+    EXTERN template std::ostream& operator<<(                                 \
+        std::ostream&, const Vector<T, N>&);                                  \
+    EXTERN template std::ostream& operator<<(                                 \
+        std::ostream&, const Point<T, N>&);
+
+#define ECOSNAIL_FLAT_INSTANTIATE_ALL(EXTERN)                                 \
+    ECOSNAIL_FLAT_INSTANTIATE(EXTERN, int, 2)                                 \
+    ECOSNAIL_FLAT_INSTANTIATE(EXTERN, float, 2)                               \
+    ECOSNAIL_FLAT_INSTANTIATE(EXTERN, double, 2)                              \
+    ECOSNAIL_FLAT_INSTANTIATE(EXTERN, float, 3)                               \
+    ECOSNAIL_FLAT_INSTANTIATE(EXTERN, double, 3)
+
+#if defined(ECOSNAIL_FLAT_INSTANTIATION_DEFINITIONS)
+
+namespace ecosnail::flat {
+
+ECOSNAIL_FLAT_INSTANTIATE_ALL()
+
+} // namespace ecosnail::flat
+
+#elif defined(ECOSNAIL_FLAT_EXTERN_TEMPLATES)
+
+namespace ecosnail::flat {
+
+ECOSNAIL_FLAT_INSTANTIATE_ALL(extern)
+
+} // namespace ecosnail::flat
+
+#endif
+
+#undef ECOSNAIL_FLAT_INSTANTIATE_ALL
+#undef ECOSNAIL_FLAT_INSTANTIATE
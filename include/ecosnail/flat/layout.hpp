@@ -0,0 +1,117 @@
+#pragma once
+
+#include <ecosnail/flat/point.hpp>
+#include <ecosnail/flat/vector.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<span>)
+    #include <span>
+#endif
+
+// Memory layout guarantees of points and vectors, and zero-copy views of
+// interleaved coordinate buffers (GPU uploads, shared memory, network
+// packets) as arrays of them, and back.
+//
+// An element with N arithmetic components T is laid out as N consecutive T
+// values with no header, except in 3D, where it is padded to four
+// components (see coordinatesAlignment()); interleaved 3D data therefore
+// needs a stride of four values.
+//
+// In particular, Point<float, 3> is 16 bytes. Tightly packed xyz buffers,
+// as found in most mesh and point cloud formats, have a stride of three
+// values and cannot be viewed in place: copy them component by component,
+// or pad them to four values per point when writing them.
+
+namespace ecosnail::flat {
+
+namespace detail {
+
+template <class Element>
+using ComponentType =
+    std::remove_cv_t<std::remove_reference_t<decltype(
+        std::declval<Element&>()[0])>>;
+
+// Number of T values each element occupies in an interleaved buffer
+template <class Element>
+constexpr std::size_t stride =
+    sizeof(Element) / sizeof(ComponentType<Element>);
+
+template <class Element>
+constexpr bool hasPlainLayout =
+    std::is_standard_layout_v<Element> &&
+    std::is_trivially_copyable_v<Element> &&
+    std::is_trivially_default_constructible_v<Element> &&
+    stride<Element> == (Element::size == 3 ? 4 : Element::size);
+
+template <class T, std::size_t N>
+constexpr bool checkLayout()
+{
+    static_assert(hasPlainLayout<Point<T, N>>);
+    static_assert(hasPlainLayout<Vector<T, N>>);
+    static_assert(alignof(Point<T, N>) == alignof(Vector<T, N>));
+    return true;
+}
+
+static_assert(checkLayout<float, 2>());
+static_assert(checkLayout<float, 3>());
+static_assert(checkLayout<float, 4>());
+static_assert(checkLayout<double, 2>());
+static_assert(checkLayout<double, 3>());
+static_assert(checkLayout<double, 4>());
+static_assert(checkLayout<int, 2>());
+static_assert(checkLayout<int, 3>());
+static_assert(checkLayout<std::int16_t, 2>());
+
+template <class Element, class T>
+using ViewOf = std::conditional_t<std::is_const_v<T>, const Element, Element>;
+
+} // namespace detail
+
+// Interleaved coordinates viewed as elements: count elements take
+// count * stride<Element> values. The buffer must be aligned for Element.
+template <class Element, class T>
+detail::ViewOf<Element, T>* fromCoordinates(T* coordinates)
+{
+    static_assert(std::is_same_v<
+        std::remove_const_t<T>, detail::ComponentType<Element>>);
+    static_assert(detail::hasPlainLayout<Element>);
+    return reinterpret_cast<detail::ViewOf<Element, T>*>(coordinates);
+}
+
+// Elements viewed as their interleaved coordinates
+template <class Element>
+auto toCoordinates(Element* elements)
+{
+    using T = detail::ComponentType<Element>;
+    static_assert(detail::hasPlainLayout<std::remove_const_t<Element>>);
+    return reinterpret_cast<detail::ViewOf<T, Element>*>(elements);
+}
+
+#ifdef __cpp_lib_span
+
+// Span versions; a trailing partial element is left out of the view.
+template <class Element, class T, std::size_t Extent>
+std::span<detail::ViewOf<Element, T>> fromCoordinates(
+    std::span<T, Extent> coordinates)
+{
+    return {
+        fromCoordinates<Element>(coordinates.data()),
+        coordinates.size() / detail::stride<Element>};
+}
+
+template <class Element, std::size_t Extent>
+auto toCoordinates(std::span<Element, Extent> elements)
+{
+    using T = detail::ComponentType<Element>;
+    return std::span<detail::ViewOf<T, Element>>(
+        toCoordinates(elements.data()),
+        elements.size() * detail::stride<std::remove_const_t<Element>>);
+}
+
+#endif
+
+} // namespace ecosnail::flat
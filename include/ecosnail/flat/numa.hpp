@@ -0,0 +1,313 @@
+#pragma once
+
+#include <ecosnail/flat/buffer.hpp>
+#include <ecosnail/flat/parallel.hpp>
+#include <ecosnail/flat/point.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) && __has_include(<linux/mempolicy.h>)
+    #include <linux/mempolicy.h>
+    #include <sched.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #define ECOSNAIL_FLAT_LINUX_NUMA
+#endif
+
+// NUMA-aware storage: arrays split into one partition per node, with the
+// memory of each partition placed on its node and processed by threads
+// pinned to that node's CPUs. The topology is read from sysfs and memory
+// policies are set with the mbind system call, so there is nothing to link;
+// elsewhere, the machine is treated as one node and nothing is pinned.
+
+namespace ecosnail::flat {
+
+namespace detail {
+
+struct NumaNode {
+    int id = 0;
+    std::vector<int> cpus;
+};
+
+// Parses sysfs lists such as "0-3,8-11"
+inline std::vector<int> parseCpuList(const std::string& list)
+{
+    std::vector<int> result;
+    std::size_t position = 0;
+    while (position < list.size()) {
+        std::size_t end = list.find(',', position);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        const auto item = list.substr(position, end - position);
+        const auto dash = item.find('-');
+        try {
+            const int first = std::stoi(item.substr(0, dash));
+            const int last = dash == std::string::npos ?
+                first : std::stoi(item.substr(dash + 1));
+            for (int i = first; i <= last; i++) {
+                result.push_back(i);
+            }
+        } catch (const std::exception&) {
+            // blank or malformed item, e.g. the trailing newline
+        }
+        position = end + 1;
+    }
+    return result;
+}
+
+inline std::vector<int> readList(const std::string& path)
+{
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return parseCpuList(line);
+}
+
+// Nodes that have CPUs; a single node without a CPU list if the topology is
+// not available
+inline const std::vector<NumaNode>& numaNodes()
+{
+    static const std::vector<NumaNode> nodes = [] {
+        std::vector<NumaNode> result;
+#ifdef ECOSNAIL_FLAT_LINUX_NUMA
+        const std::string root = "/sys/devices/system/node/";
+        for (int id : readList(root + "online")) {
+            auto cpus = readList(
+                root + "node" + std::to_string(id) + "/cpulist");
+            if (!cpus.empty()) {
+                result.push_back({id, std::move(cpus)});
+            }
+        }
+#endif
+        if (result.empty()) {
+            result.push_back({});
+        }
+        return result;
+    }();
+    return nodes;
+}
+
+// Memory policy for pages not touched yet; failures leave the default
+// policy in place, since placement only affects performance.
+inline void placeMemory(
+    void* memory, std::size_t bytes, const std::vector<int>& nodes)
+{
+#ifdef ECOSNAIL_FLAT_LINUX_NUMA
+    if (nodes.empty() || bytes == 0) {
+        return;
+    }
+    constexpr std::size_t bits = sizeof(unsigned long) * CHAR_BIT;
+    const int maxNode = *std::max_element(nodes.begin(), nodes.end());
+    std::vector<unsigned long> mask(maxNode / bits + 1);
+    for (int node : nodes) {
+        mask[node / bits] |= 1ul << (node % bits);
+    }
+    const int mode = nodes.size() == 1 ? MPOL_PREFERRED : MPOL_INTERLEAVE;
+    syscall(
+        SYS_mbind, memory, bytes, mode, mask.data(),
+        mask.size() * bits + 1, 0);
+#else
+    (void)memory;
+    (void)bytes;
+    (void)nodes;
+#endif
+}
+
+inline void pinThread(const std::vector<int>& cpus)
+{
+#ifdef ECOSNAIL_FLAT_LINUX_NUMA
+    if (cpus.empty()) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    sched_setaffinity(0, sizeof(set), &set);
+#else
+    (void)cpus;
+#endif
+}
+
+} // namespace detail
+
+enum class NumaPlacement {
+    // each partition on the node whose threads process it
+    Local,
+    // all partitions spread page by page over all nodes, e.g. as a baseline
+    Interleaved,
+};
+
+// Uninitialized array of trivial elements, split between NUMA nodes in
+// proportion to their CPU counts. Element i lives in the partition whose
+// range [offset, offset + size) contains it.
+template <class T>
+class NumaBuffer {
+public:
+    struct Partition {
+        int node;
+        T* data;
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    explicit NumaBuffer(
+        std::size_t size, NumaPlacement placement = NumaPlacement::Local)
+        : _size(size)
+    {
+        const auto& nodes = detail::numaNodes();
+        std::vector<int> allNodes;
+        std::size_t totalCpus = 0;
+        for (const auto& node : nodes) {
+            allNodes.push_back(node.id);
+            totalCpus += std::max<std::size_t>(node.cpus.size(), 1);
+        }
+
+        std::size_t cpusBefore = 0;
+        for (const auto& node : nodes) {
+            const std::size_t begin = size * cpusBefore / totalCpus;
+            cpusBefore += std::max<std::size_t>(node.cpus.size(), 1);
+            const std::size_t end = size * cpusBefore / totalCpus;
+
+            _buffers.emplace_back(end - begin, false);
+            auto& buffer = _buffers.back();
+            detail::placeMemory(
+                buffer.data(),
+                buffer.size() * sizeof(T),
+                placement == NumaPlacement::Local ?
+                    std::vector<int>{node.id} : allNodes);
+            _partitions.push_back(
+                {node.id, buffer.data(), begin, end - begin});
+        }
+
+        // first touch from the owning node, in case the policy was refused
+        parallelFor([] (T* first, T* last, std::size_t) {
+            auto* bytes = reinterpret_cast<volatile unsigned char*>(first);
+            const std::size_t byteCount = (last - first) * sizeof(T);
+            for (std::size_t offset = 0; offset < byteCount;
+                    offset += detail::smallPageSize) {
+                bytes[offset] = 0;
+            }
+        });
+    }
+
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    std::size_t partitionCount() const
+    {
+        return _partitions.size();
+    }
+
+    const Partition& partition(std::size_t index) const
+    {
+        return _partitions[index];
+    }
+
+    // Element access through a search over the partitions; prefer
+    // parallelFor() or partition() for bulk work.
+    T& operator[](std::size_t i)
+    {
+        auto& partition = find(i);
+        return partition.data[i - partition.offset];
+    }
+
+    const T& operator[](std::size_t i) const
+    {
+        const auto& partition = find(i);
+        return partition.data[i - partition.offset];
+    }
+
+    // Calls f(first, last, offset) on contiguous ranges of elements, where
+    // offset is the index of *first, from threads pinned to the node owning
+    // the range. Like flat::parallelFor(), ranges are at least minRange
+    // long, and the first exception thrown by f is rethrown at the end.
+    template <class F>
+    void parallelFor(F&& f, std::size_t minRange = 1024)
+    {
+        const auto& nodes = detail::numaNodes();
+        std::exception_ptr error;
+        std::mutex errorMutex;
+        std::vector<std::thread> threads;
+
+        try {
+            for (std::size_t p = 0; p < _partitions.size(); p++) {
+                const auto& partition = _partitions[p];
+                const auto& cpus = nodes[p].cpus;
+                const std::size_t available =
+                    cpus.empty() ? hardwareThreads() : cpus.size();
+                const std::size_t threadCount = std::min(
+                    available,
+                    std::max<std::size_t>(1,
+                        partition.size / std::max<std::size_t>(minRange, 1)));
+
+                for (std::size_t t = 0; t < threadCount; t++) {
+                    const std::size_t begin = partition.size * t / threadCount;
+                    const std::size_t end =
+                        partition.size * (t + 1) / threadCount;
+                    if (begin == end) {
+                        continue;
+                    }
+                    threads.emplace_back([&, begin, end] {
+                        detail::pinThread(cpus);
+                        try {
+                            f(partition.data + begin,
+                                partition.data + end,
+                                partition.offset + begin);
+                        } catch (...) {
+                            std::lock_guard lock(errorMutex);
+                            if (!error) {
+                                error = std::current_exception();
+                            }
+                        }
+                    });
+                }
+            }
+        } catch (...) {
+            // a thread could not be started; the others must still be joined
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            throw;
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    const Partition& find(std::size_t i) const
+    {
+        return *(std::upper_bound(
+            _partitions.begin(), _partitions.end(), i,
+            [] (std::size_t index, const Partition& partition) {
+                return index < partition.offset + partition.size;
+            }));
+    }
+
+    std::size_t _size;
+    std::vector<UninitializedBuffer<T>> _buffers;
+    std::vector<Partition> _partitions;
+};
+
+template <class T, std::size_t N = 2>
+using NumaPointBuffer = NumaBuffer<Point<T, N>>;
+
+} // namespace ecosnail::flat
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ecosnail::flat {
+
+inline std::size_t hardwareThreads()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Splits [0, count) into contiguous ranges, at least minRange long, and
+// calls f(begin, end) for each of them on its own thread. The first
+// exception thrown by f is rethrown once all threads have finished.
+template <class F>
+void parallelFor(std::size_t count, F&& f, std::size_t minRange = 1024)
+{
+    const std::size_t threadCount = std::min(
+        hardwareThreads(),
+        std::max<std::size_t>(1, count / std::max<std::size_t>(minRange, 1)));
+    if (threadCount <= 1) {
+        f(std::size_t{0}, count);
+        return;
+    }
+
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    auto run = [&] (std::size_t index) {
+        const std::size_t begin = count * index / threadCount;
+        const std::size_t end = count * (index + 1) / threadCount;
+        try {
+            f(begin, end);
+        } catch (...) {
+            std::lock_guard lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    };
+    try {
+        for (std::size_t i = 1; i < threadCount; i++) {
+            threads.emplace_back(run, i);
+        }
+    } catch (...) {
+        // a thread could not be started; the others must still be joined
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        throw;
+    }
+    run(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace ecosnail::flat
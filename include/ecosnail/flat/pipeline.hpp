@@ -0,0 +1,234 @@
+#pragma once
+
+#include <ecosnail/flat/point.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ecosnail::flat {
+
+// A queue holding at most `capacity` items. push() blocks while the queue is
+// full, which is what propagates back-pressure between pipeline stages.
+template <class T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(std::size_t capacity)
+        : _capacity(capacity)
+    { }
+
+    // Returns false if the queue was closed, in which case the item is
+    // dropped.
+    bool push(T item)
+    {
+        std::unique_lock lock(_mutex);
+        _notFull.wait(lock, [this] {
+            return _closed || _items.size() < _capacity;
+        });
+        if (_closed) {
+            return false;
+        }
+        _items.push_back(std::move(item));
+        _notEmpty.notify_one();
+        return true;
+    }
+
+    // Returns nothing once the queue is closed and drained.
+    std::optional<T> pop()
+    {
+        std::unique_lock lock(_mutex);
+        _notEmpty.wait(lock, [this] { return _closed || !_items.empty(); });
+        if (_items.empty()) {
+            return std::nullopt;
+        }
+        auto item = std::move(_items.front());
+        _items.pop_front();
+        _notFull.notify_one();
+        return item;
+    }
+
+    void close()
+    {
+        std::lock_guard lock(_mutex);
+        _closed = true;
+        _notEmpty.notify_all();
+        _notFull.notify_all();
+    }
+
+private:
+    const std::size_t _capacity;
+    std::deque<T> _items;
+    bool _closed = false;
+    std::mutex _mutex;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+};
+
+// Streams points through a chain of stages in fixed-size chunks. Each stage
+// runs on its own thread; a fixed pool of chunks is recycled from the sink
+// back to the source, so memory use is bounded by
+// chunkSize * chunksInFlight points regardless of the input size.
+//
+//     Pipeline<Point<double>> pipeline;
+//     pipeline
+//         .source([&] (auto& chunk) { return parse(input, chunk); })
+//         .stage([&] (auto& chunk) { transform(chunk); })
+//         .stage([&] (auto& chunk) { clip(chunk); })
+//         .sink([&] (const auto& chunk) { encode(chunk, output); });
+//     pipeline.run();
+template <class P>
+class Pipeline {
+public:
+    using Chunk = std::vector<P>;
+
+    // Fills an empty chunk with up to chunk.capacity() elements. Returns
+    // false once the input is exhausted; elements added by that last call
+    // are still processed.
+    using Source = std::function<bool(Chunk&)>;
+    // Modifies a chunk in place; it may shrink or grow the chunk.
+    using Stage = std::function<void(Chunk&)>;
+    using Sink = std::function<void(const Chunk&)>;
+
+    // Throws std::invalid_argument if chunksInFlight is zero: the source
+    // would wait forever for a chunk to fill.
+    explicit Pipeline(
+            std::size_t chunkSize = 4096, std::size_t chunksInFlight = 4)
+        : _chunkSize(chunkSize)
+        , _chunksInFlight(chunksInFlight)
+    {
+        if (chunksInFlight == 0) {
+            throw std::invalid_argument(
+                "a pipeline needs at least one chunk in flight");
+        }
+    }
+
+    Pipeline& source(Source source)
+    {
+        _source = std::move(source);
+        return *this;
+    }
+
+    Pipeline& stage(Stage stage)
+    {
+        _stages.push_back(std::move(stage));
+        return *this;
+    }
+
+    Pipeline& sink(Sink sink)
+    {
+        _sink = std::move(sink);
+        return *this;
+    }
+
+    // Runs the pipeline to completion. The first exception thrown by any
+    // stage stops the pipeline and is rethrown here.
+    void run()
+    {
+        BoundedQueue<Chunk> freeChunks(_chunksInFlight);
+        for (std::size_t i = 0; i < _chunksInFlight; i++) {
+            Chunk chunk;
+            chunk.reserve(_chunkSize);
+            freeChunks.push(std::move(chunk));
+        }
+
+        std::deque<BoundedQueue<Chunk>> queues;
+        for (std::size_t i = 0; i <= _stages.size(); i++) {
+            queues.emplace_back(_chunksInFlight);
+        }
+
+        std::exception_ptr error;
+        std::mutex errorMutex;
+        auto fail = [&] {
+            std::lock_guard lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+            freeChunks.close();
+            for (auto& queue : queues) {
+                queue.close();
+            }
+        };
+
+        std::vector<std::thread> threads;
+
+        try {
+            threads.emplace_back([&] {
+                try {
+                    bool more = true;
+                    while (more) {
+                        auto chunk = freeChunks.pop();
+                        if (!chunk) {
+                            break;
+                        }
+                        chunk->clear();
+                        more = _source(*chunk);
+                        if (chunk->empty()) {
+                            freeChunks.push(std::move(*chunk));
+                        } else if (!queues.front().push(std::move(*chunk))) {
+                            break;
+                        }
+                    }
+                    queues.front().close();
+                } catch (...) {
+                    fail();
+                }
+            });
+
+            for (std::size_t i = 0; i < _stages.size(); i++) {
+                threads.emplace_back([&, i] {
+                    try {
+                        while (auto chunk = queues[i].pop()) {
+                            _stages[i](*chunk);
+                            if (!queues[i + 1].push(std::move(*chunk))) {
+                                break;
+                            }
+                        }
+                        queues[i + 1].close();
+                    } catch (...) {
+                        fail();
+                    }
+                });
+            }
+        } catch (...) {
+            // a thread could not be started: stop and join the others
+            fail();
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            throw;
+        }
+
+        try {
+            while (auto chunk = queues.back().pop()) {
+                _sink(*chunk);
+                freeChunks.push(std::move(*chunk));
+            }
+        } catch (...) {
+            fail();
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    const std::size_t _chunkSize;
+    const std::size_t _chunksInFlight;
+    Source _source;
+    std::vector<Stage> _stages;
+    Sink _sink;
+};
+
+} // namespace ecosnail::flat
@@ -1,203 +1,252 @@
 #pragma once
 
+#include <ecosnail/flat/coordinates.hpp>
 #include <ecosnail/flat/vector.hpp>
 
-#include <cassert>
 #include <cstddef>
+#include <functional>
 #include <ostream>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
 namespace ecosnail::flat {
 
-template <class T>
-struct Point {
+template <class T, std::size_t N = 2>
+struct Point : detail::Coordinates<T, N> {
+    static constexpr std::size_t size = N;
+
     // construction
 
-    Point()
-        : x{}, y{}
-    { }
+    // Trivial, so arrays can be allocated without initializing them; use
+    // Point{} or Point() for zero components.
+    Point() = default;
 
-    Point(T x, T y)
-        : x(std::move(x)), y(std::move(y))
+    template <
+        class... Us,
+        class = std::enable_if_t<
+            sizeof...(Us) == N && detail::allConvertible<T, Us...>>>
+    Point(Us... values)
+        : detail::Coordinates<T, N>{T(std::move(values))...}
     { }
 
     // implicit conversions
 
     template <class U, class = std::enable_if_t<std::is_convertible_v<U, T>>>
-    Point(const Point<U>& rhs)
-        : x(rhs.x), y(rhs.y)
+    Point(const Point<U, N>& rhs)
+        : Point(rhs, std::make_index_sequence<N>{})
     { }
 
     template <class U, class = std::enable_if_t<std::is_convertible_v<U, T>>>
-    Point(Point<U>&& rhs)
-        : x(std::move(rhs.x)), y(std::move(rhs.y))
+    Point(Point<U, N>&& rhs)
+        : Point(std::move(rhs), std::make_index_sequence<N>{})
     { }
 
     // assignment
 
     template <class U, class = std::enable_if_t<std::is_convertible_v<U, T>>>
-    Point& operator=(const Point<U>& rhs)
+    Point& operator=(const Point<U, N>& rhs)
     {
-        x = rhs.x;
-        y = rhs.y;
+        detail::unroll<N>([&] (auto i) {
+            detail::component<i>(*this) = detail::component<i>(rhs);
+        });
         return *this;
     }
 
     template <class U, class = std::enable_if_t<std::is_convertible_v<U, T>>>
-    Point& operator=(const Point<U>&& rhs)
+    Point& operator=(Point<U, N>&& rhs)
     {
-        x = std::move(rhs.x);
-        y = std::move(rhs.y);
+        detail::unroll<N>([&] (auto i) {
+            detail::component<i>(*this) =
+                std::move(detail::component<i>(rhs));
+        });
         return *this;
     }
 
-    // array subscript operator
-
-    T& operator[](std::size_t idx)
-    {
-        assert(idx < 2);
-        static const T Point::* ptrs[] {&Point::x, &Point::y};
-        return this->*ptrs[idx];
-    }
-
-    const T& operator[](std::size_t idx) const
-    {
-        assert(idx < 2);
-        static const T Point::* ptrs[] {&Point::x, &Point::y};
-        return this->*ptrs[idx];
-    }
-
     // arithmetic operators
 
     template <class U, class = std::enable_if_t<std::is_convertible_v<U, T>>>
-    Point& operator+=(const Vector<U>& rhs)
+    Point& operator+=(const Vector<U, N>& rhs)
     {
-        x += rhs.x;
-        y += rhs.y;
+        detail::unroll<N>([&] (auto i) {
+            detail::component<i>(*this) += detail::component<i>(rhs);
+        });
         return *this;
     }
 
     template <class U, class = std::enable_if_t<std::is_convertible_v<U, T>>>
-    Point& operator-=(const Vector<U>& rhs)
+    Point& operator-=(const Vector<U, N>& rhs)
     {
-        x -= rhs.x;
-        y -= rhs.y;
+        detail::unroll<N>([&] (auto i) {
+            detail::component<i>(*this) -= detail::component<i>(rhs);
+        });
         return *this;
     }
 
-    T x;
-    T y;
+private:
+    template <class P, std::size_t... I>
+    Point(P&& rhs, std::index_sequence<I...>)
+        : detail::Coordinates<T, N>{
+            T(detail::component<I>(std::forward<P>(rhs)))...}
+    { }
 };
 
+template <class T>
+using Point2 = Point<T, 2>;
+
+// Padded to four components for arithmetic T (see coordinatesAlignment())
+template <class T>
+using Point3 = Point<T, 3>;
+
+template <class T>
+using Point4 = Point<T, 4>;
+
+// component access
+
+template <std::size_t I, class T, std::size_t N>
+constexpr T& get(Point<T, N>& p)
+{
+    return detail::component<I>(p);
+}
+
+template <std::size_t I, class T, std::size_t N>
+constexpr const T& get(const Point<T, N>& p)
+{
+    return detail::component<I>(p);
+}
+
+template <std::size_t I, class T, std::size_t N>
+constexpr T&& get(Point<T, N>&& p)
+{
+    return detail::component<I>(std::move(p));
+}
+
 // arithmetic operators
 
-template <class L, class R>
-auto operator+(const Point<L>& lhs, const Vector<R>& rhs)
+template <class L, class R, std::size_t N>
+auto operator+(const Point<L, N>& lhs, const Vector<R, N>& rhs)
 {
-    return Point<std::common_type_t<L, R>>{lhs.x + rhs.x, lhs.y + rhs.y};
+    return detail::generate<Point, std::common_type_t<L, R>, N>(
+        [&] (auto i) { return get<i>(lhs) + get<i>(rhs); });
 }
 
-template <class L, class R>
-auto operator-(const Point<L>& lhs, const Vector<R>& rhs)
+template <class L, class R, std::size_t N>
+auto operator-(const Point<L, N>& lhs, const Vector<R, N>& rhs)
 {
-    return Point<std::common_type_t<L, R>>{lhs.x - rhs.x, lhs.y - rhs.y};
-};
+    return detail::generate<Point, std::common_type_t<L, R>, N>(
+        [&] (auto i) { return get<i>(lhs) - get<i>(rhs); });
+}
 
-template <class L, class R>
-auto operator-(const Point<L>& lhs, const Point<R>& rhs)
+template <class L, class R, std::size_t N>
+auto operator-(const Point<L, N>& lhs, const Point<R, N>& rhs)
 {
-    return Vector<std::common_type_t<L, R>>{lhs.x - rhs.x, lhs.y - rhs.y};
+    return detail::generate<Vector, std::common_type_t<L, R>, N>(
+        [&] (auto i) { return get<i>(lhs) - get<i>(rhs); });
 }
 
 // relational operators
 
-template <class T>
-bool operator==(const Point<T>& lhs, const Point<T>& rhs)
+template <class T, std::size_t N>
+auto operator==(const Point<T, N>& lhs, const Point<T, N>& rhs)
 {
-    return lhs.x == rhs.x && lhs.y == rhs.y;
+    return detail::all<N>([&] (auto i) { return get<i>(lhs) == get<i>(rhs); });
 }
 
-template <class T>
-bool operator!=(const Point<T>& lhs, const Point<T>& rhs)
+template <class T, std::size_t N>
+auto operator!=(const Point<T, N>& lhs, const Point<T, N>& rhs)
 {
     return !(lhs == rhs);
 }
 
-template <class T>
-bool operator<=(const Point<T>& lhs, const Point<T>& rhs)
+template <class T, std::size_t N>
+auto operator<=(const Point<T, N>& lhs, const Point<T, N>& rhs)
 {
-    return lhs.x <= rhs.x && lhs.y <= rhs.y;
+    return detail::all<N>([&] (auto i) { return get<i>(lhs) <= get<i>(rhs); });
 }
 
-template <class T>
-bool operator>=(const Point<T>& lhs, const Point<T>& rhs)
+template <class T, std::size_t N>
+auto operator>=(const Point<T, N>& lhs, const Point<T, N>& rhs)
 {
     return rhs <= lhs;
 }
 
-template <class T>
-bool operator<(const Point<T>& lhs, const Point<T>& rhs)
+template <class T, std::size_t N>
+auto operator<(const Point<T, N>& lhs, const Point<T, N>& rhs)
 {
     return lhs <= rhs && lhs != rhs;
 }
 
-template <class T>
-bool operator>(const Point<T>& lhs, const Point<T>& rhs)
+template <class T, std::size_t N>
+auto operator>(const Point<T, N>& lhs, const Point<T, N>& rhs)
 {
     return rhs < lhs;
 }
 
 // stream output
 
-template <class T>
-std::ostream& operator<<(std::ostream& output, const Point<T>& point)
+template <class T, std::size_t N>
+std::ostream& operator<<(std::ostream& output, const Point<T, N>& point)
 {
-    return output << point.x << ", " << point.y;
+    detail::unroll<N>([&] (auto i) {
+        if constexpr (i > 0) {
+            output << ", ";
+        }
+        output << get<i>(point);
+    });
+    return output;
 }
 
 } // namespace ecosnail::flat
 
 namespace std {
 
-template <class T>
-struct less<ecosnail::flat::Point<T>> {
+template <class T, std::size_t N>
+struct tuple_size<ecosnail::flat::Point<T, N>>
+    : integral_constant<size_t, N> { };
+
+template <size_t I, class T, std::size_t N>
+struct tuple_element<I, ecosnail::flat::Point<T, N>> {
+    using type = T;
+};
+
+template <class T, std::size_t N>
+struct less<ecosnail::flat::Point<T, N>> {
     constexpr bool operator()(
-        const ecosnail::flat::Point<T>& lhs,
-        const ecosnail::flat::Point<T>& rhs)
+        const ecosnail::flat::Point<T, N>& lhs,
+        const ecosnail::flat::Point<T, N>& rhs) const
     {
-        return std::tie(lhs.x, lhs.y) < std::tie(rhs.x, rhs.y);
+        return ecosnail::flat::detail::lexicographicalLess<N>(lhs, rhs);
     }
 };
 
-template <class T>
-struct greater<ecosnail::flat::Point<T>> {
+template <class T, std::size_t N>
+struct greater<ecosnail::flat::Point<T, N>> {
     constexpr bool operator()(
-        const ecosnail::flat::Point<T>& lhs,
-        const ecosnail::flat::Point<T>& rhs)
+        const ecosnail::flat::Point<T, N>& lhs,
+        const ecosnail::flat::Point<T, N>& rhs) const
     {
-        return less<ecosnail::flat::Point<T>>(rhs, lhs)();
+        return less<ecosnail::flat::Point<T, N>>{}(rhs, lhs);
     }
 };
 
-template <class T>
-struct less_equal<ecosnail::flat::Point<T>> {
+template <class T, std::size_t N>
+struct less_equal<ecosnail::flat::Point<T, N>> {
     constexpr bool operator()(
-        const ecosnail::flat::Point<T>& lhs,
-        const ecosnail::flat::Point<T>& rhs)
+        const ecosnail::flat::Point<T, N>& lhs,
+        const ecosnail::flat::Point<T, N>& rhs) const
     {
-        return !greater<ecosnail::flat::Point<T>>(lhs, rhs);
+        return !greater<ecosnail::flat::Point<T, N>>{}(lhs, rhs);
     }
 };
 
-template <class T>
-struct greater_equal<ecosnail::flat::Point<T>> {
+template <class T, std::size_t N>
+struct greater_equal<ecosnail::flat::Point<T, N>> {
     constexpr bool operator()(
-        const ecosnail::flat::Point<T>& lhs,
-        const ecosnail::flat::Point<T>& rhs)
+        const ecosnail::flat::Point<T, N>& lhs,
+        const ecosnail::flat::Point<T, N>& rhs) const
     {
-        return !less<ecosnail::flat::Point<T>>(lhs, rhs);
+        return !less<ecosnail::flat::Point<T, N>>{}(lhs, rhs);
     }
 };
 
-} // namespace ecosnail::flat
+} // namespace std
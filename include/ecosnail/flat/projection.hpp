@@ -0,0 +1,211 @@
+#pragma once
+
+#include <ecosnail/flat/fastmath.hpp>
+#include <ecosnail/flat/point.hpp>
+
+#include <cmath>
+#include <cstddef>
+
+// Map projections of lon/lat points, given in degrees, to planar points in
+// meters. The batch versions use the approximations from fastmath.hpp and
+// match the scalar ones to within 1e-7 m (1e-13 degrees for the inverse).
+
+namespace ecosnail::flat {
+
+// Radius of the sphere used by Web Mercator (EPSG:3857): the WGS 84
+// semi-major axis.
+inline constexpr double earthRadius = 6378137.0;
+
+// Web Mercator is undefined at the poles and conventionally clipped here.
+inline constexpr double maxMercatorLatitude = 85.051128779806592378;
+
+namespace detail {
+
+constexpr double radiansPerDegree = pi / 180;
+constexpr double degreesPerRadian = 180 / pi;
+
+inline double clampLatitude(double latitude)
+{
+    latitude = blend(
+        latitude > maxMercatorLatitude, maxMercatorLatitude, latitude);
+    return blend(
+        latitude < -maxMercatorLatitude, -maxMercatorLatitude, latitude);
+}
+
+} // namespace detail
+
+// Web Mercator
+
+inline Point<double> toWebMercator(const Point<double>& lonLat)
+{
+    const double phi =
+        detail::clampLatitude(lonLat.y) * detail::radiansPerDegree;
+    return {
+        earthRadius * lonLat.x * detail::radiansPerDegree,
+        earthRadius * std::log(std::tan(detail::pi / 4 + phi / 2))};
+}
+
+inline Point<double> fromWebMercator(const Point<double>& point)
+{
+    return {
+        point.x / earthRadius * detail::degreesPerRadian,
+        (2 * std::atan(std::exp(point.y / earthRadius)) - detail::pi / 2) *
+            detail::degreesPerRadian};
+}
+
+// Equirectangular projection with the given standard parallel, in degrees.
+
+inline Point<double> toEquirectangular(
+    const Point<double>& lonLat, double standardParallel = 0)
+{
+    const double scale =
+        std::cos(standardParallel * detail::radiansPerDegree);
+    return {
+        earthRadius * lonLat.x * detail::radiansPerDegree * scale,
+        earthRadius * lonLat.y * detail::radiansPerDegree};
+}
+
+inline Point<double> fromEquirectangular(
+    const Point<double>& point, double standardParallel = 0)
+{
+    const double scale =
+        std::cos(standardParallel * detail::radiansPerDegree);
+    return {
+        point.x / (earthRadius * scale) * detail::degreesPerRadian,
+        point.y / earthRadius * detail::degreesPerRadian};
+}
+
+// Slippy map tile coordinates at the given zoom level. The result is
+// fractional: its integer part is the tile index, the rest is the position
+// inside the tile.
+
+inline Point<double> lonLatToTile(const Point<double>& lonLat, int zoom)
+{
+    const double tiles = std::ldexp(1.0, zoom);
+    const double phi =
+        detail::clampLatitude(lonLat.y) * detail::radiansPerDegree;
+    const double mercator = std::log(std::tan(detail::pi / 4 + phi / 2));
+    return {
+        (lonLat.x + 180) / 360 * tiles,
+        (1 - mercator / detail::pi) / 2 * tiles};
+}
+
+inline Point<double> tileToLonLat(const Point<double>& tile, int zoom)
+{
+    const double tiles = std::ldexp(1.0, zoom);
+    const double mercator = detail::pi * (1 - 2 * tile.y / tiles);
+    return {
+        tile.x / tiles * 360 - 180,
+        std::atan(std::sinh(mercator)) * detail::degreesPerRadian};
+}
+
+namespace detail {
+
+// ln(tan(pi/4 + phi/2)) = atanh(sin(phi)), for |phi| < pi/2
+inline double fastMercator(double phi)
+{
+    const double s = fastSin(phi);
+    return 0.5 * fastLog((1 + s) / (1 - s));
+}
+
+// 2 atan(exp(y)) - pi/2 = 2 atan(tanh(y/2))
+inline double fastInverseMercator(double y)
+{
+    const double e = fastExp(y);
+    return 2 * fastAtan((e - 1) / (e + 1));
+}
+
+} // namespace detail
+
+namespace batch {
+
+inline void toWebMercator(
+    const Point<double>* lonLat, std::size_t count, Point<double>* out)
+{
+    for (std::size_t i = 0; i < count; i++) {
+        const double phi =
+            detail::clampLatitude(lonLat[i].y) * detail::radiansPerDegree;
+        const double x = earthRadius * lonLat[i].x * detail::radiansPerDegree;
+        out[i].y = earthRadius * detail::fastMercator(phi);
+        out[i].x = x;
+    }
+}
+
+inline void fromWebMercator(
+    const Point<double>* points, std::size_t count, Point<double>* out)
+{
+    for (std::size_t i = 0; i < count; i++) {
+        const double phi =
+            detail::fastInverseMercator(points[i].y / earthRadius);
+        out[i].x = points[i].x / earthRadius * detail::degreesPerRadian;
+        out[i].y = phi * detail::degreesPerRadian;
+    }
+}
+
+inline void toEquirectangular(
+    const Point<double>* lonLat,
+    std::size_t count,
+    Point<double>* out,
+    double standardParallel = 0)
+{
+    const double scale = earthRadius * detail::radiansPerDegree *
+        std::cos(standardParallel * detail::radiansPerDegree);
+    const double yScale = earthRadius * detail::radiansPerDegree;
+    for (std::size_t i = 0; i < count; i++) {
+        const double x = lonLat[i].x * scale;
+        out[i].y = lonLat[i].y * yScale;
+        out[i].x = x;
+    }
+}
+
+inline void fromEquirectangular(
+    const Point<double>* points,
+    std::size_t count,
+    Point<double>* out,
+    double standardParallel = 0)
+{
+    const double scale = 1 / (earthRadius * detail::radiansPerDegree *
+        std::cos(standardParallel * detail::radiansPerDegree));
+    const double yScale = 1 / (earthRadius * detail::radiansPerDegree);
+    for (std::size_t i = 0; i < count; i++) {
+        const double x = points[i].x * scale;
+        out[i].y = points[i].y * yScale;
+        out[i].x = x;
+    }
+}
+
+inline void lonLatToTile(
+    const Point<double>* lonLat,
+    std::size_t count,
+    Point<double>* out,
+    int zoom)
+{
+    const double tiles = std::ldexp(1.0, zoom);
+    for (std::size_t i = 0; i < count; i++) {
+        const double phi =
+            detail::clampLatitude(lonLat[i].y) * detail::radiansPerDegree;
+        const double x = (lonLat[i].x + 180) / 360 * tiles;
+        out[i].y = (1 - detail::fastMercator(phi) / detail::pi) / 2 * tiles;
+        out[i].x = x;
+    }
+}
+
+inline void tileToLonLat(
+    const Point<double>* tiles,
+    std::size_t count,
+    Point<double>* out,
+    int zoom)
+{
+    const double size = std::ldexp(1.0, zoom);
+    for (std::size_t i = 0; i < count; i++) {
+        const double mercator = detail::pi * (1 - 2 * tiles[i].y / size);
+        const double x = tiles[i].x / size * 360 - 180;
+        out[i].y =
+            detail::fastInverseMercator(mercator) * detail::degreesPerRadian;
+        out[i].x = x;
+    }
+}
+
+} // namespace batch
+
+} // namespace ecosnail::flat
@@ -0,0 +1,534 @@
+#pragma once
+
+#include <ecosnail/flat/point.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #define ECOSNAIL_FLAT_IO_URING
+#endif
+
+namespace ecosnail::flat {
+
+// How PointFileReader keeps reads in flight
+enum class ReadBackend {
+    // one io_uring instance, driven by the reading thread through the raw
+    // system calls; falls back to Threads if the kernel refuses it
+    IoUring,
+    // a few threads issuing blocking reads
+    Threads,
+};
+
+namespace detail {
+
+[[noreturn]] inline void throwReadError(int error, const std::string& what)
+{
+    throw std::system_error(error, std::generic_category(), what);
+}
+
+#ifdef ECOSNAIL_FLAT_IO_URING
+
+// Minimal io_uring: reads only, one submitter and reaper thread
+class Uring {
+public:
+    struct Completion {
+        std::uint64_t tag;
+        int result;
+    };
+
+    explicit Uring(unsigned entries)
+    {
+        io_uring_params params {};
+        _fd = static_cast<int>(
+            syscall(__NR_io_uring_setup, entries, &params));
+        if (_fd < 0) {
+            return;
+        }
+        // IORING_OP_READ arrived together with this feature, in Linux 5.6
+        if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+            close();
+            return;
+        }
+
+        _sqBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        _cqBytes = params.cq_off.cqes +
+            params.cq_entries * sizeof(io_uring_cqe);
+        _sqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+        _sq = map(_sqBytes, IORING_OFF_SQ_RING);
+        _cq = map(_cqBytes, IORING_OFF_CQ_RING);
+        _sqes = static_cast<io_uring_sqe*>(
+            map(_sqesBytes, IORING_OFF_SQES));
+        if (!_sq || !_cq || !_sqes) {
+            close();
+            return;
+        }
+
+        auto* sq = static_cast<char*>(_sq);
+        auto* cq = static_cast<char*>(_cq);
+        _sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        _sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        _sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        _cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        _cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        _cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        _cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    Uring(const Uring&) = delete;
+    Uring& operator=(const Uring&) = delete;
+
+    ~Uring()
+    {
+        close();
+    }
+
+    bool valid() const
+    {
+        return _fd >= 0;
+    }
+
+    void read(
+        int file,
+        void* buffer,
+        std::size_t bytes,
+        std::uint64_t offset,
+        std::uint64_t tag)
+    {
+        const unsigned tail = *_sqTail;
+        const unsigned index = tail & _sqMask;
+        auto& sqe = _sqes[index];
+        sqe = {};
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = file;
+        sqe.addr = reinterpret_cast<std::uint64_t>(buffer);
+        sqe.len = static_cast<std::uint32_t>(bytes);
+        sqe.off = offset;
+        sqe.user_data = tag;
+        _sqArray[index] = index;
+        __atomic_store_n(_sqTail, tail + 1, __ATOMIC_RELEASE);
+
+        while (syscall(__NR_io_uring_enter, _fd, 1, 0, 0, nullptr, 0) < 0) {
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                throwReadError(errno, "cannot submit read");
+            }
+        }
+    }
+
+    // Blocks until at least one read completes, and returns the completed
+    // ones.
+    void wait(std::vector<Completion>& completions)
+    {
+        completions.clear();
+        for (;;) {
+            unsigned head = *_cqHead;
+            const unsigned tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+            for (; head != tail; head++) {
+                const auto& cqe = _cqes[head & _cqMask];
+                completions.push_back({cqe.user_data, cqe.res});
+            }
+            __atomic_store_n(_cqHead, head, __ATOMIC_RELEASE);
+            if (!completions.empty()) {
+                return;
+            }
+            const auto result = syscall(
+                __NR_io_uring_enter, _fd, 0, 1, IORING_ENTER_GETEVENTS,
+                nullptr, 0);
+            if (result < 0 && errno != EINTR) {
+                throwReadError(errno, "cannot wait for reads");
+            }
+        }
+    }
+
+private:
+    void* map(std::size_t bytes, off_t offset)
+    {
+        void* memory = mmap(
+            nullptr, bytes, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, _fd, offset);
+        return memory == MAP_FAILED ? nullptr : memory;
+    }
+
+    void close()
+    {
+        if (_sqes) {
+            munmap(_sqes, _sqesBytes);
+        }
+        if (_cq) {
+            munmap(_cq, _cqBytes);
+        }
+        if (_sq) {
+            munmap(_sq, _sqBytes);
+        }
+        if (_fd >= 0) {
+            ::close(_fd);
+        }
+        _sq = _cq = nullptr;
+        _sqes = nullptr;
+        _fd = -1;
+    }
+
+    int _fd = -1;
+    void* _sq = nullptr;
+    void* _cq = nullptr;
+    io_uring_sqe* _sqes = nullptr;
+    std::size_t _sqBytes = 0;
+    std::size_t _cqBytes = 0;
+    std::size_t _sqesBytes = 0;
+    unsigned* _sqTail = nullptr;
+    unsigned _sqMask = 0;
+    unsigned* _sqArray = nullptr;
+    unsigned* _cqHead = nullptr;
+    unsigned* _cqTail = nullptr;
+    unsigned _cqMask = 0;
+    io_uring_cqe* _cqes = nullptr;
+};
+
+#endif
+
+} // namespace detail
+
+// Reads a file of packed elements (such as Point<float>) in chunks, keeping
+// up to inFlight chunks being read ahead of the one handed out, so that
+// reading overlaps with processing. next() has the signature of a Pipeline
+// source, so chunks can be handed to processing threads with
+//
+//     pipeline.source([&] (auto& chunk) { return reader.next(chunk); });
+//
+// A trailing partial element at the end of the file is ignored. Only one
+// thread may call next(). Read errors are thrown as std::system_error and
+// leave the reader failed: every later call to next() throws the same
+// error.
+template <class P>
+class PointFileReader {
+    static_assert(std::is_trivially_copyable_v<P>);
+
+public:
+    PointFileReader(
+        const std::string& path,
+        std::size_t chunkSize = std::size_t{1} << 16,
+        std::size_t inFlight = 4,
+        ReadBackend backend = ReadBackend::IoUring)
+        : _file(path)
+        , _chunkSize(std::max<std::size_t>(chunkSize, 1))
+        , _slots(std::max<std::size_t>(inFlight, 1))
+    {
+        struct stat status;
+        if (fstat(_file.fd, &status) != 0) {
+            detail::throwReadError(errno, "cannot read size of " + path);
+        }
+        _size = static_cast<std::size_t>(status.st_size) / sizeof(P);
+        _chunkCount = (_size + _chunkSize - 1) / _chunkSize;
+#ifdef POSIX_FADV_SEQUENTIAL
+        posix_fadvise(_file.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+        // the destructor does not run if the constructor throws, and the
+        // threads and reads started so far must not outlive the slots
+        try {
+            start(backend);
+        } catch (...) {
+            stop();
+            throw;
+        }
+    }
+
+    PointFileReader(const PointFileReader&) = delete;
+    PointFileReader& operator=(const PointFileReader&) = delete;
+
+    ~PointFileReader()
+    {
+        stop();
+    }
+
+    // Elements in the file
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    ReadBackend backend() const
+    {
+        return _backend;
+    }
+
+    // Swaps the next chunk of the file, in order, into chunk; the vector
+    // passed in is kept to read a later chunk into, so callers that recycle
+    // their vectors, like Pipeline, make reading copy and allocate nothing.
+    // Returns false, leaving chunk empty, at the end of the file.
+    bool next(std::vector<P>& chunk)
+    {
+        if (_error != 0) {
+            detail::throwReadError(_error, "cannot read point file");
+        }
+        if (_delivered == _chunkCount) {
+            chunk.clear();
+            return false;
+        }
+        auto& slot = slotOf(_delivered);
+        try {
+            waitFor(slot);
+        } catch (const std::system_error& error) {
+            _error = error.code().value();
+            throw;
+        }
+        if (slot.error != 0) {
+            _error = slot.error;
+            detail::throwReadError(_error, "cannot read point file");
+        }
+        chunk.swap(slot.data);
+        _delivered++;
+        if (_issued < _chunkCount) {
+            issue();
+        }
+        return true;
+    }
+
+private:
+    // Closes the file however construction ends
+    struct File {
+        explicit File(const std::string& path)
+            : fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC))
+        {
+            if (fd < 0) {
+                detail::throwReadError(errno, "cannot open " + path);
+            }
+        }
+
+        File(const File&) = delete;
+        File& operator=(const File&) = delete;
+
+        ~File()
+        {
+            ::close(fd);
+        }
+
+        int fd;
+    };
+
+    struct Slot {
+        std::vector<P> data;
+        std::size_t count = 0;
+        std::uint64_t offset = 0;
+        std::size_t bytes = 0;
+        std::size_t done = 0;
+        int error = 0;
+        bool ready = false;
+    };
+
+    void start(ReadBackend backend)
+    {
+#ifdef ECOSNAIL_FLAT_IO_URING
+        if (backend == ReadBackend::IoUring) {
+            _uring = std::make_unique<detail::Uring>(
+                static_cast<unsigned>(_slots.size()));
+            if (!_uring->valid()) {
+                _uring.reset();
+            }
+        }
+#else
+        (void)backend;
+#endif
+        _backend = _uring ? ReadBackend::IoUring : ReadBackend::Threads;
+        if (!_uring) {
+            const std::size_t threadCount = std::min<std::size_t>(
+                _slots.size(), 4);
+            for (std::size_t i = 0; i < threadCount; i++) {
+                _threads.emplace_back([this] { serveReads(); });
+            }
+        }
+
+        while (_issued < _chunkCount && _issued < _slots.size()) {
+            issue();
+        }
+    }
+
+    void stop()
+    {
+        // reads still in flight target the slots, so they must finish first
+        try {
+            while (_delivered < _issued) {
+                waitFor(slotOf(_delivered));
+                _delivered++;
+            }
+        } catch (...) {
+        }
+        {
+            std::lock_guard lock(_mutex);
+            _stopping = true;
+        }
+        _requested.notify_all();
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    Slot& slotOf(std::size_t chunk)
+    {
+        return _slots[chunk % _slots.size()];
+    }
+
+    // Counts the read as issued only once it is in flight, so that stop()
+    // does not wait for a read that failed to start
+    void issue()
+    {
+        auto& slot = slotOf(_issued);
+        const std::size_t first = _issued * _chunkSize;
+        slot.count = std::min(_chunkSize, _size - first);
+        slot.data.resize(slot.count);
+        slot.offset = first * sizeof(P);
+        slot.bytes = slot.count * sizeof(P);
+        slot.done = 0;
+        slot.error = 0;
+
+        if (_uring) {
+            slot.ready = false;
+            submit(slot);
+            _issued++;
+        } else {
+            {
+                std::lock_guard lock(_mutex);
+                slot.ready = false;
+                _requests.push_back(&slot);
+                _issued++;
+            }
+            _requested.notify_one();
+        }
+    }
+
+    void submit(Slot& slot)
+    {
+#ifdef ECOSNAIL_FLAT_IO_URING
+        // lengths are 32-bit; larger chunks complete in several reads
+        _uring->read(
+            _file.fd,
+            reinterpret_cast<char*>(slot.data.data()) + slot.done,
+            std::min<std::size_t>(slot.bytes - slot.done, 1u << 30),
+            slot.offset + slot.done,
+            static_cast<std::uint64_t>(&slot - _slots.data()));
+#else
+        (void)slot;
+#endif
+    }
+
+    void waitFor(Slot& slot)
+    {
+        if (!_uring) {
+            std::unique_lock lock(_mutex);
+            _completed.wait(lock, [&] { return slot.ready; });
+            return;
+        }
+#ifdef ECOSNAIL_FLAT_IO_URING
+        while (!slot.ready) {
+            _uring->wait(_completions);
+            for (const auto& completion : _completions) {
+                auto& done = _slots[completion.tag];
+                if (completion.result < 0) {
+                    done.error = -completion.result;
+                    done.ready = true;
+                } else if (completion.result == 0) {
+                    // the file shrank since it was opened
+                    done.error = EIO;
+                    done.ready = true;
+                } else {
+                    done.done += static_cast<std::size_t>(completion.result);
+                    done.ready = done.done == done.bytes;
+                    if (!done.ready) {
+                        submit(done);
+                    }
+                }
+            }
+        }
+#endif
+    }
+
+    void serveReads()
+    {
+        for (;;) {
+            Slot* slot = nullptr;
+            {
+                std::unique_lock lock(_mutex);
+                _requested.wait(lock, [this] {
+                    return _stopping || !_requests.empty();
+                });
+                if (_requests.empty()) {
+                    return;
+                }
+                slot = _requests.front();
+                _requests.pop_front();
+            }
+
+            int error = 0;
+            auto* bytes = reinterpret_cast<char*>(slot->data.data());
+            std::size_t done = 0;
+            while (done < slot->bytes) {
+                const auto result = ::pread(
+                    _file.fd, bytes + done, slot->bytes - done,
+                    static_cast<off_t>(slot->offset + done));
+                if (result > 0) {
+                    done += static_cast<std::size_t>(result);
+                } else if (result == 0) {
+                    error = EIO;
+                    break;
+                } else if (errno != EINTR) {
+                    error = errno;
+                    break;
+                }
+            }
+
+            {
+                std::lock_guard lock(_mutex);
+                slot->error = error;
+                slot->ready = true;
+            }
+            _completed.notify_all();
+        }
+    }
+
+    File _file;
+    std::size_t _chunkSize;
+    std::size_t _size = 0;
+    std::size_t _chunkCount = 0;
+    std::size_t _issued = 0;
+    std::size_t _delivered = 0;
+    int _error = 0;
+    std::vector<Slot> _slots;
+    ReadBackend _backend = ReadBackend::Threads;
+
+#ifdef ECOSNAIL_FLAT_IO_URING
+    std::unique_ptr<detail::Uring> _uring;
+    std::vector<detail::Uring::Completion> _completions;
+#else
+    std::nullptr_t _uring = nullptr;
+#endif
+
+    std::mutex _mutex;
+    std::condition_variable _requested;
+    std::condition_variable _completed;
+    std::deque<Slot*> _requests;
+    bool _stopping = false;
+    std::vector<std::thread> _threads;
+};
+
+template <class T, std::size_t N = 2>
+using PointReader = PointFileReader<Point<T, N>>;
+
+} // namespace ecosnail::flat
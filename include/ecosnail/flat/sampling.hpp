@@ -0,0 +1,254 @@
+#pragma once
+
+#include <ecosnail/flat/grid.hpp>
+#include <ecosnail/flat/parallel.hpp>
+#include <ecosnail/flat/point.hpp>
+#include <ecosnail/flat/vector.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace ecosnail::flat {
+
+namespace detail {
+
+template <class T>
+std::uint64_t cellKeyOf(const Point<T>& point, T cellSize)
+{
+    using std::floor;
+    return cellKey(
+        static_cast<std::int64_t>(floor(point.x / cellSize)),
+        static_cast<std::int64_t>(floor(point.y / cellSize)));
+}
+
+} // namespace detail
+
+// Grid downsampling
+
+enum class CellReduction {
+    // centroid of the points in the cell
+    Average,
+    // the lowest-indexed point in the cell
+    First,
+};
+
+// Reduces the points to one per occupied cell of a square grid. Cells are
+// accumulated in hash maps, one per thread, then merged. The output is
+// ordered by the lowest point index of each cell.
+template <class T>
+std::vector<Point<T>> gridDownsample(
+    const Point<T>* points,
+    std::size_t count,
+    T cellSize,
+    CellReduction reduction = CellReduction::Average)
+{
+    assert(cellSize > 0);
+
+    struct Accumulator {
+        std::size_t first;
+        std::size_t size;
+        Vector<double> sum;
+    };
+    using Cells = std::unordered_map<std::uint64_t, Accumulator>;
+
+    Cells cells;
+    std::mutex mergeMutex;
+    parallelFor(count, [&] (std::size_t begin, std::size_t end) {
+        Cells local;
+        for (std::size_t i = begin; i < end; i++) {
+            auto [it, inserted] = local.try_emplace(
+                detail::cellKeyOf(points[i], cellSize),
+                Accumulator{i, 0, {}});
+            it->second.size++;
+            if (reduction == CellReduction::Average) {
+                it->second.sum += Vector<double>{
+                    static_cast<double>(points[i].x),
+                    static_cast<double>(points[i].y)};
+            }
+        }
+
+        std::lock_guard lock(mergeMutex);
+        if (cells.empty()) {
+            cells = std::move(local);
+            return;
+        }
+        for (const auto& [key, accumulator] : local) {
+            auto [it, inserted] = cells.try_emplace(key, accumulator);
+            if (!inserted) {
+                it->second.first =
+                    std::min(it->second.first, accumulator.first);
+                it->second.size += accumulator.size;
+                it->second.sum += accumulator.sum;
+            }
+        }
+    }, 1 << 16);
+
+    std::vector<const Accumulator*> ordered;
+    ordered.reserve(cells.size());
+    for (const auto& cell : cells) {
+        ordered.push_back(&cell.second);
+    }
+    std::sort(ordered.begin(), ordered.end(),
+        [] (const Accumulator* lhs, const Accumulator* rhs) {
+            return lhs->first < rhs->first;
+        });
+
+    std::vector<Point<T>> result;
+    result.reserve(ordered.size());
+    for (const auto* cell : ordered) {
+        if (reduction == CellReduction::Average) {
+            result.push_back({
+                static_cast<T>(cell->sum.x / cell->size),
+                static_cast<T>(cell->sum.y / cell->size)});
+        } else {
+            result.push_back(points[cell->first]);
+        }
+    }
+    return result;
+}
+
+// Poisson-disk sampling
+
+namespace detail {
+
+// Background grid with cells of size radius / sqrt(2), so that each cell
+// holds at most one sample and a conflict check looks at 5x5 cells.
+template <class T>
+class PoissonGrid {
+public:
+    explicit PoissonGrid(T radius)
+        : _radius(radius)
+        , _cellSize(radius / std::sqrt(T{2}))
+    {
+        if (!(radius > 0)) {
+            throw std::invalid_argument("Poisson disk radius must be positive");
+        }
+    }
+
+    bool fits(const Point<T>& point) const
+    {
+        using std::floor;
+        const auto cx = static_cast<std::int64_t>(floor(point.x / _cellSize));
+        const auto cy = static_cast<std::int64_t>(floor(point.y / _cellSize));
+        const T squaredRadius = _radius * _radius;
+        for (auto x = cx - 2; x <= cx + 2; x++) {
+            for (auto y = cy - 2; y <= cy + 2; y++) {
+                auto it = _cells.find(cellKey(x, y));
+                if (it != _cells.end()) {
+                    const auto d = it->second - point;
+                    if (d.x * d.x + d.y * d.y < squaredRadius) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    void insert(const Point<T>& point)
+    {
+        _cells.emplace(cellKeyOf(point, _cellSize), point);
+    }
+
+private:
+    T _radius;
+    T _cellSize;
+    std::unordered_map<std::uint64_t, Point<T>> _cells;
+};
+
+} // namespace detail
+
+// Picks a subset of the points in which no two are closer than `radius`,
+// visiting the points in random order. Returns indices of the picked points
+// in ascending order. Throws std::invalid_argument unless radius > 0.
+template <class T>
+std::vector<std::size_t> poissonDiskSubsample(
+    const Point<T>* points, std::size_t count, T radius,
+    std::uint64_t seed = 0)
+{
+    std::vector<std::size_t> order(count);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::shuffle(order.begin(), order.end(), std::mt19937_64(seed));
+
+    detail::PoissonGrid<T> grid(radius);
+    std::vector<std::size_t> picked;
+    for (auto i : order) {
+        if (grid.fits(points[i])) {
+            grid.insert(points[i]);
+            picked.push_back(i);
+        }
+    }
+    std::sort(picked.begin(), picked.end());
+    return picked;
+}
+
+// Bridson's algorithm: fills the rectangle [min, max] with points no closer
+// than `radius` to each other, trying up to `attempts` candidates in the
+// annulus [radius, 2 radius] around each active sample. Throws
+// std::invalid_argument unless radius > 0.
+template <class T>
+std::vector<Point<T>> poissonDiskSample(
+    const Point<T>& min,
+    const Point<T>& max,
+    T radius,
+    std::uint64_t seed = 0,
+    int attempts = 30)
+{
+    using std::cos;
+    using std::sin;
+    using std::sqrt;
+
+    std::mt19937_64 random(seed);
+    std::uniform_real_distribution<T> unit(0, 1);
+    const T tau = T(6.283185307179586);
+
+    detail::PoissonGrid<T> grid(radius);
+    std::vector<Point<T>> samples;
+    std::vector<std::size_t> active;
+
+    auto add = [&] (const Point<T>& point) {
+        grid.insert(point);
+        active.push_back(samples.size());
+        samples.push_back(point);
+    };
+    add({
+        min.x + unit(random) * (max.x - min.x),
+        min.y + unit(random) * (max.y - min.y)});
+
+    while (!active.empty()) {
+        const auto slot = std::uniform_int_distribution<std::size_t>(
+            0, active.size() - 1)(random);
+        const auto origin = samples[active[slot]];
+        bool found = false;
+        for (int attempt = 0; attempt < attempts; attempt++) {
+            // uniform over the annulus area
+            const T r = radius * sqrt(1 + 3 * unit(random));
+            const T angle = tau * unit(random);
+            const Point<T> candidate {
+                origin.x + r * cos(angle), origin.y + r * sin(angle)};
+            if (candidate.x >= min.x && candidate.x <= max.x &&
+                    candidate.y >= min.y && candidate.y <= max.y &&
+                    grid.fits(candidate)) {
+                add(candidate);
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            active[slot] = active.back();
+            active.pop_back();
+        }
+    }
+    return samples;
+}
+
+} // namespace ecosnail::flat
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <ecosnail/flat/coordinates.hpp>
+#include <ecosnail/flat/point.hpp>
+#include <ecosnail/flat/vector.hpp>
+
+#include <experimental/simd>
+
+#include <cstddef>
+
+namespace ecosnail::flat {
+
+// Packet types: a Vector<simd<float, 8>> holds eight 2D vectors, one per
+// lane, and works with the usual operators, length() and normalized().
+
+template <class T, std::size_t W>
+using simd = std::experimental::fixed_size_simd<T, W>;
+
+template <class T, std::size_t W>
+using simdMask = std::experimental::fixed_size_simd_mask<T, W>;
+
+// Loading and storing packets. AoS functions gather from (scatter to)
+// S::size() consecutive points or vectors; SoA functions take a pointer to
+// the current element of every component array.
+
+template <
+    class S, template <class, std::size_t> class P, std::size_t N,
+    class = std::enable_if_t<detail::isPacket<S>>>
+void loadAos(P<S, N>& packet, const P<typename S::value_type, N>* source)
+{
+    detail::unroll<N>([&] (auto c) {
+        get<c>(packet) = S([&] (auto lane) {
+            return get<c>(source[lane]);
+        });
+    });
+}
+
+template <
+    class S, template <class, std::size_t> class P, std::size_t N,
+    class = std::enable_if_t<detail::isPacket<S>>>
+void storeAos(const P<S, N>& packet, P<typename S::value_type, N>* target)
+{
+    detail::unroll<N>([&] (auto c) {
+        for (std::size_t lane = 0; lane < S::size(); lane++) {
+            get<c>(target[lane]) = get<c>(packet)[lane];
+        }
+    });
+}
+
+template <
+    class S, template <class, std::size_t> class P, std::size_t N,
+    class = std::enable_if_t<detail::isPacket<S>>>
+void loadSoa(
+    P<S, N>& packet, const typename S::value_type* const (&source)[N])
+{
+    detail::unroll<N>([&] (auto c) {
+        get<c>(packet).copy_from(
+            source[c], std::experimental::element_aligned);
+    });
+}
+
+template <
+    class S, template <class, std::size_t> class P, std::size_t N,
+    class = std::enable_if_t<detail::isPacket<S>>>
+void storeSoa(
+    const P<S, N>& packet, typename S::value_type* const (&target)[N])
+{
+    detail::unroll<N>([&] (auto c) {
+        get<c>(packet).copy_to(
+            target[c], std::experimental::element_aligned);
+    });
+}
+
+} // namespace ecosnail::flat
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <ecosnail/flat/point.hpp>
+#include <ecosnail/flat/vector.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ecosnail::flat {
+
+template <class Element>
+class SnapshotBuffer;
+
+// Points or vectors in structure-of-arrays chunks, written by one thread
+// and read as consistent published frames by any number of others, without
+// locks.
+//
+// The writer modifies its working copy and calls publish(). A frame refers
+// to the chunks it was published with, which are immutable from then on:
+// the first write to a chunk after a publish copies it into a spare buffer,
+// and later writes until the next publish go there in place. Chunks that
+// are not written are shared by all frames and never copied. Buffers no
+// slot refers to any more become spares, so once every slot has been used,
+// writes allocate nothing and memory stays within slotCount + 1 copies of
+// the data. Publishing compares one pointer per chunk and updates those
+// that changed; it copies no elements.
+//
+// Published frames live in a fixed number of slots. A reader pins the
+// current slot with a reference count for as long as it holds a Snapshot;
+// publish() reuses only unpinned slots, and returns false if there are
+// none, keeping the changes for the next attempt.
+template <template <class, std::size_t> class P, class T, std::size_t N>
+class SnapshotBuffer<P<T, N>> {
+public:
+    using Element = P<T, N>;
+
+    static constexpr std::size_t chunkSize = 1024;
+
+private:
+    struct Chunk {
+        alignas(64) T coordinates[N][chunkSize] {};
+        // the working copy and slots referring to the chunk; only the writer
+        // changes it
+        std::uint32_t references = 0;
+    };
+
+    struct alignas(64) Slot {
+        std::atomic<std::uint32_t> readers {0};
+        std::uint64_t frame = 0;
+        std::vector<Chunk*> chunks;
+    };
+
+public:
+    // Read-only view of a published frame, valid while the Snapshot lives
+    class Snapshot {
+    public:
+        Snapshot(Snapshot&& other) noexcept
+            : _slot(std::exchange(other._slot, nullptr))
+            , _size(other._size)
+        { }
+
+        Snapshot& operator=(Snapshot&& other) noexcept
+        {
+            release();
+            _slot = std::exchange(other._slot, nullptr);
+            _size = other._size;
+            return *this;
+        }
+
+        ~Snapshot()
+        {
+            release();
+        }
+
+        std::size_t size() const
+        {
+            return _size;
+        }
+
+        // Number of publish() calls that led to this frame
+        std::uint64_t frame() const
+        {
+            return _slot->frame;
+        }
+
+        std::size_t chunkCount() const
+        {
+            return _slot->chunks.size();
+        }
+
+        // Coordinate c of the elements in a chunk
+        const T* coordinates(std::size_t chunk, std::size_t c) const
+        {
+            return _slot->chunks[chunk]->coordinates[c];
+        }
+
+        Element operator[](std::size_t i) const
+        {
+            return load(*_slot->chunks[i / chunkSize], i % chunkSize);
+        }
+
+    private:
+        friend class SnapshotBuffer;
+
+        Snapshot(Slot* slot, std::size_t size)
+            : _slot(slot)
+            , _size(size)
+        { }
+
+        void release()
+        {
+            if (_slot) {
+                _slot->readers.fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        Slot* _slot;
+        std::size_t _size;
+    };
+
+    explicit SnapshotBuffer(std::size_t size, std::size_t slotCount = 4)
+        : _size(size)
+        , _chunks((size + chunkSize - 1) / chunkSize)
+        , _slots(new Slot[slotCount])
+        , _slotCount(slotCount)
+    {
+        assert(slotCount >= 2);
+
+        for (auto& chunk : _chunks) {
+            chunk = spareChunk();
+            chunk->references = 2;
+        }
+        _slots[0].chunks = _chunks;
+        for (std::size_t i = 1; i < slotCount; i++) {
+            _slots[i].chunks.resize(_chunks.size(), nullptr);
+        }
+    }
+
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    std::size_t chunkCount() const
+    {
+        return _chunks.size();
+    }
+
+    // Writer interface, for the owning thread only
+
+    Element operator[](std::size_t i) const
+    {
+        return load(*_chunks[i / chunkSize], i % chunkSize);
+    }
+
+    void set(std::size_t i, const Element& element)
+    {
+        auto& chunk = writable(i / chunkSize);
+        detail::unroll<N>([&] (auto c) {
+            chunk.coordinates[c][i % chunkSize] = get<c>(element);
+        });
+    }
+
+    const T* coordinates(std::size_t chunk, std::size_t c) const
+    {
+        return _chunks[chunk]->coordinates[c];
+    }
+
+    // Coordinate c of the elements in a chunk, for writing; copies the
+    // chunk first if a published frame refers to it.
+    T* writableCoordinates(std::size_t chunk, std::size_t c)
+    {
+        return writable(chunk).coordinates[c];
+    }
+
+    // Makes the working copy the current frame. Returns false if every
+    // other slot is held by readers.
+    bool publish()
+    {
+        const auto current = _current.load(std::memory_order_relaxed);
+        for (std::uint32_t i = 0; i < _slotCount; i++) {
+            auto& slot = _slots[i];
+            // the sequentially consistent accesses here and in read()
+            // guarantee that a reader either sees its pin counted, or sees
+            // the slot stop being current and retries
+            if (i == current || slot.readers.load() != 0) {
+                continue;
+            }
+            slot.frame = ++_frame;
+            for (std::size_t c = 0; c < _chunks.size(); c++) {
+                auto*& published = slot.chunks[c];
+                if (published != _chunks[c]) {
+                    release(published);
+                    published = _chunks[c];
+                    published->references++;
+                }
+            }
+            _current.store(i);
+            return true;
+        }
+        return false;
+    }
+
+    // Reader interface, for any thread
+
+    Snapshot read() const
+    {
+        for (;;) {
+            const auto index = _current.load();
+            auto& slot = _slots[index];
+            slot.readers.fetch_add(1);
+            if (_current.load() == index) {
+                return Snapshot(&slot, _size);
+            }
+            slot.readers.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    static Element load(const Chunk& chunk, std::size_t offset)
+    {
+        Element element;
+        detail::unroll<N>([&] (auto c) {
+            get<c>(element) = chunk.coordinates[c][offset];
+        });
+        return element;
+    }
+
+    // A count of one means no frame refers to the chunk
+    Chunk& writable(std::size_t index)
+    {
+        auto*& chunk = _chunks[index];
+        if (chunk->references > 1) {
+            auto* copy = spareChunk();
+            *copy = *chunk;
+            copy->references = 1;
+            chunk->references--;
+            chunk = copy;
+        }
+        return *chunk;
+    }
+
+    // Room for every buffer is reserved in the spares as it is allocated,
+    // so that release(), and with it publish(), cannot throw.
+    Chunk* spareChunk()
+    {
+        if (_spare.empty()) {
+            if (_spare.capacity() <= _storage.size()) {
+                _spare.reserve(2 * (_storage.size() + 1));
+            }
+            _storage.push_back(std::make_unique<Chunk>());
+            return _storage.back().get();
+        }
+        auto* chunk = _spare.back();
+        _spare.pop_back();
+        return chunk;
+    }
+
+    void release(Chunk* chunk)
+    {
+        if (chunk && --chunk->references == 0) {
+            _spare.push_back(chunk);
+        }
+    }
+
+    std::size_t _size;
+    std::vector<std::unique_ptr<Chunk>> _storage;
+    std::vector<Chunk*> _spare;
+    std::vector<Chunk*> _chunks;
+    std::unique_ptr<Slot[]> _slots;
+    std::uint32_t _slotCount;
+    std::atomic<std::uint32_t> _current {0};
+    std::uint64_t _frame = 0;
+};
+
+} // namespace ecosnail::flat
@@ -0,0 +1,399 @@
+#pragma once
+
+#include <ecosnail/flat/fastmath.hpp>
+#include <ecosnail/flat/parallel.hpp>
+#include <ecosnail/flat/point.hpp>
+#include <ecosnail/flat/vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace ecosnail::flat {
+
+enum class LineJoin {
+    Miter,
+    Bevel,
+    Round,
+};
+
+enum class LineCap {
+    Butt,
+    Square,
+    Round,
+};
+
+template <class T>
+struct StrokeStyle {
+    T width = 1;
+    LineJoin join = LineJoin::Miter;
+    LineCap cap = LineCap::Butt;
+    // miters longer than this many half widths become bevels
+    T miterLimit = 4;
+    // maximum distance between round joins or caps and their polygons; must
+    // be positive if either is round
+    T tolerance = T(0.25);
+};
+
+// Vertex layout of the generated meshes: the position, the distance along
+// the polyline (for dashes and texturing), and -1 or 1 for the left or
+// right edge of the stroke, 0 on the center line (for antialiasing).
+template <class T>
+struct StrokeVertex {
+    Point<T> position;
+    T distance;
+    T side;
+};
+
+// Size of a tessellated stroke.
+struct StrokeSize {
+    std::size_t vertices = 0;
+    std::size_t indices = 0;
+};
+
+namespace detail {
+
+// Counts vertices and indices instead of writing them, so that the output
+// buffers can be sized exactly by running the same code twice.
+template <class T>
+class StrokeCounter {
+public:
+    std::uint32_t vertex(const Point<T>&, T, T)
+    {
+        return static_cast<std::uint32_t>(_size.vertices++);
+    }
+
+    void triangle(std::uint32_t, std::uint32_t, std::uint32_t)
+    {
+        _size.indices += 3;
+    }
+
+    StrokeSize size() const
+    {
+        return _size;
+    }
+
+private:
+    StrokeSize _size;
+};
+
+template <class T>
+class StrokeWriter {
+public:
+    StrokeWriter(
+            StrokeVertex<T>* vertices,
+            std::uint32_t* indices,
+            std::uint32_t firstVertex)
+        : _vertices(vertices)
+        , _indices(indices)
+        , _firstVertex(firstVertex)
+    { }
+
+    std::uint32_t vertex(const Point<T>& position, T distance, T side)
+    {
+        _vertices[_size.vertices] = {position, distance, side};
+        return _firstVertex + static_cast<std::uint32_t>(_size.vertices++);
+    }
+
+    void triangle(std::uint32_t a, std::uint32_t b, std::uint32_t c)
+    {
+        _indices[_size.indices++] = a;
+        _indices[_size.indices++] = b;
+        _indices[_size.indices++] = c;
+    }
+
+    StrokeSize size() const
+    {
+        return _size;
+    }
+
+private:
+    StrokeVertex<T>* _vertices;
+    std::uint32_t* _indices;
+    std::uint32_t _firstVertex;
+    StrokeSize _size;
+};
+
+template <class T>
+Vector<T> leftNormal(const Vector<T>& direction)
+{
+    return {-direction.y, direction.x};
+}
+
+// Fan of triangles around `center`, sweeping the unit vector `from` by
+// `angle` radians (counterclockwise if positive) to end at vertex `toIndex`.
+// The side of each new vertex is sideOf(direction from the center).
+template <class T, class Writer, class SideOf>
+void roundFan(
+    Writer& writer,
+    const Point<T>& center,
+    std::uint32_t centerIndex,
+    std::uint32_t fromIndex,
+    std::uint32_t toIndex,
+    const Vector<T>& from,
+    T angle,
+    T halfWidth,
+    T distance,
+    SideOf&& sideOf,
+    T tolerance)
+{
+    using std::abs;
+    using std::acos;
+    using std::ceil;
+    using std::cos;
+    using std::sin;
+
+    const T ratio = tolerance < halfWidth ? 1 - tolerance / halfWidth : 0;
+    const T maxStep = 2 * acos(ratio);
+    const auto steps = static_cast<std::size_t>(
+        std::max(T{1}, ceil(abs(angle) / maxStep)));
+    const T step = angle / steps;
+
+    auto previous = fromIndex;
+    for (std::size_t i = 1; i < steps; i++) {
+        const T a = step * i;
+        const Vector<T> direction {
+            from.x * cos(a) - from.y * sin(a),
+            from.x * sin(a) + from.y * cos(a)};
+        const auto next = writer.vertex(
+            center + direction * halfWidth, distance, sideOf(direction));
+        writer.triangle(centerIndex, previous, next);
+        previous = next;
+    }
+    writer.triangle(centerIndex, previous, toIndex);
+}
+
+// Cap at an end of the stroke, pointing `outward`. `left` and `right` are
+// the end vertices on either side as seen looking outward; new vertices
+// are labelled by the side of the stroke they are on, given by its unit
+// left normal `strokeLeft`.
+template <class T, class Writer>
+void cap(
+    Writer& writer,
+    const Point<T>& point,
+    const Vector<T>& outward,
+    const Vector<T>& strokeLeft,
+    std::uint32_t left,
+    std::uint32_t right,
+    T distance,
+    const StrokeStyle<T>& style)
+{
+    const T halfWidth = style.width / 2;
+    const auto normal = leftNormal(outward);
+    auto sideOf = [&] (const Vector<T>& offset) {
+        return dot(offset, strokeLeft) > 0 ? T{-1} : T{1};
+    };
+    if (style.cap == LineCap::Square) {
+        const auto extended = point + outward * halfWidth;
+        const auto l = writer.vertex(
+            extended + normal * halfWidth, distance, sideOf(normal));
+        const auto r = writer.vertex(
+            extended - normal * halfWidth, distance, sideOf(-normal));
+        writer.triangle(left, right, r);
+        writer.triangle(left, r, l);
+    } else if (style.cap == LineCap::Round) {
+        const auto center = writer.vertex(point, distance, T{0});
+        roundFan(writer, point, center, left, right, normal, T(-pi),
+            halfWidth, distance, sideOf, style.tolerance);
+    }
+}
+
+// Tessellates one polyline: a quad per segment, plus joins on the outer
+// side of each turn and caps at both ends. Zero-length segments are
+// skipped.
+template <class T, class Writer>
+void stroke(
+    Writer& writer,
+    const Point<T>* points,
+    std::size_t count,
+    const StrokeStyle<T>& style)
+{
+    using std::sqrt;
+
+    if ((style.join == LineJoin::Round || style.cap == LineCap::Round) &&
+            !(style.tolerance > 0)) {
+        throw std::invalid_argument("round stroke tolerance must be positive");
+    }
+
+    const T halfWidth = style.width / 2;
+    bool first = true;
+    Vector<T> previousDirection;
+    std::uint32_t previousLeft = 0;
+    std::uint32_t previousRight = 0;
+    T distance = 0;
+
+    std::size_t start = 0;
+    for (std::size_t i = 1; i < count; i++) {
+        const auto delta = points[i] - points[start];
+        const T segmentLength = length(delta);
+        if (segmentLength == 0) {
+            continue;
+        }
+        const auto direction = delta / segmentLength;
+        const auto normal = leftNormal(direction) * halfWidth;
+        const auto& a = points[start];
+        const auto& b = points[i];
+
+        const auto aLeft = writer.vertex(a + normal, distance, T{-1});
+        const auto aRight = writer.vertex(a - normal, distance, T{1});
+        if (first) {
+            cap(writer, a, -direction, leftNormal(direction),
+                aRight, aLeft, distance, style);
+            first = false;
+        } else {
+            // the outer side of the turn is the one the stroke turns away from
+            const T turn = previousDirection.x * direction.y -
+                previousDirection.y * direction.x;
+            if (turn != 0) {
+                const T side = turn > 0 ? T{1} : T{-1};
+                const auto from = turn > 0 ? previousRight : previousLeft;
+                const auto to = turn > 0 ? aRight : aLeft;
+                const auto center = writer.vertex(a, distance, T{0});
+                const auto fromNormal = leftNormal(previousDirection) * -side;
+                const auto toNormal = leftNormal(direction) * -side;
+
+                auto join = style.join;
+                Vector<T> miter;
+                if (join == LineJoin::Miter) {
+                    const auto sum = fromNormal + toNormal;
+                    const T cosine = dot(sum, fromNormal) / length(sum);
+                    if (cosine * style.miterLimit < 1) {
+                        join = LineJoin::Bevel;
+                    } else {
+                        miter = sum * (halfWidth / (length(sum) * cosine));
+                    }
+                }
+
+                if (join == LineJoin::Miter) {
+                    const auto tip = writer.vertex(a + miter, distance, side);
+                    writer.triangle(center, from, tip);
+                    writer.triangle(center, tip, to);
+                } else if (join == LineJoin::Round) {
+                    using std::atan2;
+                    const T angle = atan2(
+                        fromNormal.x * toNormal.y - fromNormal.y * toNormal.x,
+                        dot(fromNormal, toNormal));
+                    roundFan(writer, a, center, from, to, fromNormal,
+                        angle, halfWidth, distance,
+                        [side] (const Vector<T>&) { return side; },
+                        style.tolerance);
+                } else {
+                    writer.triangle(center, from, to);
+                }
+            }
+        }
+
+        distance += segmentLength;
+        const auto bLeft = writer.vertex(b + normal, distance, T{-1});
+        const auto bRight = writer.vertex(b - normal, distance, T{1});
+        writer.triangle(aLeft, aRight, bRight);
+        writer.triangle(aLeft, bRight, bLeft);
+
+        previousDirection = direction;
+        previousLeft = bLeft;
+        previousRight = bRight;
+        start = i;
+    }
+
+    if (!first) {
+        cap(writer, points[start], previousDirection,
+            leftNormal(previousDirection), previousLeft, previousRight,
+            distance, style);
+    }
+}
+
+} // namespace detail
+
+// Exact size of the mesh strokePolyline() generates. Like strokePolyline(),
+// throws std::invalid_argument for round joins or caps unless the tolerance
+// is positive.
+template <class T>
+StrokeSize strokeSize(
+    const Point<T>* points, std::size_t count, const StrokeStyle<T>& style)
+{
+    detail::StrokeCounter<T> counter;
+    detail::stroke(counter, points, count, style);
+    return counter.size();
+}
+
+// Writes the triangle mesh of a stroked polyline to buffers of at least
+// strokeSize() elements. Indices start at firstVertex. Allocates nothing.
+template <class T>
+StrokeSize strokePolyline(
+    const Point<T>* points,
+    std::size_t count,
+    const StrokeStyle<T>& style,
+    StrokeVertex<T>* vertices,
+    std::uint32_t* indices,
+    std::uint32_t firstVertex = 0)
+{
+    detail::StrokeWriter<T> writer(vertices, indices, firstVertex);
+    detail::stroke(writer, points, count, style);
+    return writer.size();
+}
+
+namespace batch {
+
+// Many polylines stored back to back: polyline i is points
+// [polylineOffsets[i], polylineOffsets[i + 1]).
+//
+// strokeOffsets() fills the (polylineCount + 1)-element offset arrays of
+// the meshes, whose last elements are the total buffer sizes; stroke() then
+// writes all meshes into one vertex and one index buffer, in parallel.
+
+template <class T>
+void strokeOffsets(
+    const Point<T>* points,
+    const std::size_t* polylineOffsets,
+    std::size_t polylineCount,
+    const StrokeStyle<T>& style,
+    std::size_t* vertexOffsets,
+    std::size_t* indexOffsets)
+{
+    vertexOffsets[0] = 0;
+    indexOffsets[0] = 0;
+    parallelFor(polylineCount, [&] (std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const auto size = strokeSize(
+                points + polylineOffsets[i],
+                polylineOffsets[i + 1] - polylineOffsets[i],
+                style);
+            vertexOffsets[i + 1] = size.vertices;
+            indexOffsets[i + 1] = size.indices;
+        }
+    }, 256);
+    for (std::size_t i = 0; i < polylineCount; i++) {
+        vertexOffsets[i + 1] += vertexOffsets[i];
+        indexOffsets[i + 1] += indexOffsets[i];
+    }
+}
+
+template <class T>
+void stroke(
+    const Point<T>* points,
+    const std::size_t* polylineOffsets,
+    std::size_t polylineCount,
+    const StrokeStyle<T>& style,
+    const std::size_t* vertexOffsets,
+    const std::size_t* indexOffsets,
+    StrokeVertex<T>* vertices,
+    std::uint32_t* indices)
+{
+    parallelFor(polylineCount, [&] (std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            strokePolyline(
+                points + polylineOffsets[i],
+                polylineOffsets[i + 1] - polylineOffsets[i],
+                style,
+                vertices + vertexOffsets[i],
+                indices + indexOffsets[i],
+                static_cast<std::uint32_t>(vertexOffsets[i]));
+        }
+    }, 256);
+}
+
+} // namespace batch
+
+} // namespace ecosnail::flat
@@ -0,0 +1,765 @@
+#pragma once
+
+#include <ecosnail/flat/culling.hpp>
+#include <ecosnail/flat/parallel.hpp>
+#include <ecosnail/flat/point.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Out-of-core spatial index: a pyramid of quadtree tiles stored in a single
+// file, for point sets larger than memory.
+//
+// The region of the points is split recursively into quadrants until each
+// holds at most tileCapacity points, or maxLevel is reached; the leaves are
+// the tiles. Tiles are identified by quadkeys (level and Morton code of the
+// cell) and stored back to back in depth-first order, each starting on a
+// page boundary, after a header and a table of tile keys, offsets, counts
+// and bounds.
+//
+// A TilePyramid maps tiles on demand and keeps the most recently used ones
+// mapped. Mapping a tile asks the kernel to read ahead the tiles covering
+// its neighbors, since spatial queries tend to move on to them.
+
+namespace ecosnail::flat {
+
+struct TilePyramidOptions {
+    std::size_t tileCapacity = std::size_t{1} << 20;
+    unsigned maxLevel = 12;
+    // points buffered per tile while writing
+    std::size_t writeBuffer = 256;
+};
+
+namespace detail {
+
+constexpr unsigned quadkeyLevelShift = 58;
+constexpr std::uint64_t quadkeyCodeMask =
+    (std::uint64_t{1} << quadkeyLevelShift) - 1;
+
+inline std::uint64_t spreadBits(std::uint32_t value)
+{
+    std::uint64_t x = value;
+    x = (x | (x << 16)) & 0x0000ffff0000ffff;
+    x = (x | (x << 8)) & 0x00ff00ff00ff00ff;
+    x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0f;
+    x = (x | (x << 2)) & 0x3333333333333333;
+    x = (x | (x << 1)) & 0x5555555555555555;
+    return x;
+}
+
+inline std::uint32_t compactBits(std::uint64_t x)
+{
+    x &= 0x5555555555555555;
+    x = (x | (x >> 1)) & 0x3333333333333333;
+    x = (x | (x >> 2)) & 0x0f0f0f0f0f0f0f0f;
+    x = (x | (x >> 4)) & 0x00ff00ff00ff00ff;
+    x = (x | (x >> 8)) & 0x0000ffff0000ffff;
+    x = (x | (x >> 16)) & 0x00000000ffffffff;
+    return static_cast<std::uint32_t>(x);
+}
+
+// Level in the top bits, Morton code of the cell below
+inline std::uint64_t quadkey(
+    unsigned level, std::uint32_t x, std::uint32_t y)
+{
+    return (std::uint64_t{level} << quadkeyLevelShift) |
+        spreadBits(x) | (spreadBits(y) << 1);
+}
+
+inline unsigned quadkeyLevel(std::uint64_t key)
+{
+    return static_cast<unsigned>(key >> quadkeyLevelShift);
+}
+
+inline std::uint64_t parentQuadkey(std::uint64_t key)
+{
+    return (std::uint64_t{quadkeyLevel(key) - 1} << quadkeyLevelShift) |
+        ((key & quadkeyCodeMask) >> 2);
+}
+
+inline std::uint64_t childQuadkey(std::uint64_t key, unsigned quadrant)
+{
+    return (std::uint64_t{quadkeyLevel(key) + 1} << quadkeyLevelShift) |
+        ((key & quadkeyCodeMask) << 2) | quadrant;
+}
+
+struct TileFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t pointSize;
+    std::uint32_t maxLevel;
+    std::uint32_t padding;
+    std::uint64_t tileCount;
+    std::uint64_t pointCount;
+    double region[4];
+};
+
+struct TileRecord {
+    std::uint64_t key;
+    std::uint64_t offset;
+    std::uint64_t count;
+    double bounds[4];
+};
+
+constexpr char tileFileMagic[8] = {'F', 'L', 'A', 'T', 'T', 'I', 'L', 'E'};
+constexpr std::uint32_t tileFileVersion = 1;
+
+[[noreturn]] inline void throwErrno(const std::string& what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+class FileDescriptor {
+public:
+    FileDescriptor(const std::string& path, int flags)
+        : _fd(::open(path.c_str(), flags, 0644))
+    {
+        if (_fd < 0) {
+            throwErrno("cannot open " + path);
+        }
+    }
+
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+    ~FileDescriptor()
+    {
+        ::close(_fd);
+    }
+
+    int get() const
+    {
+        return _fd;
+    }
+
+    void read(void* data, std::size_t size, std::uint64_t offset) const
+    {
+        auto* bytes = static_cast<char*>(data);
+        while (size > 0) {
+            const auto done = ::pread(_fd, bytes, size, offset);
+            if (done <= 0) {
+                if (done < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (done == 0) {
+                    errno = EIO;
+                }
+                throwErrno("cannot read tile file");
+            }
+            bytes += done;
+            size -= done;
+            offset += done;
+        }
+    }
+
+    void write(const void* data, std::size_t size, std::uint64_t offset)
+    {
+        const auto* bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            const auto done = ::pwrite(_fd, bytes, size, offset);
+            if (done < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throwErrno("cannot write tile file");
+            }
+            bytes += done;
+            size -= done;
+            offset += done;
+        }
+    }
+
+private:
+    int _fd;
+};
+
+inline std::uint64_t pageSize()
+{
+    static const auto size = static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+inline std::uint64_t alignToPage(std::uint64_t offset)
+{
+    return (offset + pageSize() - 1) / pageSize() * pageSize();
+}
+
+// Cell grid of one level over the region
+class TileGeometry {
+public:
+    TileGeometry() = default;
+
+    explicit TileGeometry(const double (&region)[4])
+        : _minX(region[0])
+        , _minY(region[1])
+        , _width(region[2] - region[0])
+        , _height(region[3] - region[1])
+    { }
+
+    template <class T>
+    std::uint64_t key(const Point<T>& point, unsigned level) const
+    {
+        return quadkey(
+            level,
+            cell(static_cast<double>(point.x), _minX, _width, level),
+            cell(static_cast<double>(point.y), _minY, _height, level));
+    }
+
+    // min x, min y, max x, max y of a cell, widened a little so that
+    // points assigned to the cell by rounding near its edges are inside
+    void bounds(std::uint64_t key, double (&result)[4]) const
+    {
+        const unsigned level = quadkeyLevel(key);
+        const double cells = std::ldexp(1.0, static_cast<int>(level));
+        const auto code = key & quadkeyCodeMask;
+        const double x = compactBits(code);
+        const double y = compactBits(code >> 1);
+        const double slackX = _width / cells * 1e-6;
+        const double slackY = _height / cells * 1e-6;
+        result[0] = _minX + _width * x / cells - slackX;
+        result[1] = _minY + _height * y / cells - slackY;
+        result[2] = _minX + _width * (x + 1) / cells + slackX;
+        result[3] = _minY + _height * (y + 1) / cells + slackY;
+    }
+
+private:
+    static std::uint32_t cell(
+        double value, double min, double extent, unsigned level)
+    {
+        using std::floor;
+        const double cells = std::ldexp(1.0, static_cast<int>(level));
+        const double index = floor((value - min) / extent * cells);
+        if (!(index > 0)) {
+            return 0;
+        }
+        return static_cast<std::uint32_t>(std::min(index, cells - 1));
+    }
+
+    double _minX = 0;
+    double _minY = 0;
+    double _width = 1;
+    double _height = 1;
+};
+
+template <class T>
+double squaredDistance(const Point<T>& point, const double (&bounds)[4])
+{
+    const double x = static_cast<double>(point.x);
+    const double y = static_cast<double>(point.y);
+    const double dx = std::max({bounds[0] - x, 0.0, x - bounds[2]});
+    const double dy = std::max({bounds[1] - y, 0.0, y - bounds[3]});
+    return dx * dx + dy * dy;
+}
+
+} // namespace detail
+
+// Writes a tile pyramid of the points to path, in three sequential passes
+// over them (bounds, tile sizes, tile contents), so that the points may
+// themselves be a memory-mapped file larger than memory. The file is
+// written under a temporary name and renamed when complete; on failure the
+// temporary file is removed.
+template <class T>
+void buildTilePyramid(
+    const std::string& path,
+    const Point<T>* points,
+    std::size_t count,
+    const TilePyramidOptions& options = {})
+{
+    using Counts = std::unordered_map<std::uint64_t, std::uint64_t>;
+
+    if (options.maxLevel > 29) {
+        throw std::invalid_argument("tile pyramid levels are limited to 29");
+    }
+
+    double region[4] = {
+        std::numeric_limits<double>::infinity(),
+        std::numeric_limits<double>::infinity(),
+        -std::numeric_limits<double>::infinity(),
+        -std::numeric_limits<double>::infinity()};
+    std::mutex mergeMutex;
+    parallelFor(count, [&] (std::size_t begin, std::size_t end) {
+        double local[4] = {region[0], region[1], region[2], region[3]};
+        for (std::size_t i = begin; i < end; i++) {
+            const double x = static_cast<double>(points[i].x);
+            const double y = static_cast<double>(points[i].y);
+            local[0] = std::min(local[0], x);
+            local[1] = std::min(local[1], y);
+            local[2] = std::max(local[2], x);
+            local[3] = std::max(local[3], y);
+        }
+        std::lock_guard lock(mergeMutex);
+        region[0] = std::min(region[0], local[0]);
+        region[1] = std::min(region[1], local[1]);
+        region[2] = std::max(region[2], local[2]);
+        region[3] = std::max(region[3], local[3]);
+    });
+    if (count == 0) {
+        region[0] = region[1] = 0;
+        region[2] = region[3] = 1;
+    }
+    // nonzero extents keep the cell computations finite
+    for (int axis = 0; axis < 2; axis++) {
+        if (!(region[axis + 2] > region[axis])) {
+            region[axis + 2] = region[axis] + 1;
+        }
+    }
+    const detail::TileGeometry geometry(region);
+
+    // points per cell at every level, from the deepest one up
+    const unsigned maxLevel = options.maxLevel;
+    std::vector<Counts> counts(maxLevel + 1);
+    parallelFor(count, [&] (std::size_t begin, std::size_t end) {
+        Counts local;
+        for (std::size_t i = begin; i < end; i++) {
+            local[geometry.key(points[i], maxLevel)]++;
+        }
+        std::lock_guard lock(mergeMutex);
+        for (const auto& [key, size] : local) {
+            counts[maxLevel][key] += size;
+        }
+    });
+    for (unsigned level = maxLevel; level > 0; level--) {
+        for (const auto& [key, size] : counts[level]) {
+            counts[level - 1][detail::parentQuadkey(key)] += size;
+        }
+    }
+
+    // tiles in depth-first order, and the tile of each deepest cell
+    std::vector<detail::TileRecord> tiles;
+    std::unordered_map<std::uint64_t, std::size_t> tileOfCell;
+    std::vector<std::uint64_t> stack;
+    if (count > 0) {
+        stack.push_back(detail::quadkey(0, 0, 0));
+    }
+    while (!stack.empty()) {
+        const auto key = stack.back();
+        stack.pop_back();
+        const unsigned level = detail::quadkeyLevel(key);
+        const auto size = counts[level].at(key);
+        if (size > options.tileCapacity && level < maxLevel) {
+            for (unsigned quadrant = 4; quadrant-- > 0; ) {
+                const auto child = detail::childQuadkey(key, quadrant);
+                if (counts[level + 1].count(child)) {
+                    stack.push_back(child);
+                }
+            }
+            continue;
+        }
+        tiles.push_back({key, 0, size, {
+            std::numeric_limits<double>::infinity(),
+            std::numeric_limits<double>::infinity(),
+            -std::numeric_limits<double>::infinity(),
+            -std::numeric_limits<double>::infinity()}});
+    }
+    {
+        std::unordered_map<std::uint64_t, std::size_t> tileIndex;
+        for (std::size_t t = 0; t < tiles.size(); t++) {
+            tileIndex[tiles[t].key] = t;
+        }
+        for (const auto& [cell, size] : counts[maxLevel]) {
+            auto key = cell;
+            while (!tileIndex.count(key)) {
+                key = detail::parentQuadkey(key);
+            }
+            tileOfCell[cell] = tileIndex[key];
+        }
+    }
+    counts.clear();
+
+    const std::uint64_t tableEnd = sizeof(detail::TileFileHeader) +
+        tiles.size() * sizeof(detail::TileRecord);
+    std::uint64_t offset = detail::alignToPage(tableEnd);
+    for (auto& tile : tiles) {
+        tile.offset = offset;
+        offset = detail::alignToPage(offset + tile.count * sizeof(Point<T>));
+    }
+
+    const auto temporary = path + ".tmp";
+    // a partial file is removed, whatever failed
+    try {
+        {
+            detail::FileDescriptor file(
+                temporary, O_WRONLY | O_CREAT | O_TRUNC);
+            if (::ftruncate(file.get(), static_cast<off_t>(offset)) != 0) {
+                detail::throwErrno("cannot resize " + temporary);
+            }
+
+            const std::size_t bufferSize = std::max<std::size_t>(
+                options.writeBuffer, 1);
+            std::vector<std::vector<Point<T>>> buffers(tiles.size());
+            std::vector<std::uint64_t> written(tiles.size());
+            auto flush = [&] (std::size_t t) {
+                auto& buffer = buffers[t];
+                file.write(
+                    buffer.data(),
+                    buffer.size() * sizeof(Point<T>),
+                    tiles[t].offset + written[t] * sizeof(Point<T>));
+                written[t] += buffer.size();
+                buffer.clear();
+            };
+            for (std::size_t i = 0; i < count; i++) {
+                const auto t = tileOfCell[geometry.key(points[i], maxLevel)];
+                auto& tile = tiles[t];
+                const double x = static_cast<double>(points[i].x);
+                const double y = static_cast<double>(points[i].y);
+                tile.bounds[0] = std::min(tile.bounds[0], x);
+                tile.bounds[1] = std::min(tile.bounds[1], y);
+                tile.bounds[2] = std::max(tile.bounds[2], x);
+                tile.bounds[3] = std::max(tile.bounds[3], y);
+                auto& buffer = buffers[t];
+                if (buffer.capacity() == 0) {
+                    buffer.reserve(bufferSize);
+                }
+                buffer.push_back(points[i]);
+                if (buffer.size() == bufferSize) {
+                    flush(t);
+                }
+            }
+            for (std::size_t t = 0; t < tiles.size(); t++) {
+                flush(t);
+            }
+
+            detail::TileFileHeader header {};
+            std::memcpy(
+                header.magic, detail::tileFileMagic, sizeof(header.magic));
+            header.version = detail::tileFileVersion;
+            header.pointSize = sizeof(Point<T>);
+            header.maxLevel = maxLevel;
+            header.tileCount = tiles.size();
+            header.pointCount = count;
+            std::copy(region, region + 4, header.region);
+            file.write(&header, sizeof(header), 0);
+            file.write(
+                tiles.data(),
+                tiles.size() * sizeof(detail::TileRecord),
+                sizeof(header));
+        }
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            detail::throwErrno("cannot rename " + temporary);
+        }
+    } catch (...) {
+        ::unlink(temporary.c_str());
+        throw;
+    }
+}
+
+// Read access to a file written by buildTilePyramid(). Queries may run from
+// several threads; a tile stays mapped while any query uses it, even if
+// evicted from the cache meanwhile.
+template <class T>
+class TilePyramid {
+public:
+    explicit TilePyramid(const std::string& path, std::size_t cacheSize = 64)
+        : _file(path, O_RDONLY)
+        , _cacheSize(std::max<std::size_t>(cacheSize, 1))
+    {
+        detail::TileFileHeader header;
+        _file.read(&header, sizeof(header), 0);
+        if (std::memcmp(header.magic, detail::tileFileMagic,
+                    sizeof(header.magic)) != 0 ||
+                header.version != detail::tileFileVersion) {
+            throw std::runtime_error(path + " is not a tile pyramid");
+        }
+        if (header.pointSize != sizeof(Point<T>)) {
+            throw std::runtime_error(
+                path + " holds points of a different type");
+        }
+        _size = header.pointCount;
+        _geometry = detail::TileGeometry(header.region);
+        _region = {
+            Point<T>{T(header.region[0]), T(header.region[1])},
+            Point<T>{T(header.region[2]), T(header.region[3])}};
+
+        _records.resize(header.tileCount);
+        _file.read(
+            _records.data(),
+            _records.size() * sizeof(detail::TileRecord),
+            sizeof(header));
+        for (std::size_t t = 0; t < _records.size(); t++) {
+            const auto key = _records[t].key;
+            _tiles[key] = t;
+            for (auto parent = key; detail::quadkeyLevel(parent) > 0; ) {
+                parent = detail::parentQuadkey(parent);
+                if (!_internal.insert(parent).second) {
+                    break;
+                }
+            }
+        }
+    }
+
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+    std::size_t tileCount() const
+    {
+        return _records.size();
+    }
+
+    // Region covered by the tiles, as given to the quadtree split
+    const Rectangle<T>& region() const
+    {
+        return _region;
+    }
+
+    // Calls f(point) for each point inside the rectangle, boundary
+    // included.
+    template <class F>
+    void forEachInside(const Rectangle<T>& rectangle, F&& f) const
+    {
+        const double query[4] = {
+            static_cast<double>(rectangle.min.x),
+            static_cast<double>(rectangle.min.y),
+            static_cast<double>(rectangle.max.x),
+            static_cast<double>(rectangle.max.y)};
+        auto overlaps = [&] (const double (&bounds)[4]) {
+            return bounds[0] <= query[2] && bounds[2] >= query[0] &&
+                bounds[1] <= query[3] && bounds[3] >= query[1];
+        };
+
+        std::vector<std::uint64_t> stack {detail::quadkey(0, 0, 0)};
+        while (!stack.empty()) {
+            const auto key = stack.back();
+            stack.pop_back();
+            if (auto it = _tiles.find(key); it != _tiles.end()) {
+                const auto& record = _records[it->second];
+                if (!overlaps(record.bounds)) {
+                    continue;
+                }
+                const bool whole = record.bounds[0] >= query[0] &&
+                    record.bounds[1] >= query[1] &&
+                    record.bounds[2] <= query[2] &&
+                    record.bounds[3] <= query[3];
+                const auto tile = this->tile(it->second);
+                for (std::size_t i = 0; i < tile->count; i++) {
+                    if (whole || contains(rectangle, tile->points[i])) {
+                        f(tile->points[i]);
+                    }
+                }
+            } else if (_internal.count(key)) {
+                for (unsigned quadrant = 0; quadrant < 4; quadrant++) {
+                    const auto child = detail::childQuadkey(key, quadrant);
+                    double bounds[4];
+                    _geometry.bounds(child, bounds);
+                    if (overlaps(bounds)) {
+                        stack.push_back(child);
+                    }
+                }
+            }
+        }
+    }
+
+    // The k points nearest to `point`, closest first, by best-first search
+    // over the quadtree: tiles are visited in order of their distance from
+    // the point until none can hold anything closer.
+    std::vector<Point<T>> nearest(const Point<T>& point, std::size_t k) const
+    {
+        using Entry = std::pair<double, std::uint64_t>;
+        using Candidate = std::pair<double, Point<T>>;
+        auto farther = [] (const auto& lhs, const auto& rhs) {
+            return lhs.first > rhs.first;
+        };
+        auto closer = [] (const auto& lhs, const auto& rhs) {
+            return lhs.first < rhs.first;
+        };
+        std::priority_queue<Entry, std::vector<Entry>, decltype(farther)>
+            nodes(farther);
+        std::priority_queue<
+                Candidate, std::vector<Candidate>, decltype(closer)>
+            best(closer);
+
+        if (k > 0) {
+            nodes.push({0.0, detail::quadkey(0, 0, 0)});
+        }
+        while (!nodes.empty()) {
+            const auto [distance, key] = nodes.top();
+            nodes.pop();
+            if (best.size() == k && distance >= best.top().first) {
+                break;
+            }
+            if (auto it = _tiles.find(key); it != _tiles.end()) {
+                const auto tile = this->tile(it->second);
+                for (std::size_t i = 0; i < tile->count; i++) {
+                    const auto& candidate = tile->points[i];
+                    const double dx = static_cast<double>(candidate.x) -
+                        static_cast<double>(point.x);
+                    const double dy = static_cast<double>(candidate.y) -
+                        static_cast<double>(point.y);
+                    const double d = dx * dx + dy * dy;
+                    if (best.size() < k) {
+                        best.push({d, candidate});
+                    } else if (d < best.top().first) {
+                        best.pop();
+                        best.push({d, candidate});
+                    }
+                }
+                continue;
+            }
+            for (unsigned quadrant = 0; quadrant < 4; quadrant++) {
+                const auto child = detail::childQuadkey(key, quadrant);
+                if (auto it = _tiles.find(child); it != _tiles.end()) {
+                    nodes.push({
+                        detail::squaredDistance(
+                            point, _records[it->second].bounds),
+                        child});
+                } else if (_internal.count(child)) {
+                    double bounds[4];
+                    _geometry.bounds(child, bounds);
+                    nodes.push(
+                        {detail::squaredDistance(point, bounds), child});
+                }
+            }
+        }
+
+        std::vector<Point<T>> result(best.size());
+        for (std::size_t i = result.size(); i-- > 0; ) {
+            result[i] = best.top().second;
+            best.pop();
+        }
+        return result;
+    }
+
+private:
+    struct MappedTile {
+        void* mapping = nullptr;
+        std::size_t bytes = 0;
+        const Point<T>* points = nullptr;
+        std::size_t count = 0;
+
+        MappedTile() = default;
+        MappedTile(const MappedTile&) = delete;
+        MappedTile& operator=(const MappedTile&) = delete;
+
+        ~MappedTile()
+        {
+            if (mapping) {
+                ::munmap(mapping, bytes);
+            }
+        }
+    };
+
+    using TileHandle = std::shared_ptr<const MappedTile>;
+
+    TileHandle tile(std::size_t index) const
+    {
+        std::lock_guard lock(_cacheMutex);
+        if (auto it = _cached.find(index); it != _cached.end()) {
+            _lru.splice(_lru.begin(), _lru, it->second);
+            return it->second->second;
+        }
+
+        const auto& record = _records[index];
+        auto mapped = std::make_shared<MappedTile>();
+        mapped->count = record.count;
+        mapped->bytes = record.count * sizeof(Point<T>);
+        mapped->mapping = ::mmap(
+            nullptr, mapped->bytes, PROT_READ, MAP_SHARED, _file.get(),
+            static_cast<off_t>(record.offset));
+        if (mapped->mapping == MAP_FAILED) {
+            mapped->mapping = nullptr;
+            detail::throwErrno("cannot map tile");
+        }
+        mapped->points = static_cast<const Point<T>*>(mapped->mapping);
+
+        _lru.emplace_front(index, mapped);
+        _cached[index] = _lru.begin();
+        if (_lru.size() > _cacheSize) {
+            _cached.erase(_lru.back().first);
+            _lru.pop_back();
+        }
+        prefetchNeighbors(record.key);
+        return mapped;
+    }
+
+    // Reads ahead the tiles covering the eight cells around a tile. Cells
+    // split into finer tiles are skipped, as their data may be much larger
+    // than the tile's.
+    void prefetchNeighbors(std::uint64_t key) const
+    {
+#ifdef POSIX_FADV_WILLNEED
+        const unsigned level = detail::quadkeyLevel(key);
+        const auto code = key & detail::quadkeyCodeMask;
+        const std::int64_t x = detail::compactBits(code);
+        const std::int64_t y = detail::compactBits(code >> 1);
+        const std::int64_t cells = std::int64_t{1} << level;
+
+        std::size_t prefetched[8];
+        std::size_t prefetchedCount = 0;
+        for (std::int64_t dy = -1; dy <= 1; dy++) {
+            for (std::int64_t dx = -1; dx <= 1; dx++) {
+                if ((dx == 0 && dy == 0) || x + dx < 0 || y + dy < 0 ||
+                        x + dx >= cells || y + dy >= cells) {
+                    continue;
+                }
+                auto neighbor = detail::quadkey(
+                    level,
+                    static_cast<std::uint32_t>(x + dx),
+                    static_cast<std::uint32_t>(y + dy));
+                if (_internal.count(neighbor)) {
+                    continue;
+                }
+                auto it = _tiles.find(neighbor);
+                while (it == _tiles.end() &&
+                        detail::quadkeyLevel(neighbor) > 0) {
+                    neighbor = detail::parentQuadkey(neighbor);
+                    it = _tiles.find(neighbor);
+                }
+                if (it == _tiles.end() || it->first == key ||
+                        std::count(prefetched, prefetched + prefetchedCount,
+                            it->second)) {
+                    continue;
+                }
+                prefetched[prefetchedCount++] = it->second;
+                const auto& record = _records[it->second];
+                ::posix_fadvise(
+                    _file.get(),
+                    static_cast<off_t>(record.offset),
+                    static_cast<off_t>(record.count * sizeof(Point<T>)),
+                    POSIX_FADV_WILLNEED);
+            }
+        }
+#else
+        // no read-ahead advice on this platform, e.g. macOS
+        (void)key;
+#endif
+    }
+
+    using LruList = std::list<std::pair<std::size_t, TileHandle>>;
+
+    detail::FileDescriptor _file;
+    std::size_t _cacheSize;
+    std::size_t _size = 0;
+    detail::TileGeometry _geometry;
+    Rectangle<T> _region;
+    std::vector<detail::TileRecord> _records;
+    std::unordered_map<std::uint64_t, std::size_t> _tiles;
+    std::unordered_set<std::uint64_t> _internal;
+
+    mutable std::mutex _cacheMutex;
+    mutable LruList _lru;
+    mutable std::unordered_map<std::size_t, typename LruList::iterator>
+        _cached;
+};
+
+} // namespace ecosnail::flat
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <ecosnail/flat/culling.hpp>
+#include <ecosnail/flat/enclosing.hpp>
+#include <ecosnail/flat/point.hpp>
+#include <ecosnail/flat/vector.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace ecosnail::flat {
+
+// Point collection with lazily computed bounds, centroid and convex hull.
+//
+// Points are grouped in chunks of chunkSize, each with dirty bits and its
+// own cached bounds, coordinate sum and hull. Changing points only marks
+// their chunks; a query then recomputes the dirty chunks and merges the
+// per-chunk results, so mostly static collections cost little more than a
+// pass over the chunks. The merged hull is the hull of the chunk hulls.
+//
+// Queries update the caches, so concurrent queries need external locking
+// like any other modification.
+template <class T>
+class TrackedPoints {
+public:
+    static constexpr std::size_t chunkSize = 256;
+
+    TrackedPoints() = default;
+
+    explicit TrackedPoints(std::vector<Point<T>> points)
+        : _points(std::move(points))
+    {
+        resizeChunks();
+        markChanged(0, _points.size());
+    }
+
+    std::size_t size() const
+    {
+        return _points.size();
+    }
+
+    bool empty() const
+    {
+        return _points.empty();
+    }
+
+    const Point<T>* data() const
+    {
+        return _points.data();
+    }
+
+    const Point<T>& operator[](std::size_t i) const
+    {
+        return _points[i];
+    }
+
+    void set(std::size_t i, const Point<T>& point)
+    {
+        _points[i] = point;
+        markChanged(i, i + 1);
+    }
+
+    // Writable access to points [begin, end), which are marked as changed.
+    // The pointer is valid until the collection is resized.
+    Point<T>* modify(std::size_t begin, std::size_t end)
+    {
+        markChanged(begin, end);
+        return _points.data() + begin;
+    }
+
+    void push(const Point<T>& point)
+    {
+        _points.push_back(point);
+        resizeChunks();
+        markChanged(_points.size() - 1, _points.size());
+    }
+
+    void pop()
+    {
+        _points.pop_back();
+        resizeChunks();
+        if (!_points.empty()) {
+            markChanged(_points.size() - 1, _points.size());
+        }
+    }
+
+    void clear()
+    {
+        _points.clear();
+        resizeChunks();
+    }
+
+    void markChanged(std::size_t begin, std::size_t end)
+    {
+        if (begin >= end) {
+            return;
+        }
+        for (std::size_t chunk = begin / chunkSize;
+                chunk <= (end - 1) / chunkSize; chunk++) {
+            _chunks[chunk].dirty = allQuantities;
+        }
+        _stale = allQuantities;
+    }
+
+    // Axis-aligned bounds; min above max if empty
+    const Rectangle<T>& bounds() const
+    {
+        if (_stale & boundsBit) {
+            _bounds = emptyBounds();
+            for (std::size_t c = 0; c < _chunks.size(); c++) {
+                auto& chunk = _chunks[c];
+                if (chunk.dirty & boundsBit) {
+                    chunk.bounds = emptyBounds();
+                    for (const auto& point : chunkPoints(c)) {
+                        extend(chunk.bounds, point);
+                    }
+                    chunk.dirty &= ~boundsBit;
+                }
+                merge(_bounds, chunk.bounds);
+            }
+            _stale &= ~boundsBit;
+        }
+        return _bounds;
+    }
+
+    // Mean of the points; the origin if empty
+    const Point<T>& centroid() const
+    {
+        if (_stale & centroidBit) {
+            Vector<T> sum {};
+            for (std::size_t c = 0; c < _chunks.size(); c++) {
+                auto& chunk = _chunks[c];
+                if (chunk.dirty & centroidBit) {
+                    chunk.sum = {};
+                    for (const auto& point : chunkPoints(c)) {
+                        chunk.sum += point - Point<T>{};
+                    }
+                    chunk.dirty &= ~centroidBit;
+                }
+                sum += chunk.sum;
+            }
+            _centroid = _points.empty() ?
+                Point<T>{} : Point<T>{} + sum / T(_points.size());
+            _stale &= ~centroidBit;
+        }
+        return _centroid;
+    }
+
+    // Convex hull, counterclockwise, as convexHull() computes it
+    const std::vector<Point<T>>& hull() const
+    {
+        if (_stale & hullBit) {
+            _chunkHulls.resize(_chunks.size() * chunkSize);
+            _gathered.clear();
+            for (std::size_t c = 0; c < _chunks.size(); c++) {
+                auto& chunk = _chunks[c];
+                Point<T>* chunkHull = _chunkHulls.data() + c * chunkSize;
+                if (chunk.dirty & hullBit) {
+                    const auto points = chunkPoints(c);
+                    chunk.hullSize = convexHull(
+                        points.begin(), points.size(), chunkHull);
+                    chunk.dirty &= ~hullBit;
+                }
+                _gathered.insert(
+                    _gathered.end(), chunkHull, chunkHull + chunk.hullSize);
+            }
+            _hull.resize(_gathered.size());
+            _hull.resize(
+                convexHull(_gathered.data(), _gathered.size(), _hull.data()));
+            _stale &= ~hullBit;
+        }
+        return _hull;
+    }
+
+private:
+    enum : std::uint8_t {
+        boundsBit = 1,
+        centroidBit = 2,
+        hullBit = 4,
+        allQuantities = boundsBit | centroidBit | hullBit,
+    };
+
+    struct Chunk {
+        std::uint8_t dirty = allQuantities;
+        Rectangle<T> bounds;
+        Vector<T> sum;
+        std::size_t hullSize = 0;
+    };
+
+    struct Range {
+        const Point<T>* first;
+        const Point<T>* last;
+
+        const Point<T>* begin() const { return first; }
+        const Point<T>* end() const { return last; }
+        std::size_t size() const { return last - first; }
+    };
+
+    Range chunkPoints(std::size_t chunk) const
+    {
+        const std::size_t begin = chunk * chunkSize;
+        const std::size_t end = std::min(begin + chunkSize, _points.size());
+        return {_points.data() + begin, _points.data() + end};
+    }
+
+    static Rectangle<T> emptyBounds()
+    {
+        constexpr T limit = std::numeric_limits<T>::has_infinity ?
+            std::numeric_limits<T>::infinity() :
+            std::numeric_limits<T>::max();
+        return {{limit, limit}, {-limit, -limit}};
+    }
+
+    static void extend(Rectangle<T>& bounds, const Point<T>& point)
+    {
+        merge(bounds, {point, point});
+    }
+
+    static void merge(Rectangle<T>& bounds, const Rectangle<T>& other)
+    {
+        bounds.min.x = std::min(bounds.min.x, other.min.x);
+        bounds.min.y = std::min(bounds.min.y, other.min.y);
+        bounds.max.x = std::max(bounds.max.x, other.max.x);
+        bounds.max.y = std::max(bounds.max.y, other.max.y);
+    }
+
+    void resizeChunks()
+    {
+        _chunks.resize((_points.size() + chunkSize - 1) / chunkSize);
+        _stale = allQuantities;
+    }
+
+    std::vector<Point<T>> _points;
+    mutable std::vector<Chunk> _chunks;
+    mutable std::uint8_t _stale = allQuantities;
+    mutable Rectangle<T> _bounds = emptyBounds();
+    mutable Point<T> _centroid;
+    mutable std::vector<Point<T>> _chunkHulls;
+    mutable std::vector<Point<T>> _gathered;
+    mutable std::vector<Point<T>> _hull;
+};
+
+} // namespace ecosnail::flat
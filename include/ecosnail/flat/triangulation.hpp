@@ -0,0 +1,1225 @@
+#pragma once
+
+#include <ecosnail/flat/point.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <set>
+#include <utility>
+#include <vector>
+
+// Triangulation of simple polygons with holes. A polygon is given as rings
+// stored back to back in one point array: the outer ring first, then each
+// hole starting at the indices listed in holeStarts. Rings are implicitly
+// closed and may be oriented either way. Triangles are appended to an index
+// buffer as triples of indices into the point array.
+
+namespace ecosnail::flat {
+
+namespace detail::earcut {
+
+// Port of the mapbox earcut algorithm: ear clipping on a doubly linked
+// vertex list, with holes joined to the outer ring by bridges, and ear
+// tests restricted by z-order curve hashing for larger inputs.
+
+struct Node {
+    Node(std::uint32_t index, double px, double py)
+        : i(index), x(px), y(py)
+    { }
+
+    std::uint32_t i;
+    double x;
+    double y;
+    Node* prev = nullptr;
+    Node* next = nullptr;
+    std::int32_t z = 0;
+    Node* prevZ = nullptr;
+    Node* nextZ = nullptr;
+    bool steiner = false;
+};
+
+class Earcut {
+public:
+    template <class T>
+    void run(
+        const Point<T>* points,
+        std::size_t count,
+        const std::size_t* holeStarts,
+        std::size_t holeCount,
+        std::vector<std::uint32_t>& triangles)
+    {
+        _triangles = &triangles;
+        _nodes.clear();
+
+        const std::size_t outerEnd = holeCount > 0 ? holeStarts[0] : count;
+        Node* outer = linkedList(points, 0, outerEnd, true);
+        if (!outer || outer->next == outer->prev) {
+            return;
+        }
+        if (holeCount > 0) {
+            outer = eliminateHoles(points, count, holeStarts, holeCount, outer);
+        }
+
+        _hashed = count > 80;
+        if (_hashed) {
+            _minX = _maxX = points[0].x;
+            _minY = _maxY = points[0].y;
+            for (std::size_t i = 1; i < outerEnd; i++) {
+                _minX = std::min<double>(_minX, points[i].x);
+                _minY = std::min<double>(_minY, points[i].y);
+                _maxX = std::max<double>(_maxX, points[i].x);
+                _maxY = std::max<double>(_maxY, points[i].y);
+            }
+            const double size = std::max(_maxX - _minX, _maxY - _minY);
+            _invSize = size != 0 ? 32767 / size : 0;
+        }
+
+        earcutLinked(outer, 0);
+    }
+
+private:
+    Node* insertNode(std::uint32_t i, double x, double y, Node* last)
+    {
+        Node* p = &_nodes.emplace_back(i, x, y);
+        if (!last) {
+            p->prev = p;
+            p->next = p;
+        } else {
+            p->next = last->next;
+            p->prev = last;
+            last->next->prev = p;
+            last->next = p;
+        }
+        return p;
+    }
+
+    static void removeNode(Node* p)
+    {
+        p->next->prev = p->prev;
+        p->prev->next = p->next;
+        if (p->prevZ) {
+            p->prevZ->nextZ = p->nextZ;
+        }
+        if (p->nextZ) {
+            p->nextZ->prevZ = p->prevZ;
+        }
+    }
+
+    template <class T>
+    Node* linkedList(
+        const Point<T>* points,
+        std::size_t begin,
+        std::size_t end,
+        bool clockwise)
+    {
+        double sum = 0;
+        for (std::size_t i = begin, j = end - 1; i < end; j = i++) {
+            sum += (double(points[j].x) - points[i].x) *
+                (double(points[i].y) + points[j].y);
+        }
+
+        Node* last = nullptr;
+        if (clockwise == (sum > 0)) {
+            for (std::size_t i = begin; i < end; i++) {
+                last = insertNode(
+                    static_cast<std::uint32_t>(i), points[i].x, points[i].y,
+                    last);
+            }
+        } else {
+            for (std::size_t i = end; i-- > begin; ) {
+                last = insertNode(
+                    static_cast<std::uint32_t>(i), points[i].x, points[i].y,
+                    last);
+            }
+        }
+        if (last && equals(last, last->next)) {
+            removeNode(last);
+            last = last->next;
+        }
+        return last;
+    }
+
+    static Node* filterPoints(Node* start, Node* end = nullptr)
+    {
+        if (!start) {
+            return start;
+        }
+        if (!end) {
+            end = start;
+        }
+        Node* p = start;
+        bool again;
+        do {
+            again = false;
+            if (!p->steiner &&
+                    (equals(p, p->next) || area(p->prev, p, p->next) == 0)) {
+                removeNode(p);
+                p = end = p->prev;
+                if (p == p->next) {
+                    break;
+                }
+                again = true;
+            } else {
+                p = p->next;
+            }
+        } while (again || p != end);
+        return end;
+    }
+
+    void addTriangle(const Node* a, const Node* b, const Node* c)
+    {
+        _triangles->push_back(a->i);
+        _triangles->push_back(b->i);
+        _triangles->push_back(c->i);
+    }
+
+    void earcutLinked(Node* ear, int pass)
+    {
+        if (!ear) {
+            return;
+        }
+        if (pass == 0 && _hashed) {
+            indexCurve(ear);
+        }
+
+        Node* stop = ear;
+        while (ear->prev != ear->next) {
+            Node* prev = ear->prev;
+            Node* next = ear->next;
+            if (_hashed ? isEarHashed(ear) : isEar(ear)) {
+                addTriangle(prev, ear, next);
+                removeNode(ear);
+                ear = next->next;
+                stop = next->next;
+                continue;
+            }
+            ear = next;
+            if (ear == stop) {
+                if (pass == 0) {
+                    earcutLinked(filterPoints(ear), 1);
+                } else if (pass == 1) {
+                    ear = cureLocalIntersections(filterPoints(ear));
+                    earcutLinked(ear, 2);
+                } else {
+                    splitEarcut(ear);
+                }
+                break;
+            }
+        }
+    }
+
+    static bool isEar(Node* ear)
+    {
+        const Node* a = ear->prev;
+        const Node* b = ear;
+        const Node* c = ear->next;
+        if (area(a, b, c) >= 0) {
+            return false;
+        }
+        const double x0 = std::min({a->x, b->x, c->x});
+        const double y0 = std::min({a->y, b->y, c->y});
+        const double x1 = std::max({a->x, b->x, c->x});
+        const double y1 = std::max({a->y, b->y, c->y});
+        for (const Node* p = c->next; p != a; p = p->next) {
+            if (p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1 &&
+                    pointInTriangle(a, b, c, p) &&
+                    area(p->prev, p, p->next) >= 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool isEarHashed(Node* ear) const
+    {
+        const Node* a = ear->prev;
+        const Node* b = ear;
+        const Node* c = ear->next;
+        if (area(a, b, c) >= 0) {
+            return false;
+        }
+        const double x0 = std::min({a->x, b->x, c->x});
+        const double y0 = std::min({a->y, b->y, c->y});
+        const double x1 = std::max({a->x, b->x, c->x});
+        const double y1 = std::max({a->y, b->y, c->y});
+        const auto minZ = zOrder(x0, y0);
+        const auto maxZ = zOrder(x1, y1);
+
+        auto blocks = [&] (const Node* p) {
+            return p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1 &&
+                p != a && p != c && pointInTriangle(a, b, c, p) &&
+                area(p->prev, p, p->next) >= 0;
+        };
+
+        const Node* p = ear->prevZ;
+        const Node* n = ear->nextZ;
+        while (p && p->z >= minZ && n && n->z <= maxZ) {
+            if (blocks(p)) {
+                return false;
+            }
+            p = p->prevZ;
+            if (blocks(n)) {
+                return false;
+            }
+            n = n->nextZ;
+        }
+        for (; p && p->z >= minZ; p = p->prevZ) {
+            if (blocks(p)) {
+                return false;
+            }
+        }
+        for (; n && n->z <= maxZ; n = n->nextZ) {
+            if (blocks(n)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Node* cureLocalIntersections(Node* start)
+    {
+        Node* p = start;
+        do {
+            Node* a = p->prev;
+            Node* b = p->next->next;
+            if (!equals(a, b) && intersects(a, p, p->next, b) &&
+                    locallyInside(a, b) && locallyInside(b, a)) {
+                addTriangle(a, p, b);
+                removeNode(p);
+                removeNode(p->next);
+                p = start = b;
+            }
+            p = p->next;
+        } while (p != start);
+        return filterPoints(p);
+    }
+
+    void splitEarcut(Node* start)
+    {
+        Node* a = start;
+        do {
+            for (Node* b = a->next->next; b != a->prev; b = b->next) {
+                if (a->i != b->i && isValidDiagonal(a, b)) {
+                    Node* c = splitPolygon(a, b);
+                    a = filterPoints(a, a->next);
+                    c = filterPoints(c, c->next);
+                    earcutLinked(a, 0);
+                    earcutLinked(c, 0);
+                    return;
+                }
+            }
+            a = a->next;
+        } while (a != start);
+    }
+
+    template <class T>
+    Node* eliminateHoles(
+        const Point<T>* points,
+        std::size_t count,
+        const std::size_t* holeStarts,
+        std::size_t holeCount,
+        Node* outer)
+    {
+        std::vector<Node*> queue;
+        for (std::size_t i = 0; i < holeCount; i++) {
+            const std::size_t begin = holeStarts[i];
+            const std::size_t end =
+                i + 1 < holeCount ? holeStarts[i + 1] : count;
+            Node* list = linkedList(points, begin, end, false);
+            if (!list) {
+                continue;
+            }
+            if (list == list->next) {
+                list->steiner = true;
+            }
+            queue.push_back(leftmost(list));
+        }
+        std::sort(queue.begin(), queue.end(), [] (Node* a, Node* b) {
+            return a->x < b->x;
+        });
+        for (Node* hole : queue) {
+            outer = eliminateHole(hole, outer);
+        }
+        return outer;
+    }
+
+    Node* eliminateHole(Node* hole, Node* outer)
+    {
+        Node* bridge = findHoleBridge(hole, outer);
+        if (!bridge) {
+            return outer;
+        }
+        Node* bridgeReverse = splitPolygon(bridge, hole);
+        filterPoints(bridgeReverse, bridgeReverse->next);
+        return filterPoints(bridge, bridge->next);
+    }
+
+    // David Eberly's algorithm for finding a bridge between a hole and the
+    // outer polygon
+    static Node* findHoleBridge(Node* hole, Node* outer)
+    {
+        Node* p = outer;
+        const double hx = hole->x;
+        const double hy = hole->y;
+        double qx = -std::numeric_limits<double>::infinity();
+        Node* m = nullptr;
+
+        do {
+            if (hy <= p->y && hy >= p->next->y && p->next->y != p->y) {
+                const double x = p->x + (hy - p->y) *
+                    (p->next->x - p->x) / (p->next->y - p->y);
+                if (x <= hx && x > qx) {
+                    qx = x;
+                    m = p->x < p->next->x ? p : p->next;
+                    if (x == hx) {
+                        return m;
+                    }
+                }
+            }
+            p = p->next;
+        } while (p != outer);
+
+        if (!m) {
+            return nullptr;
+        }
+
+        const Node* stop = m;
+        const double mx = m->x;
+        const double my = m->y;
+        double tanMin = std::numeric_limits<double>::infinity();
+        p = m;
+        do {
+            if (hx >= p->x && p->x >= mx && hx != p->x &&
+                    pointInTriangle(
+                        hy < my ? hx : qx, hy, mx, my,
+                        hy < my ? qx : hx, hy, p->x, p->y)) {
+                const double tan = std::abs(hy - p->y) / (hx - p->x);
+                if (locallyInside(p, hole) &&
+                        (tan < tanMin || (tan == tanMin && (p->x > m->x ||
+                            (p->x == m->x && sectorContainsSector(m, p)))))) {
+                    m = p;
+                    tanMin = tan;
+                }
+            }
+            p = p->next;
+        } while (p != stop);
+        return m;
+    }
+
+    static bool sectorContainsSector(const Node* m, const Node* p)
+    {
+        return area(m->prev, m, p->prev) < 0 && area(p->next, m, m->next) < 0;
+    }
+
+    void indexCurve(Node* start) const
+    {
+        Node* p = start;
+        do {
+            if (p->z == 0) {
+                p->z = zOrder(p->x, p->y);
+            }
+            p->prevZ = p->prev;
+            p->nextZ = p->next;
+            p = p->next;
+        } while (p != start);
+        p->prevZ->nextZ = nullptr;
+        p->prevZ = nullptr;
+        sortLinked(p);
+    }
+
+    // Simon Tatham's linked list merge sort
+    static Node* sortLinked(Node* list)
+    {
+        std::size_t inSize = 1;
+        std::size_t merges;
+        do {
+            Node* p = list;
+            list = nullptr;
+            Node* tail = nullptr;
+            merges = 0;
+            while (p) {
+                merges++;
+                Node* q = p;
+                std::size_t pSize = 0;
+                for (std::size_t i = 0; i < inSize; i++) {
+                    pSize++;
+                    q = q->nextZ;
+                    if (!q) {
+                        break;
+                    }
+                }
+                std::size_t qSize = inSize;
+                while (pSize > 0 || (qSize > 0 && q)) {
+                    Node* e;
+                    if (pSize != 0 && (qSize == 0 || !q || p->z <= q->z)) {
+                        e = p;
+                        p = p->nextZ;
+                        pSize--;
+                    } else {
+                        e = q;
+                        q = q->nextZ;
+                        qSize--;
+                    }
+                    if (tail) {
+                        tail->nextZ = e;
+                    } else {
+                        list = e;
+                    }
+                    e->prevZ = tail;
+                    tail = e;
+                }
+                p = q;
+            }
+            tail->nextZ = nullptr;
+            inSize *= 2;
+        } while (merges > 1);
+        return list;
+    }
+
+    // z-order of a point, with coordinates scaled to 15 bits
+    std::int32_t zOrder(double px, double py) const
+    {
+        auto x = static_cast<std::uint32_t>((px - _minX) * _invSize);
+        auto y = static_cast<std::uint32_t>((py - _minY) * _invSize);
+        x = (x | (x << 8)) & 0x00FF00FF;
+        x = (x | (x << 4)) & 0x0F0F0F0F;
+        x = (x | (x << 2)) & 0x33333333;
+        x = (x | (x << 1)) & 0x55555555;
+        y = (y | (y << 8)) & 0x00FF00FF;
+        y = (y | (y << 4)) & 0x0F0F0F0F;
+        y = (y | (y << 2)) & 0x33333333;
+        y = (y | (y << 1)) & 0x55555555;
+        return static_cast<std::int32_t>(x | (y << 1));
+    }
+
+    static Node* leftmost(Node* start)
+    {
+        Node* p = start;
+        Node* result = start;
+        do {
+            if (p->x < result->x || (p->x == result->x && p->y < result->y)) {
+                result = p;
+            }
+            p = p->next;
+        } while (p != start);
+        return result;
+    }
+
+    static bool pointInTriangle(
+        double ax, double ay, double bx, double by, double cx, double cy,
+        double px, double py)
+    {
+        return (cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+            (ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+            (bx - px) * (cy - py) >= (cx - px) * (by - py);
+    }
+
+    static bool pointInTriangle(
+        const Node* a, const Node* b, const Node* c, const Node* p)
+    {
+        return pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y);
+    }
+
+    static bool isValidDiagonal(const Node* a, const Node* b)
+    {
+        return a->next->i != b->i && a->prev->i != b->i &&
+            !intersectsPolygon(a, b) &&
+            ((locallyInside(a, b) && locallyInside(b, a) &&
+                    middleInside(a, b) &&
+                    (area(a->prev, a, b->prev) != 0 ||
+                        area(a, b->prev, b) != 0)) ||
+                (equals(a, b) && area(a->prev, a, a->next) > 0 &&
+                    area(b->prev, b, b->next) > 0));
+    }
+
+    static double area(const Node* p, const Node* q, const Node* r)
+    {
+        return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+    }
+
+    static bool equals(const Node* a, const Node* b)
+    {
+        return a->x == b->x && a->y == b->y;
+    }
+
+    static int sign(double value)
+    {
+        return (value > 0) - (value < 0);
+    }
+
+    static bool onSegment(const Node* p, const Node* q, const Node* r)
+    {
+        return q->x <= std::max(p->x, r->x) && q->x >= std::min(p->x, r->x) &&
+            q->y <= std::max(p->y, r->y) && q->y >= std::min(p->y, r->y);
+    }
+
+    static bool intersects(
+        const Node* p1, const Node* q1, const Node* p2, const Node* q2)
+    {
+        const int o1 = sign(area(p1, q1, p2));
+        const int o2 = sign(area(p1, q1, q2));
+        const int o3 = sign(area(p2, q2, p1));
+        const int o4 = sign(area(p2, q2, q1));
+        return (o1 != o2 && o3 != o4) ||
+            (o1 == 0 && onSegment(p1, p2, q1)) ||
+            (o2 == 0 && onSegment(p1, q2, q1)) ||
+            (o3 == 0 && onSegment(p2, p1, q2)) ||
+            (o4 == 0 && onSegment(p2, q1, q2));
+    }
+
+    static bool intersectsPolygon(const Node* a, const Node* b)
+    {
+        const Node* p = a;
+        do {
+            if (p->i != a->i && p->next->i != a->i && p->i != b->i &&
+                    p->next->i != b->i && intersects(p, p->next, a, b)) {
+                return true;
+            }
+            p = p->next;
+        } while (p != a);
+        return false;
+    }
+
+    static bool locallyInside(const Node* a, const Node* b)
+    {
+        return area(a->prev, a, a->next) < 0 ?
+            area(a, b, a->next) >= 0 && area(a, a->prev, b) >= 0 :
+            area(a, b, a->prev) < 0 || area(a, a->next, b) < 0;
+    }
+
+    static bool middleInside(const Node* a, const Node* b)
+    {
+        const Node* p = a;
+        bool inside = false;
+        const double px = (a->x + b->x) / 2;
+        const double py = (a->y + b->y) / 2;
+        do {
+            if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y &&
+                    (px < (p->next->x - p->x) * (py - p->y) /
+                        (p->next->y - p->y) + p->x)) {
+                inside = !inside;
+            }
+            p = p->next;
+        } while (p != a);
+        return inside;
+    }
+
+    // Links a and b with a bridge, splitting the ring in two; returns the
+    // copy of b in the second ring.
+    Node* splitPolygon(Node* a, Node* b)
+    {
+        Node* a2 = &_nodes.emplace_back(a->i, a->x, a->y);
+        Node* b2 = &_nodes.emplace_back(b->i, b->x, b->y);
+        Node* an = a->next;
+        Node* bp = b->prev;
+        a->next = b;
+        b->prev = a;
+        a2->next = an;
+        an->prev = a2;
+        b2->next = a2;
+        a2->prev = b2;
+        bp->next = b2;
+        b2->prev = bp;
+        return b2;
+    }
+
+    std::deque<Node> _nodes;
+    std::vector<std::uint32_t>* _triangles = nullptr;
+    bool _hashed = false;
+    double _minX = 0;
+    double _minY = 0;
+    double _maxX = 0;
+    double _maxY = 0;
+    double _invSize = 0;
+};
+
+} // namespace detail::earcut
+
+// Ear clipping with z-order hashing; robust to degenerate input such as
+// touching or duplicate vertices and self-intersections.
+template <class T>
+void earcut(
+    const Point<T>* points,
+    std::size_t count,
+    const std::size_t* holeStarts,
+    std::size_t holeCount,
+    std::vector<std::uint32_t>& indices)
+{
+    detail::earcut::Earcut().run(
+        points, count, holeStarts, holeCount, indices);
+}
+
+namespace detail::monotone {
+
+// Sweep-line triangulation: the polygon is split into y-monotone pieces by
+// diagonals from split and merge vertices (de Berg et al., chapter 3), and
+// each piece is triangulated in linear time with a stack.
+
+struct Vertex {
+    double x;
+    double y;
+    std::uint32_t index;
+    std::uint32_t prev;
+    std::uint32_t next;
+};
+
+enum class VertexType : std::uint8_t {
+    Start,
+    End,
+    Split,
+    Merge,
+    Regular,
+};
+
+class Monotone {
+public:
+    // Returns false, leaving triangles as they were, if the rings turn out
+    // not to be simple: repeated vertices, or edges that cross.
+    template <class T>
+    bool run(
+        const Point<T>* points,
+        std::size_t count,
+        const std::size_t* holeStarts,
+        std::size_t holeCount,
+        std::vector<std::uint32_t>& triangles)
+    {
+        _vertices.clear();
+        _diagonals.clear();
+        _triangles = &triangles;
+        _ringCount = 0;
+        _area = 0;
+        _triangleArea = 0;
+
+        for (std::size_t ring = 0; ring <= holeCount; ring++) {
+            const std::size_t begin = ring == 0 ? 0 : holeStarts[ring - 1];
+            const std::size_t end = ring < holeCount ? holeStarts[ring] : count;
+            addRing(points, begin, end, ring == 0);
+        }
+        if (_vertices.size() < 3) {
+            return true;
+        }
+
+        const std::size_t firstIndex = triangles.size();
+        if (hasRepeatedVertices() || !partition() || !triangulateFaces() ||
+                !coversPolygon(firstIndex)) {
+            triangles.resize(firstIndex);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    // Appends a ring, dropping repeated and collinear points (including
+    // zero-width spikes) and orienting it so that the polygon interior lies
+    // to the left of its edges.
+    template <class T>
+    void addRing(
+        const Point<T>* points, std::size_t begin, std::size_t end, bool outer)
+    {
+        _ring.clear();
+        for (std::size_t i = begin; i < end; i++) {
+            const double x = points[i].x;
+            const double y = points[i].y;
+            if (!_ring.empty() && _ring.back().x == x && _ring.back().y == y) {
+                continue;
+            }
+            _ring.push_back({x, y, static_cast<std::uint32_t>(i), 0, 0});
+        }
+
+        auto straight = [] (
+                const Vertex& a, const Vertex& b, const Vertex& c) {
+            return (b.x - a.x) * (c.y - a.y) == (b.y - a.y) * (c.x - a.x);
+        };
+        bool changed = true;
+        while (changed && _ring.size() >= 3) {
+            changed = false;
+            _kept.clear();
+            for (std::size_t i = 0; i < _ring.size(); i++) {
+                const auto& prev = _kept.empty() ? _ring.back() : _kept.back();
+                const auto& next = _ring[(i + 1) % _ring.size()];
+                if (straight(prev, _ring[i], next)) {
+                    changed = true;
+                } else {
+                    _kept.push_back(_ring[i]);
+                }
+            }
+            _ring.swap(_kept);
+        }
+        if (_ring.size() < 3) {
+            return;
+        }
+
+        const std::size_t first = _vertices.size();
+        const std::size_t size = _ring.size();
+        _vertices.insert(_vertices.end(), _ring.begin(), _ring.end());
+        _ringCount++;
+
+        double area = 0;
+        for (std::size_t i = first, j = _vertices.size() - 1;
+                i < _vertices.size(); j = i++) {
+            area += (_vertices[j].x - _vertices[i].x) *
+                (_vertices[j].y + _vertices[i].y);
+        }
+        if ((area > 0) != outer) {
+            std::reverse(_vertices.begin() + first, _vertices.end());
+        }
+        _area += outer ? std::abs(area) / 2 : -std::abs(area) / 2;
+
+        for (std::size_t i = 0; i < size; i++) {
+            auto& vertex = _vertices[first + i];
+            vertex.prev = static_cast<std::uint32_t>(
+                first + (i + size - 1) % size);
+            vertex.next = static_cast<std::uint32_t>(first + (i + 1) % size);
+        }
+    }
+
+    // Sweep order: top to bottom, then left to right
+    bool above(std::uint32_t a, std::uint32_t b) const
+    {
+        const auto& va = _vertices[a];
+        const auto& vb = _vertices[b];
+        return va.y > vb.y || (va.y == vb.y && va.x < vb.x);
+    }
+
+    double cross(std::uint32_t a, std::uint32_t b, std::uint32_t c) const
+    {
+        const auto& va = _vertices[a];
+        const auto& vb = _vertices[b];
+        const auto& vc = _vertices[c];
+        return (vb.x - va.x) * (vc.y - va.y) - (vb.y - va.y) * (vc.x - va.x);
+    }
+
+    VertexType classify(std::uint32_t v) const
+    {
+        const auto prev = _vertices[v].prev;
+        const auto next = _vertices[v].next;
+        const bool prevBelow = above(v, prev);
+        const bool nextBelow = above(v, next);
+        const bool convex = cross(prev, v, next) > 0;
+        if (prevBelow && nextBelow) {
+            return convex ? VertexType::Start : VertexType::Split;
+        }
+        if (!prevBelow && !nextBelow) {
+            return convex ? VertexType::End : VertexType::Merge;
+        }
+        return VertexType::Regular;
+    }
+
+    // x coordinate of edge (e, next(e)) where it crosses the sweep line
+    double edgeX(std::uint32_t e) const
+    {
+        const auto& upper = _vertices[e];
+        const auto& lower = _vertices[upper.next];
+        if (upper.y == lower.y) {
+            return std::clamp(
+                _sweepX,
+                std::min(upper.x, lower.x),
+                std::max(upper.x, lower.x));
+        }
+        return upper.x +
+            (_sweepY - upper.y) * (lower.x - upper.x) / (lower.y - upper.y);
+    }
+
+    struct Probe {
+        double x;
+    };
+
+    struct EdgeLess {
+        using is_transparent = void;
+
+        bool operator()(std::uint32_t a, std::uint32_t b) const
+        {
+            const double xa = self->edgeX(a);
+            const double xb = self->edgeX(b);
+            if (xa != xb) {
+                return xa < xb;
+            }
+            // edges sharing a point are ordered by where they go below it
+            const auto& vertices = self->_vertices;
+            const double side =
+                self->cross(b, vertices[b].next, vertices[a].next);
+            if (side != 0) {
+                return side < 0;
+            }
+            return a < b;
+        }
+
+        bool operator()(std::uint32_t edge, Probe probe) const
+        {
+            return self->edgeX(edge) < probe.x;
+        }
+
+        bool operator()(Probe probe, std::uint32_t edge) const
+        {
+            return probe.x < self->edgeX(edge);
+        }
+
+        const Monotone* self;
+    };
+
+    using Status = std::set<std::uint32_t, EdgeLess>;
+
+    bool hasRepeatedVertices() const
+    {
+        std::vector<std::pair<double, double>> positions;
+        positions.reserve(_vertices.size());
+        for (const auto& vertex : _vertices) {
+            positions.emplace_back(vertex.x, vertex.y);
+        }
+        std::sort(positions.begin(), positions.end());
+        return std::adjacent_find(positions.begin(), positions.end()) !=
+            positions.end();
+    }
+
+    // Adds the diagonals splitting the polygon into monotone pieces.
+    // Returns false if the sweep finds the edges inconsistent, as happens
+    // when they cross.
+    bool partition()
+    {
+        const std::size_t size = _vertices.size();
+        std::vector<std::uint32_t> order(size);
+        std::vector<VertexType> types(size);
+        for (std::uint32_t v = 0; v < size; v++) {
+            order[v] = v;
+            types[v] = classify(v);
+        }
+        std::sort(order.begin(), order.end(), [this] (auto a, auto b) {
+            return above(a, b);
+        });
+
+        Status status(EdgeLess{this});
+        std::vector<typename Status::iterator> positions(size, status.end());
+        std::vector<std::uint32_t> helpers(size);
+
+        auto insert = [&] (std::uint32_t edge, std::uint32_t helper) {
+            positions[edge] = status.insert(edge).first;
+            helpers[edge] = helper;
+        };
+        auto erase = [&] (std::uint32_t edge) {
+            if (positions[edge] == status.end()) {
+                return false;
+            }
+            status.erase(positions[edge]);
+            positions[edge] = status.end();
+            return true;
+        };
+        auto connectMergeHelper = [&] (std::uint32_t edge, std::uint32_t v) {
+            if (types[helpers[edge]] == VertexType::Merge) {
+                _diagonals.emplace_back(v, helpers[edge]);
+            }
+        };
+        // the edge left of v, or noEdge if there is none
+        constexpr auto noEdge = std::numeric_limits<std::uint32_t>::max();
+        auto leftEdge = [&] (std::uint32_t v) {
+            auto it = status.lower_bound(Probe{_vertices[v].x});
+            return it == status.begin() ? noEdge : *--it;
+        };
+
+        for (const auto v : order) {
+            _sweepX = _vertices[v].x;
+            _sweepY = _vertices[v].y;
+            const auto prev = _vertices[v].prev;
+
+            switch (types[v]) {
+                case VertexType::Start:
+                    insert(v, v);
+                    break;
+                case VertexType::End:
+                    connectMergeHelper(prev, v);
+                    if (!erase(prev)) {
+                        return false;
+                    }
+                    break;
+                case VertexType::Split: {
+                    const auto left = leftEdge(v);
+                    if (left == noEdge) {
+                        return false;
+                    }
+                    _diagonals.emplace_back(v, helpers[left]);
+                    helpers[left] = v;
+                    insert(v, v);
+                    break;
+                }
+                case VertexType::Merge: {
+                    connectMergeHelper(prev, v);
+                    if (!erase(prev)) {
+                        return false;
+                    }
+                    const auto left = leftEdge(v);
+                    if (left == noEdge) {
+                        return false;
+                    }
+                    connectMergeHelper(left, v);
+                    helpers[left] = v;
+                    break;
+                }
+                case VertexType::Regular:
+                    if (above(prev, v)) {
+                        connectMergeHelper(prev, v);
+                        if (!erase(prev)) {
+                            return false;
+                        }
+                        insert(v, v);
+                    } else {
+                        const auto left = leftEdge(v);
+                        if (left == noEdge) {
+                            return false;
+                        }
+                        connectMergeHelper(left, v);
+                        helpers[left] = v;
+                    }
+                    break;
+            }
+        }
+        return status.empty();
+    }
+
+    // Walks the faces of the polygon subdivided by the diagonals, and
+    // triangulates each of them. Returns false if the faces do not close,
+    // as happens for inconsistent diagonals.
+    bool triangulateFaces()
+    {
+        const std::size_t size = _vertices.size();
+
+        // outgoing half-edges per vertex, in compressed row storage
+        std::vector<std::uint32_t> offsets(size + 1, 1);
+        offsets[size] = 0;
+        for (const auto& [a, b] : _diagonals) {
+            offsets[a]++;
+            offsets[b]++;
+        }
+        std::uint32_t total = 0;
+        for (std::size_t v = 0; v <= size; v++) {
+            total += std::exchange(offsets[v], total);
+        }
+        std::vector<std::uint32_t> targets(total);
+        std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (std::uint32_t v = 0; v < size; v++) {
+            targets[fill[v]++] = _vertices[v].next;
+        }
+        for (const auto& [a, b] : _diagonals) {
+            targets[fill[a]++] = b;
+            targets[fill[b]++] = a;
+        }
+
+        auto angle = [this] (std::uint32_t from, std::uint32_t to) {
+            return std::atan2(
+                _vertices[to].y - _vertices[from].y,
+                _vertices[to].x - _vertices[from].x);
+        };
+
+        // The face to the left of (u, v) continues along the first outgoing
+        // half-edge of v clockwise from (v, u).
+        auto nextHalfEdge = [&] (std::uint32_t u, std::uint32_t v) {
+            const std::uint32_t begin = offsets[v];
+            const std::uint32_t end = offsets[v + 1];
+            if (end - begin == 1) {
+                return begin;
+            }
+            constexpr double turn = 2 * 3.14159265358979323846;
+            const double back = angle(v, u);
+            std::uint32_t best = begin;
+            double bestDelta = turn + 1;
+            for (std::uint32_t h = begin; h < end; h++) {
+                double delta = back - angle(v, targets[h]);
+                if (delta <= 0) {
+                    delta += turn;
+                }
+                if (delta < bestDelta) {
+                    best = h;
+                    bestDelta = delta;
+                }
+            }
+            return best;
+        };
+
+        std::vector<std::uint32_t> origins(total);
+        for (std::uint32_t v = 0; v < size; v++) {
+            for (auto h = offsets[v]; h < offsets[v + 1]; h++) {
+                origins[h] = v;
+            }
+        }
+
+        std::vector<bool> used(total, false);
+        std::vector<std::uint32_t> face;
+        for (std::uint32_t start = 0; start < total; start++) {
+            if (used[start]) {
+                continue;
+            }
+            face.clear();
+            auto h = start;
+            do {
+                if (used[h]) {
+                    return false;
+                }
+                used[h] = true;
+                face.push_back(origins[h]);
+                h = nextHalfEdge(origins[h], targets[h]);
+            } while (h != start);
+            triangulateMonotone(face);
+        }
+        return true;
+    }
+
+    // Whether the triangles from firstIndex on tile the polygon: as many as
+    // a triangulation has, covering its area without overlaps.
+    bool coversPolygon(std::size_t firstIndex) const
+    {
+        const std::size_t count = (_triangles->size() - firstIndex) / 3;
+        if (count + 2 != _vertices.size() + 2 * (_ringCount - 1)) {
+            return false;
+        }
+        return std::abs(_triangleArea - _area) <=
+            1e-9 * std::max(_triangleArea, _area);
+    }
+
+    void addTriangle(std::uint32_t a, std::uint32_t b, std::uint32_t c)
+    {
+        const double doubleArea = cross(a, b, c);
+        if (doubleArea < 0) {
+            std::swap(b, c);
+        }
+        _triangleArea += std::abs(doubleArea) / 2;
+        _triangles->push_back(_vertices[a].index);
+        _triangles->push_back(_vertices[b].index);
+        _triangles->push_back(_vertices[c].index);
+    }
+
+    // Triangulates a y-monotone polygon given in counterclockwise order
+    void triangulateMonotone(const std::vector<std::uint32_t>& face)
+    {
+        const std::size_t size = face.size();
+        if (size < 3) {
+            return;
+        }
+        if (size == 3) {
+            addTriangle(face[0], face[1], face[2]);
+            return;
+        }
+
+        std::size_t top = 0;
+        std::size_t bottom = 0;
+        for (std::size_t i = 1; i < size; i++) {
+            if (above(face[i], face[top])) {
+                top = i;
+            }
+            if (above(face[bottom], face[i])) {
+                bottom = i;
+            }
+        }
+
+        // Going forward from the top descends the left chain, going backward
+        // descends the right one; merge both into sweep order.
+        _sorted.clear();
+        _sorted.push_back({face[top], true});
+        std::size_t left = (top + 1) % size;
+        std::size_t right = (top + size - 1) % size;
+        while (left != bottom || right != bottom) {
+            if (right == bottom ||
+                    (left != bottom && above(face[left], face[right]))) {
+                _sorted.push_back({face[left], true});
+                left = (left + 1) % size;
+            } else {
+                _sorted.push_back({face[right], false});
+                right = (right + size - 1) % size;
+            }
+        }
+        _sorted.push_back({face[bottom], true});
+
+        _stack.clear();
+        _stack.push_back(_sorted[0]);
+        _stack.push_back(_sorted[1]);
+        for (std::size_t j = 2; j + 1 < size; j++) {
+            const auto current = _sorted[j];
+            if (current.second != _stack.back().second) {
+                for (std::size_t k = 0; k + 1 < _stack.size(); k++) {
+                    addTriangle(
+                        current.first, _stack[k].first, _stack[k + 1].first);
+                }
+                _stack.clear();
+                _stack.push_back(_sorted[j - 1]);
+                _stack.push_back(current);
+            } else {
+                auto last = _stack.back();
+                _stack.pop_back();
+                while (!_stack.empty()) {
+                    const double turn = cross(
+                        _stack.back().first, last.first, current.first);
+                    if (current.second ? turn <= 0 : turn >= 0) {
+                        break;
+                    }
+                    addTriangle(
+                        current.first, last.first, _stack.back().first);
+                    last = _stack.back();
+                    _stack.pop_back();
+                }
+                _stack.push_back(last);
+                _stack.push_back(current);
+            }
+        }
+        for (std::size_t k = 0; k + 1 < _stack.size(); k++) {
+            addTriangle(
+                _sorted.back().first, _stack[k].first, _stack[k + 1].first);
+        }
+    }
+
+    std::vector<Vertex> _vertices;
+    std::vector<Vertex> _ring;
+    std::vector<Vertex> _kept;
+    std::size_t _ringCount = 0;
+    double _area = 0;
+    double _triangleArea = 0;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> _diagonals;
+    std::vector<std::pair<std::uint32_t, bool>> _sorted;
+    std::vector<std::pair<std::uint32_t, bool>> _stack;
+    std::vector<std::uint32_t>* _triangles = nullptr;
+    double _sweepX = 0;
+    double _sweepY = 0;
+};
+
+} // namespace detail::monotone
+
+// Monotone partition followed by linear-time triangulation of each piece;
+// O(n log n) regardless of shape. Rings must be simple and must not touch
+// each other; collinear points are dropped. Returns false, appending
+// nothing, if the rings repeat a vertex or the result does not tile the
+// polygon, as happens when edges cross.
+template <class T>
+bool monotoneTriangulate(
+    const Point<T>* points,
+    std::size_t count,
+    const std::size_t* holeStarts,
+    std::size_t holeCount,
+    std::vector<std::uint32_t>& indices)
+{
+    return detail::monotone::Monotone().run(
+        points, count, holeStarts, holeCount, indices);
+}
+
+// Vertex count above which triangulate() switches to the sweep-line method
+inline constexpr std::size_t monotoneThreshold = 1024;
+
+// Ear clipping for small polygons, where it is fastest; sweep-line partition
+// for large ones, where ear clipping may degrade to quadratic time. Large
+// rings the sweep rejects as not simple fall back to ear clipping, which
+// tolerates them.
+template <class T>
+void triangulate(
+    const Point<T>* points,
+    std::size_t count,
+    const std::size_t* holeStarts,
+    std::size_t holeCount,
+    std::vector<std::uint32_t>& indices)
+{
+    if (count < monotoneThreshold ||
+            !monotoneTriangulate(
+                points, count, holeStarts, holeCount, indices)) {
+        earcut(points, count, holeStarts, holeCount, indices);
+    }
+}
+
+} // namespace ecosnail::flat
@@ -1,252 +1,336 @@
 #pragma once
 
-#include <cassert>
+#include <ecosnail/flat/coordinates.hpp>
+
 #include <cmath>
 #include <cstddef>
 #include <functional>
+#include <ostream>
 #include <tuple>
 #include <type_traits>
 #include <utility>
 
 namespace ecosnail::flat {
 
-template <class T>
-struct Vector {
+template <class T, std::size_t N = 2>
+struct Vector : detail::Coordinates<T, N> {
+    static constexpr std::size_t size = N;
+
     // construction
 
-    Vector()
-        : x{}, y{}
-    { }
+    // leaves components uninitialized, like Point(); Vector{} is zero
+    Vector() = default;
 
-    Vector(T x, T y)
-        : x(std::move(x)), y(std::move(y))
+    template <
+        class... Us,
+        class = std::enable_if_t<
+            sizeof...(Us) == N && detail::allConvertible<T, Us...>>>
+    Vector(Us... values)
+        : detail::Coordinates<T, N>{T(std::move(values))...}
     { }
 
     // implicit conversions
 
     template <class U, class = std::enable_if_t<std::is_convertible_v<U, T>>>
-    Vector(const Vector<U>& rhs)
-        : x(rhs.x), y(rhs.y)
+    Vector(const Vector<U, N>& rhs)
+        : Vector(rhs, std::make_index_sequence<N>{})
     { }
 
     template <class U, class = std::enable_if_t<std::is_convertible_v<U, T>>>
-    Vector(Vector<U>&& rhs)
-        : x(std::move(rhs.x)), y(std::move(rhs.y))
+    Vector(Vector<U, N>&& rhs)
+        : Vector(std::move(rhs), std::make_index_sequence<N>{})
     { }
 
     // assignment
 
     template <class U, class = std::enable_if_t<std::is_convertible_v<U, T>>>
-    Vector& operator=(const Vector<U>& rhs)
+    Vector& operator=(const Vector<U, N>& rhs)
     {
-        x = rhs.x;
-        y = rhs.y;
+        detail::unroll<N>([&] (auto i) {
+            detail::component<i>(*this) = detail::component<i>(rhs);
+        });
         return *this;
     }
 
     template <class U, class = std::enable_if_t<std::is_convertible_v<U, T>>>
-    Vector& operator=(const Vector<U>&& rhs)
+    Vector& operator=(Vector<U, N>&& rhs)
     {
-        x = std::move(rhs.x);
-        y = std::move(rhs.y);
+        detail::unroll<N>([&] (auto i) {
+            detail::component<i>(*this) =
+                std::move(detail::component<i>(rhs));
+        });
         return *this;
     }
 
-    // array subscript operator
-
-    T& operator[](std::size_t idx)
-    {
-        assert(idx < 2);
-        static const T Vector::* ptrs[] {&Vector::x, &Vector::y};
-        return this->*ptrs[idx];
-    }
-
-    const T& operator[](std::size_t idx) const
-    {
-        assert(idx < 2);
-        static const T Vector::* ptrs[] {&Vector::x, &Vector::y};
-        return this->*ptrs[idx];
-    }
-
     // arithmetic operators
 
     template <class U, class = std::enable_if_t<std::is_convertible_v<U, T>>>
-    Vector& operator+=(const Vector<U>& rhs)
+    Vector& operator+=(const Vector<U, N>& rhs)
     {
-        x += rhs.x;
-        y += rhs.y;
+        detail::unroll<N>([&] (auto i) {
+            detail::component<i>(*this) += detail::component<i>(rhs);
+        });
         return *this;
     }
 
     template <class U, class = std::enable_if_t<std::is_convertible_v<U, T>>>
-    Vector& operator-=(const Vector<U>& rhs)
+    Vector& operator-=(const Vector<U, N>& rhs)
     {
-        x -= rhs.x;
-        y -= rhs.y;
+        detail::unroll<N>([&] (auto i) {
+            detail::component<i>(*this) -= detail::component<i>(rhs);
+        });
         return *this;
     }
 
     template <class U, class = std::enable_if_t<std::is_convertible_v<U, T>>>
     Vector& operator*=(const U& scalar)
     {
-        x *= scalar;
-        y *= scalar;
+        detail::unroll<N>([&] (auto i) {
+            detail::component<i>(*this) *= scalar;
+        });
         return *this;
     }
 
     template <class U, class = std::enable_if_t<std::is_convertible_v<U, T>>>
     Vector& operator/=(const U& scalar)
     {
-        x /= scalar;
-        y /= scalar;
+        detail::unroll<N>([&] (auto i) {
+            detail::component<i>(*this) /= scalar;
+        });
         return *this;
     }
 
-    T x;
-    T y;
+private:
+    template <class V, std::size_t... I>
+    Vector(V&& rhs, std::index_sequence<I...>)
+        : detail::Coordinates<T, N>{
+            T(detail::component<I>(std::forward<V>(rhs)))...}
+    { }
 };
 
+template <class T>
+using Vector2 = Vector<T, 2>;
+
+// Padded to four components for arithmetic T (see coordinatesAlignment())
+template <class T>
+using Vector3 = Vector<T, 3>;
+
+template <class T>
+using Vector4 = Vector<T, 4>;
+
+// component access
+
+template <std::size_t I, class T, std::size_t N>
+constexpr T& get(Vector<T, N>& v)
+{
+    return detail::component<I>(v);
+}
+
+template <std::size_t I, class T, std::size_t N>
+constexpr const T& get(const Vector<T, N>& v)
+{
+    return detail::component<I>(v);
+}
+
+template <std::size_t I, class T, std::size_t N>
+constexpr T&& get(Vector<T, N>&& v)
+{
+    return detail::component<I>(std::move(v));
+}
+
 // arithmetic operators
 
-template <class L, class R>
-auto operator+(const Vector<L>& lhs, const Vector<R>& rhs)
+template <class L, class R, std::size_t N>
+auto operator+(const Vector<L, N>& lhs, const Vector<R, N>& rhs)
 {
-    return Vector<std::common_type_t<L, R>>{lhs.x + rhs.x, lhs.y + rhs.y};
+    return detail::generate<Vector, std::common_type_t<L, R>, N>(
+        [&] (auto i) { return get<i>(lhs) + get<i>(rhs); });
 }
 
-template <class L, class R>
-auto operator-(const Vector<L>& lhs, const Vector<R>& rhs)
+template <class L, class R, std::size_t N>
+auto operator-(const Vector<L, N>& lhs, const Vector<R, N>& rhs)
 {
-    return Vector<std::common_type_t<L, R>>{lhs.x - rhs.x, lhs.y - rhs.y};
-};
+    return detail::generate<Vector, std::common_type_t<L, R>, N>(
+        [&] (auto i) { return get<i>(lhs) - get<i>(rhs); });
+}
+
+template <class T, std::size_t N>
+Vector<T, N> operator-(const Vector<T, N>& vector)
+{
+    return detail::generate<Vector, T, N>(
+        [&] (auto i) { return -get<i>(vector); });
+}
 
-template <class T, class U>
-auto operator*(const Vector<T>& vector, const U& scalar)
+template <class T, std::size_t N, class U>
+auto operator*(const Vector<T, N>& vector, const U& scalar)
 {
-    return Vector<std::common_type_t<T, U>>{
-        vector.x * scalar, vector.y * scalar};
+    return detail::generate<Vector, std::common_type_t<T, U>, N>(
+        [&] (auto i) { return get<i>(vector) * scalar; });
 }
 
-template <class T, class U>
-Vector<std::common_type_t<T, U>> operator*(
-    const U& scalar, const Vector<T>& vector)
+template <class T, std::size_t N, class U>
+auto operator*(const U& scalar, const Vector<T, N>& vector)
 {
     return vector * scalar;
 }
 
-template <class T, class U>
-auto operator/(const Vector<T>& vector, const U& scalar)
+template <class T, std::size_t N, class U>
+auto operator/(const Vector<T, N>& vector, const U& scalar)
 {
-    return Vector<std::common_type_t<T, U>>{
-        vector.x / scalar, vector.y / scalar};
+    return detail::generate<Vector, std::common_type_t<T, U>, N>(
+        [&] (auto i) { return get<i>(vector) / scalar; });
 }
 
 // relational operators
 
-template <class T>
-bool operator==(const Vector<T>& lhs, const Vector<T>& rhs)
+template <class T, std::size_t N>
+auto operator==(const Vector<T, N>& lhs, const Vector<T, N>& rhs)
 {
-    return lhs.x == rhs.x && lhs.y == rhs.y;
+    return detail::all<N>([&] (auto i) { return get<i>(lhs) == get<i>(rhs); });
 }
 
-template <class T>
-bool operator!=(const Vector<T>& lhs, const Vector<T>& rhs)
+template <class T, std::size_t N>
+auto operator!=(const Vector<T, N>& lhs, const Vector<T, N>& rhs)
 {
     return !(lhs == rhs);
 }
 
-template <class T>
-bool operator<=(const Vector<T>& lhs, const Vector<T>& rhs)
+template <class T, std::size_t N>
+auto operator<=(const Vector<T, N>& lhs, const Vector<T, N>& rhs)
 {
-    return lhs.x <= rhs.x && lhs.y <= rhs.y;
+    return detail::all<N>([&] (auto i) { return get<i>(lhs) <= get<i>(rhs); });
 }
 
-template <class T>
-bool operator>=(const Vector<T>& lhs, const Vector<T>& rhs)
+template <class T, std::size_t N>
+auto operator>=(const Vector<T, N>& lhs, const Vector<T, N>& rhs)
 {
     return rhs <= lhs;
 }
 
-template <class T>
-bool operator<(const Vector<T>& lhs, const Vector<T>& rhs)
+template <class T, std::size_t N>
+auto operator<(const Vector<T, N>& lhs, const Vector<T, N>& rhs)
 {
     return lhs <= rhs && lhs != rhs;
 }
 
-template <class T>
-bool operator>(const Vector<T>& lhs, const Vector<T>& rhs)
+template <class T, std::size_t N>
+auto operator>(const Vector<T, N>& lhs, const Vector<T, N>& rhs)
 {
     return rhs < lhs;
 }
 
 // geometry functions
 
-template <class T>
-T length(const Vector<T>& v)
+template <class L, class R, std::size_t N>
+auto dot(const Vector<L, N>& lhs, const Vector<R, N>& rhs)
 {
-    return std::sqrt(v.x * v.x + v.y * v.y);
+    return detail::sum<N>([&] (auto i) { return get<i>(lhs) * get<i>(rhs); });
 }
 
-template <class T>
-Vector<T> normalized(const Vector<T>& v)
+template <class T, std::size_t N>
+T squaredLength(const Vector<T, N>& v)
+{
+    return dot(v, v);
+}
+
+template <class T, std::size_t N>
+T length(const Vector<T, N>& v)
+{
+    using std::sqrt;
+    return sqrt(squaredLength(v));
+}
+
+template <class T, std::size_t N>
+Vector<T, N> normalized(const Vector<T, N>& v)
 {
     auto l = length(v);
-    if (l == 0) {
-        return {};
+    if constexpr (detail::isPacket<T>) {
+        // zero-length lanes stay zero instead of turning into NaN
+        auto zero = l == 0;
+        auto inverse = T{1} / detail::select(zero, T{1}, l);
+        return v * detail::select(zero, T{}, inverse);
     } else {
-        return v / l;
+        if (l == 0) {
+            return {};
+        } else {
+            return v / l;
+        }
     }
 }
 
+template <class L, class R>
+auto cross(const Vector<L, 3>& lhs, const Vector<R, 3>& rhs)
+{
+    return Vector<std::common_type_t<L, R>, 3>{
+        lhs.y * rhs.z - lhs.z * rhs.y,
+        lhs.z * rhs.x - lhs.x * rhs.z,
+        lhs.x * rhs.y - lhs.y * rhs.x};
+}
+
 // stream output
 
-template <class T>
-std::ostream& operator<<(std::ostream& output, const Vector<T>& vector)
+template <class T, std::size_t N>
+std::ostream& operator<<(std::ostream& output, const Vector<T, N>& vector)
 {
-    return output << vector.x << ", " << vector.y;
+    detail::unroll<N>([&] (auto i) {
+        if constexpr (i > 0) {
+            output << ", ";
+        }
+        output << get<i>(vector);
+    });
+    return output;
 }
 
 } // namespace ecosnail::flat
 
 namespace std {
 
-template <class T>
-struct less<ecosnail::flat::Vector<T>> {
+template <class T, std::size_t N>
+struct tuple_size<ecosnail::flat::Vector<T, N>>
+    : integral_constant<size_t, N> { };
+
+template <size_t I, class T, std::size_t N>
+struct tuple_element<I, ecosnail::flat::Vector<T, N>> {
+    using type = T;
+};
+
+template <class T, std::size_t N>
+struct less<ecosnail::flat::Vector<T, N>> {
     constexpr bool operator()(
-        const ecosnail::flat::Vector<T>& lhs,
-        const ecosnail::flat::Vector<T>& rhs)
+        const ecosnail::flat::Vector<T, N>& lhs,
+        const ecosnail::flat::Vector<T, N>& rhs) const
     {
-        return std::tie(lhs.x, lhs.y) < std::tie(rhs.x, rhs.y);
+        return ecosnail::flat::detail::lexicographicalLess<N>(lhs, rhs);
     }
 };
 
-template <class T>
-struct greater<ecosnail::flat::Vector<T>> {
+template <class T, std::size_t N>
+struct greater<ecosnail::flat::Vector<T, N>> {
     constexpr bool operator()(
-        const ecosnail::flat::Vector<T>& lhs,
-        const ecosnail::flat::Vector<T>& rhs)
+        const ecosnail::flat::Vector<T, N>& lhs,
+        const ecosnail::flat::Vector<T, N>& rhs) const
     {
-        return less<ecosnail::flat::Vector<T>>(rhs, lhs)();
+        return less<ecosnail::flat::Vector<T, N>>{}(rhs, lhs);
     }
 };
 
-template <class T>
-struct less_equal<ecosnail::flat::Vector<T>> {
+template <class T, std::size_t N>
+struct less_equal<ecosnail::flat::Vector<T, N>> {
     constexpr bool operator()(
-        const ecosnail::flat::Vector<T>& lhs,
-        const ecosnail::flat::Vector<T>& rhs)
+        const ecosnail::flat::Vector<T, N>& lhs,
+        const ecosnail::flat::Vector<T, N>& rhs) const
     {
-        return !greater<ecosnail::flat::Vector<T>>(lhs, rhs);
+        return !greater<ecosnail::flat::Vector<T, N>>{}(lhs, rhs);
     }
 };
 
-template <class T>
-struct greater_equal<ecosnail::flat::Vector<T>> {
+template <class T, std::size_t N>
+struct greater_equal<ecosnail::flat::Vector<T, N>> {
     constexpr bool operator()(
-        const ecosnail::flat::Vector<T>& lhs,
-        const ecosnail::flat::Vector<T>& rhs)
+        const ecosnail::flat::Vector<T, N>& lhs,
+        const ecosnail::flat::Vector<T, N>& rhs) const
     {
-        return !less<ecosnail::flat::Vector<T>>(lhs, rhs);
+        return !less<ecosnail::flat::Vector<T, N>>{}(lhs, rhs);
     }
 };
 
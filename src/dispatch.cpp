@@ -0,0 +1,194 @@
+#include <ecosnail/flat/dispatch.hpp>
+
+#include "kernels.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+namespace ecosnail::flat::dispatch {
+
+namespace {
+
+const Kernels& kernelsFor(Target target)
+{
+    switch (target) {
+#ifdef ECOSNAIL_FLAT_X86_TARGETS
+        case Target::Avx2: return avx2::kernels;
+        case Target::Avx512: return avx512::kernels;
+#endif
+        default: return generic::kernels;
+    }
+}
+
+Target detectTarget()
+{
+    for (auto target : {Target::Avx512, Target::Avx2}) {
+        if (isSupported(target)) {
+            return target;
+        }
+    }
+    return Target::Generic;
+}
+
+// Resolved on first use rather than during dynamic initialization, so that
+// kernels may be called from the static initializers of other translation
+// units. Kernel tables are constant, so relaxed ordering is enough.
+constexpr int unresolved = -1;
+std::atomic<int> activeTarget {unresolved};
+
+Target resolvedTarget()
+{
+    int target = activeTarget.load(std::memory_order_relaxed);
+    if (target == unresolved) {
+        const int detected = static_cast<int>(detectTarget());
+        // a concurrent setTarget() or resolution wins
+        target = unresolved;
+        if (activeTarget.compare_exchange_strong(
+                target, detected, std::memory_order_relaxed)) {
+            target = detected;
+        }
+    }
+    return static_cast<Target>(target);
+}
+
+const Kernels& active()
+{
+    return kernelsFor(resolvedTarget());
+}
+
+} // namespace
+
+bool isSupported(Target target)
+{
+#ifdef ECOSNAIL_FLAT_X86_TARGETS
+    // may run from static initialization, before libgcc has done it
+    __builtin_cpu_init();
+#endif
+    switch (target) {
+        case Target::Generic:
+            return true;
+#ifdef ECOSNAIL_FLAT_X86_TARGETS
+        case Target::Avx2:
+            return __builtin_cpu_supports("avx2") &&
+                __builtin_cpu_supports("fma");
+        case Target::Avx512:
+            return __builtin_cpu_supports("avx512f") &&
+                __builtin_cpu_supports("avx512vl") &&
+                __builtin_cpu_supports("avx512dq");
+#endif
+        default:
+            return false;
+    }
+}
+
+Target bestTarget()
+{
+    return detectTarget();
+}
+
+void setTarget(Target target)
+{
+    if (!isSupported(target)) {
+        throw std::invalid_argument(
+            std::string{"target not supported by this CPU: "} + name(target));
+    }
+    activeTarget.store(static_cast<int>(target), std::memory_order_relaxed);
+}
+
+Target currentTarget()
+{
+    return resolvedTarget();
+}
+
+const char* name(Target target)
+{
+    switch (target) {
+        case Target::Generic: return "generic";
+        case Target::Avx2: return "avx2";
+        case Target::Avx512: return "avx512";
+    }
+    return "unknown";
+}
+
+void length(const Vector<float>* vectors, std::size_t count, float* out)
+{
+    active().lengthFloat(vectors, count, out);
+}
+
+void length(const Vector<double>* vectors, std::size_t count, double* out)
+{
+    active().lengthDouble(vectors, count, out);
+}
+
+void normalize(Vector<float>* vectors, std::size_t count)
+{
+    active().normalizeFloat(vectors, count);
+}
+
+void normalize(Vector<double>* vectors, std::size_t count)
+{
+    active().normalizeDouble(vectors, count);
+}
+
+void distance(
+    const Point<float>* lhs,
+    const Point<float>* rhs,
+    std::size_t count,
+    float* out)
+{
+    active().distanceFloat(lhs, rhs, count, out);
+}
+
+void distance(
+    const Point<double>* lhs,
+    const Point<double>* rhs,
+    std::size_t count,
+    double* out)
+{
+    active().distanceDouble(lhs, rhs, count, out);
+}
+
+std::size_t compactIndices(
+    const std::uint8_t* flags, std::size_t count, std::uint32_t* indices)
+{
+    return active().compactIndices(flags, count, indices);
+}
+
+std::size_t compact(
+    const float* values,
+    const std::uint8_t* flags,
+    std::size_t count,
+    float* out)
+{
+    return active().compactFloat(values, flags, count, out);
+}
+
+std::size_t compact(
+    const double* values,
+    const std::uint8_t* flags,
+    std::size_t count,
+    double* out)
+{
+    return active().compactDouble(values, flags, count, out);
+}
+
+std::size_t compact(
+    const Point<float>* points,
+    const std::uint8_t* flags,
+    std::size_t count,
+    Point<float>* out)
+{
+    return active().compactPointFloat(points, flags, count, out);
+}
+
+std::size_t compact(
+    const Point<double>* points,
+    const std::uint8_t* flags,
+    std::size_t count,
+    Point<double>* out)
+{
+    return active().compactPointDouble(points, flags, count, out);
+}
+
+} // namespace ecosnail::flat::dispatch
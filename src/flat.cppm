@@ -0,0 +1,246 @@
+module;
+
+#include <ecosnail/flat.hpp>
+#include <ecosnail/flat/batch.hpp>
+#include <ecosnail/flat/box.hpp>
+#include <ecosnail/flat/buffer.hpp>
+#include <ecosnail/flat/clustering.hpp>
+#include <ecosnail/flat/compaction.hpp>
+#include <ecosnail/flat/culling.hpp>
+#include <ecosnail/flat/curves.hpp>
+#include <ecosnail/flat/distances.hpp>
+#include <ecosnail/flat/enclosing.hpp>
+#include <ecosnail/flat/geodesic.hpp>
+#include <ecosnail/flat/grid.hpp>
+#include <ecosnail/flat/layout.hpp>
+#include <ecosnail/flat/numa.hpp>
+#include <ecosnail/flat/parallel.hpp>
+#include <ecosnail/flat/pipeline.hpp>
+#include <ecosnail/flat/projection.hpp>
+#include <ecosnail/flat/sampling.hpp>
+#include <ecosnail/flat/snapshot.hpp>
+#include <ecosnail/flat/stroke.hpp>
+#include <ecosnail/flat/tracked.hpp>
+#include <ecosnail/flat/triangulation.hpp>
+
+#if __has_include(<sys/mman.h>)
+    #include <ecosnail/flat/reader.hpp>
+    #include <ecosnail/flat/tiles.hpp>
+#endif
+
+#if __has_include(<experimental/simd>)
+    #include <ecosnail/flat/simd.hpp>
+#endif
+
+#ifdef ECOSNAIL_FLAT_WITH_DISPATCH
+    #include <ecosnail/flat/dispatch.hpp>
+#endif
+
+export module ecosnail.flat;
+
+// The public API of every header included above; names added to the
+// headers must be exported here too.
+
+export namespace ecosnail::flat {
+
+using ecosnail::flat::Point;
+using ecosnail::flat::Point2;
+using ecosnail::flat::Point3;
+using ecosnail::flat::Point4;
+using ecosnail::flat::Vector;
+using ecosnail::flat::Vector2;
+using ecosnail::flat::Vector3;
+using ecosnail::flat::Vector4;
+
+using ecosnail::flat::get;
+
+using ecosnail::flat::operator+;
+using ecosnail::flat::operator-;
+using ecosnail::flat::operator*;
+using ecosnail::flat::operator/;
+using ecosnail::flat::operator==;
+using ecosnail::flat::operator!=;
+using ecosnail::flat::operator<=;
+using ecosnail::flat::operator>=;
+using ecosnail::flat::operator<;
+using ecosnail::flat::operator>;
+using ecosnail::flat::operator<<;
+
+using ecosnail::flat::cross;
+using ecosnail::flat::dot;
+using ecosnail::flat::length;
+using ecosnail::flat::normalized;
+using ecosnail::flat::squaredLength;
+
+using ecosnail::flat::fromCoordinates;
+using ecosnail::flat::toCoordinates;
+
+using ecosnail::flat::hardwareThreads;
+using ecosnail::flat::parallelFor;
+
+using ecosnail::flat::BoundedQueue;
+using ecosnail::flat::Pipeline;
+
+using ecosnail::flat::DefaultInitAllocator;
+using ecosnail::flat::UninitializedBuffer;
+using ecosnail::flat::UninitializedPointBuffer;
+
+using ecosnail::flat::NumaBuffer;
+using ecosnail::flat::NumaPlacement;
+using ecosnail::flat::NumaPointBuffer;
+
+using ecosnail::flat::earthRadius;
+using ecosnail::flat::fromEquirectangular;
+using ecosnail::flat::fromWebMercator;
+using ecosnail::flat::lonLatToTile;
+using ecosnail::flat::maxMercatorLatitude;
+using ecosnail::flat::tileToLonLat;
+using ecosnail::flat::toEquirectangular;
+using ecosnail::flat::toWebMercator;
+
+using ecosnail::flat::haversineDistance;
+using ecosnail::flat::meanEarthRadius;
+using ecosnail::flat::vincentyDistance;
+
+namespace wgs84 {
+using ecosnail::flat::wgs84::flattening;
+using ecosnail::flat::wgs84::semiMajorAxis;
+using ecosnail::flat::wgs84::semiMinorAxis;
+} // namespace wgs84
+
+using ecosnail::flat::GridIndex;
+using ecosnail::flat::ConcurrentGrid;
+
+using ecosnail::flat::dbscan;
+using ecosnail::flat::kMeans;
+using ecosnail::flat::KMeansResult;
+using ecosnail::flat::noise;
+
+using ecosnail::flat::CellReduction;
+using ecosnail::flat::gridDownsample;
+using ecosnail::flat::poissonDiskSample;
+using ecosnail::flat::poissonDiskSubsample;
+
+using ecosnail::flat::ArcLengthTable;
+using ecosnail::flat::bSplineSegment;
+using ecosnail::flat::catmullRomSegment;
+using ecosnail::flat::CubicBezier;
+using ecosnail::flat::flatten;
+using ecosnail::flat::flattenCatmullRom;
+using ecosnail::flat::maxSegmentCount;
+using ecosnail::flat::QuadraticBezier;
+using ecosnail::flat::segmentCount;
+
+using ecosnail::flat::LineCap;
+using ecosnail::flat::LineJoin;
+using ecosnail::flat::StrokeSize;
+using ecosnail::flat::strokePolyline;
+using ecosnail::flat::strokeSize;
+using ecosnail::flat::StrokeStyle;
+using ecosnail::flat::StrokeVertex;
+
+using ecosnail::flat::earcut;
+using ecosnail::flat::monotoneThreshold;
+using ecosnail::flat::monotoneTriangulate;
+using ecosnail::flat::triangulate;
+
+using ecosnail::flat::Circle;
+using ecosnail::flat::convexHull;
+using ecosnail::flat::diameter;
+using ecosnail::flat::HullMetrics;
+using ecosnail::flat::minimumAreaRectangle;
+using ecosnail::flat::minimumEnclosingCircle;
+using ecosnail::flat::OrientedRectangle;
+using ecosnail::flat::width;
+
+using ecosnail::flat::minimumAreaBox;
+using ecosnail::flat::OrientedBox;
+using ecosnail::flat::orientedBox;
+using ecosnail::flat::overlaps;
+using ecosnail::flat::principalAxesBox;
+
+using ecosnail::flat::contains;
+using ecosnail::flat::cull;
+using ecosnail::flat::intersects;
+using ecosnail::flat::Rectangle;
+
+using ecosnail::flat::filter;
+using ecosnail::flat::filterIndices;
+using ecosnail::flat::partitionCopy;
+
+using ecosnail::flat::TrackedPoints;
+
+using ecosnail::flat::SnapshotBuffer;
+
+#if __has_include(<sys/mman.h>)
+using ecosnail::flat::buildTilePyramid;
+using ecosnail::flat::TilePyramid;
+using ecosnail::flat::TilePyramidOptions;
+
+using ecosnail::flat::PointFileReader;
+using ecosnail::flat::PointReader;
+using ecosnail::flat::ReadBackend;
+#endif
+
+#if __has_include(<experimental/simd>)
+using ecosnail::flat::loadAos;
+using ecosnail::flat::loadSoa;
+using ecosnail::flat::simd;
+using ecosnail::flat::simdMask;
+using ecosnail::flat::storeAos;
+using ecosnail::flat::storeSoa;
+#endif
+
+namespace batch {
+using ecosnail::flat::batch::distance;
+using ecosnail::flat::batch::dot;
+using ecosnail::flat::batch::length;
+using ecosnail::flat::batch::normalize;
+using ecosnail::flat::batch::scale;
+using ecosnail::flat::batch::translate;
+
+using ecosnail::flat::batch::fromEquirectangular;
+using ecosnail::flat::batch::fromWebMercator;
+using ecosnail::flat::batch::lonLatToTile;
+using ecosnail::flat::batch::tileToLonLat;
+using ecosnail::flat::batch::toEquirectangular;
+using ecosnail::flat::batch::toWebMercator;
+
+using ecosnail::flat::batch::haversineDistance;
+using ecosnail::flat::batch::haversineDistanceMatrix;
+using ecosnail::flat::batch::vincentyDistance;
+using ecosnail::flat::batch::vincentyDistanceMatrix;
+
+using ecosnail::flat::batch::distanceMatrix;
+using ecosnail::flat::batch::nearest;
+using ecosnail::flat::batch::squaredDistanceMatrix;
+
+using ecosnail::flat::batch::evaluate;
+
+using ecosnail::flat::batch::stroke;
+using ecosnail::flat::batch::strokeOffsets;
+
+using ecosnail::flat::batch::hullMetrics;
+using ecosnail::flat::batch::minimumEnclosingCircle;
+
+using ecosnail::flat::batch::overlaps;
+using ecosnail::flat::batch::principalAxesBox;
+} // namespace batch
+
+#ifdef ECOSNAIL_FLAT_WITH_DISPATCH
+namespace dispatch {
+using ecosnail::flat::dispatch::bestTarget;
+using ecosnail::flat::dispatch::compact;
+using ecosnail::flat::dispatch::compactIndices;
+using ecosnail::flat::dispatch::currentTarget;
+using ecosnail::flat::dispatch::distance;
+using ecosnail::flat::dispatch::isSupported;
+using ecosnail::flat::dispatch::length;
+using ecosnail::flat::dispatch::name;
+using ecosnail::flat::dispatch::normalize;
+using ecosnail::flat::dispatch::setTarget;
+using ecosnail::flat::dispatch::Target;
+} // namespace dispatch
+#endif
+
+} // namespace ecosnail::flat
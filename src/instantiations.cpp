@@ -0,0 +1,2 @@
+#define ECOSNAIL_FLAT_INSTANTIATION_DEFINITIONS
+#include <ecosnail/flat/instantiations.hpp>
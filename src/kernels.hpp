@@ -0,0 +1,47 @@
+#pragma once
+
+#include <ecosnail/flat/point.hpp>
+#include <ecosnail/flat/vector.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ecosnail::flat::dispatch {
+
+struct Kernels {
+    void (*lengthFloat)(const Vector<float>*, std::size_t, float*);
+    void (*lengthDouble)(const Vector<double>*, std::size_t, double*);
+    void (*normalizeFloat)(Vector<float>*, std::size_t);
+    void (*normalizeDouble)(Vector<double>*, std::size_t);
+    void (*distanceFloat)(
+        const Point<float>*, const Point<float>*, std::size_t, float*);
+    void (*distanceDouble)(
+        const Point<double>*, const Point<double>*, std::size_t, double*);
+    std::size_t (*compactIndices)(
+        const std::uint8_t*, std::size_t, std::uint32_t*);
+    std::size_t (*compactFloat)(
+        const float*, const std::uint8_t*, std::size_t, float*);
+    std::size_t (*compactDouble)(
+        const double*, const std::uint8_t*, std::size_t, double*);
+    std::size_t (*compactPointFloat)(
+        const Point<float>*, const std::uint8_t*, std::size_t, Point<float>*);
+    std::size_t (*compactPointDouble)(
+        const Point<double>*,
+        const std::uint8_t*,
+        std::size_t,
+        Point<double>*);
+};
+
+namespace generic {
+extern const Kernels kernels;
+} // namespace generic
+
+namespace avx2 {
+extern const Kernels kernels;
+} // namespace avx2
+
+namespace avx512 {
+extern const Kernels kernels;
+} // namespace avx512
+
+} // namespace ecosnail::flat::dispatch
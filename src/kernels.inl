@@ -0,0 +1,277 @@
+// Kernel bodies, included once per target by kernels_<target>.cpp with
+// ECOSNAIL_FLAT_TARGET set to the target namespace.
+//
+// Every translation unit including this file is compiled with different
+// instruction set flags. Any inline function or template shared with other
+// translation units may be merged by the linker into a single copy, built
+// for an arbitrary target, so the kernels only touch coordinate members
+// directly and keep all their helpers inside the target namespace.
+
+#include "kernels.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+namespace ecosnail::flat::dispatch::ECOSNAIL_FLAT_TARGET {
+
+namespace {
+
+// std::sqrt itself is an inline function shared with other translation units
+#ifdef __GNUC__
+float squareRoot(float x) { return __builtin_sqrtf(x); }
+double squareRoot(double x) { return __builtin_sqrt(x); }
+#else
+float squareRoot(float x) { return std::sqrt(x); }
+double squareRoot(double x) { return std::sqrt(x); }
+#endif
+
+template <class T>
+void length(const Vector<T>* vectors, std::size_t count, T* out)
+{
+    for (std::size_t i = 0; i < count; i++) {
+        const T x = vectors[i].x;
+        const T y = vectors[i].y;
+        out[i] = squareRoot(x * x + y * y);
+    }
+}
+
+template <class T>
+void normalize(Vector<T>* vectors, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; i++) {
+        const T x = vectors[i].x;
+        const T y = vectors[i].y;
+        const T l = squareRoot(x * x + y * y);
+        const T factor = l == 0 ? T{0} : T{1} / l;
+        vectors[i].x = x * factor;
+        vectors[i].y = y * factor;
+    }
+}
+
+template <class T>
+void distance(
+    const Point<T>* lhs, const Point<T>* rhs, std::size_t count, T* out)
+{
+    for (std::size_t i = 0; i < count; i++) {
+        const T dx = lhs[i].x - rhs[i].x;
+        const T dy = lhs[i].y - rhs[i].y;
+        out[i] = squareRoot(dx * dx + dy * dy);
+    }
+}
+
+// Stream compaction from byte flags. Elements are handled as groups of
+// 32-bit lanes, with the mask of kept elements spread over their lanes, so
+// one loop serves indices, scalars and points:
+//
+//   * AVX-512 compresses each vector with vpcompressd;
+//   * AVX2 permutes each vector with vpermd, taking the permutation for its
+//     8-bit mask from a table.
+//
+// Whole vectors are stored at the current output position, which never
+// runs ahead of the input position, so outputs only need to hold count
+// elements.
+
+#if defined(__AVX2__)
+
+// Bit i set for each nonzero flag among 32
+std::uint32_t flagMask(const std::uint8_t* flags)
+{
+    const __m256i bytes =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(flags));
+    const __m256i zero =
+        _mm256_cmpeq_epi8(bytes, _mm256_setzero_si256());
+    return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(zero));
+}
+
+// Repeats each bit of a mask of Elements bits over the lanes of its element
+template <std::size_t Lanes, std::size_t Elements>
+std::uint32_t spread(std::uint32_t bits)
+{
+    if constexpr (Lanes == 1) {
+        return bits;
+    } else {
+        std::uint32_t result = 0;
+        for (std::size_t i = 0; i < Elements; i++) {
+            result |= ((bits >> i) & 1u) * ((1u << Lanes) - 1) << (i * Lanes);
+        }
+        return result;
+    }
+}
+
+#endif
+
+#if defined(__AVX2__) && !defined(__AVX512F__)
+
+struct Permutations {
+    alignas(32) std::uint32_t lanes[256][8];
+};
+
+// For each 8-bit mask, the indices of its set bits, first to last
+constexpr Permutations makePermutations()
+{
+    Permutations permutations {};
+    for (std::uint32_t mask = 0; mask < 256; mask++) {
+        std::uint32_t size = 0;
+        for (std::uint32_t lane = 0; lane < 8; lane++) {
+            if (mask >> lane & 1u) {
+                permutations.lanes[mask][size++] = lane;
+            }
+        }
+    }
+    return permutations;
+}
+
+constexpr Permutations permutations = makePermutations();
+
+#endif
+
+#if defined(__AVX2__)
+
+// Kept elements of a vector of 32-bit lanes, packed to the front
+template <std::size_t Lanes>
+struct Compressor {
+#if defined(__AVX512F__)
+    using Vector = __m512i;
+    static constexpr std::size_t width = 16;
+
+    static Vector load(const void* source)
+    {
+        return _mm512_loadu_si512(source);
+    }
+
+    static void compressTo(void* target, Vector values, std::uint32_t mask)
+    {
+        const auto lanes = static_cast<__mmask16>(spread<Lanes, width / Lanes>(mask));
+        _mm512_storeu_si512(
+            target, _mm512_maskz_compress_epi32(lanes, values));
+    }
+
+    static Vector iota(std::uint32_t first)
+    {
+        return _mm512_add_epi32(
+            _mm512_set1_epi32(static_cast<int>(first)),
+            _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+                8, 9, 10, 11, 12, 13, 14, 15));
+    }
+#else
+    using Vector = __m256i;
+    static constexpr std::size_t width = 8;
+
+    static Vector load(const void* source)
+    {
+        return _mm256_loadu_si256(static_cast<const __m256i*>(source));
+    }
+
+    static void compressTo(void* target, Vector values, std::uint32_t mask)
+    {
+        const __m256i permutation = _mm256_load_si256(
+            reinterpret_cast<const __m256i*>(
+                permutations.lanes[spread<Lanes, width / Lanes>(mask)]));
+        _mm256_storeu_si256(
+            static_cast<__m256i*>(target),
+            _mm256_permutevar8x32_epi32(values, permutation));
+    }
+
+    static Vector iota(std::uint32_t first)
+    {
+        return _mm256_add_epi32(
+            _mm256_set1_epi32(static_cast<int>(first)),
+            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    }
+#endif
+};
+
+// Applies f(i, mask) to each vector of elements starting at i, with the
+// kept elements in mask, and counts them into size. Returns where the
+// scalar tail starts.
+template <std::size_t Lanes, class F>
+std::size_t forEachVector(
+    const std::uint8_t* flags, std::size_t count, std::size_t& size, F&& f)
+{
+    constexpr std::size_t perVector = Compressor<Lanes>::width / Lanes;
+    constexpr std::uint32_t vectorMask =
+        static_cast<std::uint32_t>((std::uint64_t{1} << perVector) - 1);
+
+    std::size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const std::uint32_t mask = flagMask(flags + i);
+        if (mask == 0) {
+            continue;
+        }
+        for (std::size_t j = 0; j < 32; j += perVector) {
+            const std::uint32_t part = mask >> j & vectorMask;
+            f(i + j, part);
+            size += static_cast<std::size_t>(__builtin_popcount(part));
+        }
+    }
+    return i;
+}
+
+#endif
+
+std::size_t compactIndices(
+    const std::uint8_t* flags, std::size_t count, std::uint32_t* indices)
+{
+    std::size_t size = 0;
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    i = forEachVector<1>(flags, count, size,
+        [&] (std::size_t first, std::uint32_t mask) {
+            Compressor<1>::compressTo(
+                indices + size,
+                Compressor<1>::iota(static_cast<std::uint32_t>(first)),
+                mask);
+        });
+#endif
+    for (; i < count; i++) {
+        indices[size] = static_cast<std::uint32_t>(i);
+        size += flags[i] != 0;
+    }
+    return size;
+}
+
+template <class V>
+std::size_t compact(
+    const V* values, const std::uint8_t* flags, std::size_t count, V* out)
+{
+    static_assert(sizeof(V) % 4 == 0 && sizeof(V) <= 16);
+
+    std::size_t size = 0;
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    constexpr std::size_t lanes = sizeof(V) / 4;
+    i = forEachVector<lanes>(flags, count, size,
+        [&] (std::size_t first, std::uint32_t mask) {
+            Compressor<lanes>::compressTo(
+                out + size, Compressor<lanes>::load(values + first), mask);
+        });
+#endif
+    for (; i < count; i++) {
+        out[size] = values[i];
+        size += flags[i] != 0;
+    }
+    return size;
+}
+
+} // namespace
+
+extern const Kernels kernels {
+    length<float>,
+    length<double>,
+    normalize<float>,
+    normalize<double>,
+    distance<float>,
+    distance<double>,
+    compactIndices,
+    compact<float>,
+    compact<double>,
+    compact<Point<float>>,
+    compact<Point<double>>,
+};
+
+} // namespace ecosnail::flat::dispatch::ECOSNAIL_FLAT_TARGET
@@ -0,0 +1,2 @@
+#define ECOSNAIL_FLAT_TARGET avx2
+#include "kernels.inl"
@@ -0,0 +1,2 @@
+#define ECOSNAIL_FLAT_TARGET avx512
+#include "kernels.inl"
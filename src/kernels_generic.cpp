@@ -0,0 +1,2 @@
+#define ECOSNAIL_FLAT_TARGET generic
+#include "kernels.inl"
@@ -0,0 +1,324 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/box.hpp>
+#include <ecosnail/flat/fastmath.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+template <std::size_t N>
+using Box = OrientedBox<double, N>;
+
+// Axes orthonormal, and every point within the box
+template <std::size_t N>
+void checkBox(const Box<N>& box, const std::vector<Point<double, N>>& points)
+{
+    const double tolerance = 1e-9;
+    for (std::size_t i = 0; i < N; i++) {
+        for (std::size_t j = 0; j < N; j++) {
+            CHECK_NEAR(dot(box.axes[i], box.axes[j]), i == j, tolerance);
+        }
+        CHECK(box.halfExtents[i] >= 0);
+    }
+    double scale = 1;
+    for (const auto& point : points) {
+        for (std::size_t d = 0; d < N; d++) {
+            scale = std::max(scale, std::abs(point[d]));
+        }
+    }
+    for (const auto& point : points) {
+        const auto offset = point - box.center;
+        for (std::size_t d = 0; d < N; d++) {
+            CHECK(std::abs(dot(offset, box.axes[d])) <=
+                box.halfExtents[d] + tolerance * scale);
+        }
+    }
+}
+
+template <std::size_t N>
+double volume(const Box<N>& box)
+{
+    double result = 1;
+    for (std::size_t d = 0; d < N; d++) {
+        result *= 2 * box.halfExtents[d];
+    }
+    return result;
+}
+
+// Points spread by `spreads` along the axes of a rotation, shifted far from
+// the origin
+template <std::size_t N>
+std::vector<Point<double, N>> cloud(
+    std::mt19937& random,
+    std::size_t count,
+    const double (&spreads)[N],
+    double angle,
+    double shift)
+{
+    std::normal_distribution<double> gaussian(0, 1);
+    std::vector<Point<double, N>> points(count);
+    for (auto& point : points) {
+        double local[N];
+        for (std::size_t d = 0; d < N; d++) {
+            local[d] = gaussian(random) * spreads[d];
+        }
+        // rotate in the plane of the first two axes
+        point[0] = std::cos(angle) * local[0] - std::sin(angle) * local[1];
+        point[1] = std::sin(angle) * local[0] + std::cos(angle) * local[1];
+        for (std::size_t d = 2; d < N; d++) {
+            point[d] = local[d];
+        }
+        for (std::size_t d = 0; d < N; d++) {
+            point[d] += shift;
+        }
+    }
+    return points;
+}
+
+// Both fits contain every point; the principal axis follows the elongation,
+// and the calipers box is never larger than the principal one.
+void testFits()
+{
+    std::mt19937 random(29);
+    std::uniform_real_distribution<double> angles(0, 2 * detail::pi);
+    for (int round = 0; round < 100; round++) {
+        const double angle = angles(random);
+        const double shift = round % 2 ? 1e4 : 0;
+        const std::size_t count = 1 + round * 7 % 300;
+
+        const auto points = cloud<2>(random, count, {10, 1}, angle, shift);
+        const auto principal = principalAxesBox(points.data(), count);
+        checkBox(principal, points);
+        if (count > 100) {
+            const double alignment = std::abs(dot(
+                principal.axes[0],
+                Vector<double>{std::cos(angle), std::sin(angle)}));
+            CHECK(alignment > 0.99);
+        }
+
+        std::vector<Point<double>> scratch(count);
+        const auto minimum =
+            minimumAreaBox(points.data(), count, scratch.data());
+        checkBox(minimum, points);
+        CHECK(volume(minimum) <= volume(principal) * (1 + 1e-9) + 1e-9);
+
+        const auto solid = cloud<3>(random, count, {1, 8, 3}, angle, shift);
+        checkBox(principalAxesBox(solid.data(), count), solid);
+    }
+}
+
+void testDegenerate()
+{
+    const std::vector<Point<double>> single = {{3, -2}};
+    const auto point = principalAxesBox(single.data(), 1);
+    checkBox(point, single);
+    CHECK(point.center == single[0]);
+    CHECK(point.halfExtents == Vector<double>{0, 0});
+
+    std::vector<Point<double>> line;
+    for (int i = 0; i < 50; i++) {
+        line.push_back({1 + 3.0 * i, 2 - 4.0 * i});
+        line.push_back({1 + 3.0 * i, 2 - 4.0 * i});
+    }
+    const auto principal = principalAxesBox(line.data(), line.size());
+    checkBox(principal, line);
+    CHECK_NEAR(principal.halfExtents[0], 5 * 49 / 2.0, 1e-9);
+    CHECK_NEAR(principal.halfExtents[1], 0, 1e-9);
+
+    std::vector<Point<double>> scratch(line.size());
+    const auto minimum =
+        minimumAreaBox(line.data(), line.size(), scratch.data());
+    checkBox(minimum, line);
+    CHECK_NEAR(volume(minimum), 0, 1e-9);
+
+    const auto empty = principalAxesBox<double, 2>(nullptr, 0);
+    CHECK(empty.halfExtents == Vector<double>{0, 0});
+}
+
+template <std::size_t N>
+Box<N> axisAligned(const Point<double, N>& center, double halfExtent)
+{
+    Box<N> box {};
+    box.center = center;
+    for (std::size_t d = 0; d < N; d++) {
+        box.axes[d][d] = 1;
+        box.halfExtents[d] = halfExtent;
+    }
+    return box;
+}
+
+Box<2> rotated(const Point<double>& center, double angle, double a, double b)
+{
+    const Vector<double> axis{std::cos(angle), std::sin(angle)};
+    return {center, {axis, Vector<double>{-axis.y, axis.x}}, {a, b}};
+}
+
+void testKnownPairs()
+{
+    const auto unit = axisAligned<2>({0, 0}, 1);
+    CHECK(overlaps(unit, axisAligned<2>({1.5, 0.5}, 1)));
+    CHECK(overlaps(unit, axisAligned<2>({0, 0}, 0.25)));
+    CHECK(!overlaps(unit, axisAligned<2>({2.5, 0}, 1)));
+    CHECK(!overlaps(unit, axisAligned<2>({0, -2.01}, 1)));
+
+    // boxes touching along an edge or at a corner count as overlapping
+    CHECK(overlaps(unit, axisAligned<2>({2, 0}, 1)));
+    CHECK(overlaps(unit, axisAligned<2>({2, 2}, 1)));
+
+    // a diamond beside the corner: only its own axes separate the boxes
+    const auto near = rotated({1.5, 1.5}, detail::pi / 4, 0.9, 0.9);
+    const auto far = rotated({2, 2}, detail::pi / 4, 0.9, 0.9);
+    CHECK(overlaps(unit, near));
+    CHECK(!overlaps(unit, far));
+    CHECK(!overlaps(far, unit));
+
+    // Unit cubes turned to put an edge along x on top of one and an edge
+    // along y under the other: stacked, they are separated only along z,
+    // the cross product of the two edges.
+    const double s = std::sqrt(0.5);
+    Box<3> lower {};
+    lower.axes[0] = {1, 0, 0};
+    lower.axes[1] = {0, s, s};
+    lower.axes[2] = {0, -s, s};
+    lower.halfExtents = {1, 1, 1};
+    Box<3> upper {};
+    upper.axes[0] = {0, 1, 0};
+    upper.axes[1] = {s, 0, s};
+    upper.axes[2] = {-s, 0, s};
+    upper.halfExtents = {1, 1, 1};
+    upper.center = {0, 0, 3.2};
+    CHECK(!overlaps(lower, upper));
+    CHECK(!overlaps(upper, lower));
+    upper.center = {0, 0, 2.7};
+    CHECK(overlaps(lower, upper));
+    CHECK(overlaps(upper, lower));
+    CHECK(overlaps(lower, lower));
+}
+
+// Separation by projecting the corners of both boxes on every candidate
+// axis, as a reference for the rotation-matrix form of the tests
+template <std::size_t N>
+std::vector<Point<double, N>> corners(const Box<N>& box)
+{
+    std::vector<Point<double, N>> result;
+    for (std::size_t mask = 0; mask < (std::size_t{1} << N); mask++) {
+        auto corner = box.center;
+        for (std::size_t d = 0; d < N; d++) {
+            const double sign = (mask >> d) & 1 ? 1 : -1;
+            corner += box.axes[d] * (sign * box.halfExtents[d]);
+        }
+        result.push_back(corner);
+    }
+    return result;
+}
+
+template <std::size_t N>
+bool bruteOverlaps(const Box<N>& a, const Box<N>& b)
+{
+    std::vector<Vector<double, N>> axes;
+    for (std::size_t d = 0; d < N; d++) {
+        axes.push_back(a.axes[d]);
+        axes.push_back(b.axes[d]);
+    }
+    if constexpr (N == 3) {
+        for (std::size_t i = 0; i < 3; i++) {
+            for (std::size_t j = 0; j < 3; j++) {
+                const auto axis = cross(a.axes[i], b.axes[j]);
+                if (squaredLength(axis) > 1e-12) {
+                    axes.push_back(axis);
+                }
+            }
+        }
+    }
+    const auto aCorners = corners(a);
+    const auto bCorners = corners(b);
+    for (const auto& axis : axes) {
+        auto range = [&] (const std::vector<Point<double, N>>& points,
+                double& low, double& high) {
+            low = std::numeric_limits<double>::infinity();
+            high = -low;
+            for (const auto& point : points) {
+                const double projection = dot(point - Point<double, N>{}, axis);
+                low = std::min(low, projection);
+                high = std::max(high, projection);
+            }
+        };
+        double aLow, aHigh, bLow, bHigh;
+        range(aCorners, aLow, aHigh);
+        range(bCorners, bLow, bHigh);
+        if (aHigh < bLow || bHigh < aLow) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <std::size_t N>
+Box<N> randomBox(std::mt19937& random)
+{
+    std::uniform_real_distribution<double> coordinate(-3, 3);
+    std::uniform_real_distribution<double> extent(0.1, 1.5);
+    std::normal_distribution<double> gaussian(0, 1);
+
+    // orthonormal axes from random vectors by Gram-Schmidt
+    Box<N> box {};
+    for (std::size_t d = 0; d < N; d++) {
+        Vector<double, N> axis;
+        for (std::size_t k = 0; k < N; k++) {
+            axis[k] = gaussian(random);
+        }
+        for (std::size_t e = 0; e < d; e++) {
+            axis -= box.axes[e] * dot(axis, box.axes[e]);
+        }
+        box.axes[d] = normalized(axis);
+        box.center[d] = coordinate(random);
+        box.halfExtents[d] = extent(random);
+    }
+    return box;
+}
+
+template <std::size_t N>
+void testRandomPairs()
+{
+    std::mt19937 random(31);
+    std::vector<Box<N>> boxes;
+    for (int i = 0; i < 200; i++) {
+        boxes.push_back(randomBox<N>(random));
+    }
+    const auto query = randomBox<N>(random);
+    const std::unique_ptr<bool[]> results(new bool[boxes.size()]);
+    batch::overlaps(boxes.data(), boxes.size(), query, results.get());
+
+    std::size_t overlapping = 0;
+    for (std::size_t i = 0; i < boxes.size(); i++) {
+        const bool expected = bruteOverlaps(query, boxes[i]);
+        CHECK(overlaps(query, boxes[i]) == expected);
+        CHECK(overlaps(boxes[i], query) == expected);
+        CHECK(results[i] == expected);
+        overlapping += expected;
+    }
+    // both outcomes are exercised
+    CHECK(overlapping > 0);
+    CHECK(overlapping < boxes.size());
+}
+
+} // namespace
+
+int main()
+{
+    testFits();
+    testDegenerate();
+    testKnownPairs();
+    testRandomPairs<2>();
+    testRandomPairs<3>();
+    return test::exitCode();
+}
@@ -0,0 +1,184 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/buffer.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+static_assert(std::is_same_v<
+    std::allocator_traits<DefaultInitAllocator<int>>::rebind_alloc<double>,
+    DefaultInitAllocator<double, std::allocator<double>>>);
+
+template <class T>
+bool isAligned(const T* pointer, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;
+}
+
+// Writes and reads back every element
+template <class T>
+void fillAndCheck(UninitializedBuffer<T>& buffer)
+{
+    for (std::size_t i = 0; i < buffer.size(); i++) {
+        buffer[i] = T(i % 1000);
+    }
+    bool same = true;
+    std::size_t i = 0;
+    for (const auto& value : buffer) {
+        same = same && value == T(i++ % 1000);
+    }
+    CHECK(same);
+    CHECK(i == buffer.size());
+}
+
+void testSizes()
+{
+    UninitializedBuffer<float> empty;
+    CHECK(empty.empty());
+    CHECK(empty.size() == 0);
+    CHECK(empty.data() == nullptr);
+    CHECK(empty.begin() == empty.end());
+
+    UninitializedBuffer<float> zero(0);
+    CHECK(zero.empty());
+    CHECK(zero.data() == nullptr);
+
+    for (bool firstTouch : {true, false}) {
+        UninitializedBuffer<double> one(1, firstTouch);
+        CHECK(one.size() == 1);
+        CHECK(isAligned(one.data(), detail::smallPageSize));
+        fillAndCheck(one);
+
+        UninitializedBuffer<float> small(1000, firstTouch);
+        CHECK(!small.empty());
+        CHECK(small.end() - small.begin() == 1000);
+        fillAndCheck(small);
+    }
+
+    // just past a huge page, so the mapping is aligned to huge pages
+    const std::size_t count = detail::hugePageSize / sizeof(float) + 1;
+    UninitializedBuffer<float> large(count);
+    CHECK(large.size() == count);
+    CHECK(isAligned(large.data(), detail::hugePageSize));
+    fillAndCheck(large);
+
+    UninitializedPointBuffer<float> points(detail::hugePageSize);
+    points[points.size() - 1] = {1, 2};
+    CHECK((points[points.size() - 1] == Point<float>{1, 2}));
+}
+
+// Sizes whose byte count does not fit in std::size_t are rejected instead
+// of wrapping around to a small mapping
+void testOverflow()
+{
+    const std::size_t max = std::numeric_limits<std::size_t>::max();
+    for (std::size_t size : {max, max / sizeof(double) + 1,
+            max / sizeof(double)}) {
+        bool thrown = false;
+        try {
+            UninitializedBuffer<double> buffer(size);
+        } catch (const std::bad_alloc&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+    }
+}
+
+void testMove()
+{
+    UninitializedBuffer<int> buffer(500);
+    fillAndCheck(buffer);
+    const int* data = buffer.data();
+
+    UninitializedBuffer<int> moved(std::move(buffer));
+    CHECK(moved.data() == data);
+    CHECK(moved.size() == 500);
+    CHECK(buffer.empty());
+    CHECK(buffer.data() == nullptr);
+
+    UninitializedBuffer<int> assigned(10);
+    assigned = std::move(moved);
+    CHECK(assigned.data() == data);
+    CHECK(assigned.size() == 500);
+    CHECK(moved.empty());
+    fillAndCheck(assigned);
+
+    // assigning to itself keeps the memory
+    auto& alias = assigned;
+    assigned = std::move(alias);
+    CHECK(assigned.data() == data);
+    CHECK(assigned.size() == 500);
+
+    // moved-from buffers can be reused
+    buffer = UninitializedBuffer<int>(20);
+    CHECK(buffer.size() == 20);
+    fillAndCheck(buffer);
+}
+
+struct Counted {
+    static inline int defaults = 0;
+
+    Counted()
+    {
+        defaults++;
+    }
+
+    explicit Counted(int v)
+        : value(v)
+    { }
+
+    int value = -1;
+};
+
+// Default construction goes through the element's default constructor, and
+// constructor arguments are passed on
+void testAllocator()
+{
+    std::vector<Counted, DefaultInitAllocator<Counted>> counted(5);
+    CHECK(Counted::defaults == 5);
+    counted.emplace_back(42);
+    CHECK(Counted::defaults == 5);
+    CHECK(counted.back().value == 42);
+    CHECK(counted.front().value == -1);
+
+    std::vector<int, DefaultInitAllocator<int>> values(100, 7);
+    bool sevens = true;
+    for (int value : values) {
+        sevens = sevens && value == 7;
+    }
+    CHECK(sevens);
+    values.resize(200);
+    for (std::size_t i = 100; i < values.size(); i++) {
+        values[i] = int(i);
+    }
+    CHECK(values[99] == 7);
+    CHECK(values[199] == 199);
+
+    std::vector<Point<float>, DefaultInitAllocator<Point<float>>> points(3);
+    points[2] = {1, 2};
+    points.push_back({3, 4});
+    CHECK(points.size() == 4);
+    CHECK((points[2] == Point<float>{1, 2}));
+    CHECK((points[3] == Point<float>{3, 4}));
+}
+
+} // namespace
+
+int main()
+{
+    testSizes();
+    testOverflow();
+    testMove();
+    testAllocator();
+    return test::exitCode();
+}
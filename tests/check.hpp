@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cmath>
+#include <iostream>
+
+// Minimal checks for the test programs: each failed check is reported, and
+// main() returns exitCode() so that ctest sees the test fail.
+
+namespace test {
+
+inline int& failures()
+{
+    static int count = 0;
+    return count;
+}
+
+inline int exitCode()
+{
+    return failures() == 0 ? 0 : 1;
+}
+
+inline void check(
+    bool passed, const char* expression, const char* file, int line)
+{
+    if (!passed) {
+        std::cerr << file << ":" << line << ": check failed: " <<
+            expression << "\n";
+        failures()++;
+    }
+}
+
+inline void checkNear(
+    double actual,
+    double expected,
+    double tolerance,
+    const char* expression,
+    const char* file,
+    int line)
+{
+    if (!(std::abs(actual - expected) <= tolerance)) {
+        std::cerr << file << ":" << line << ": check failed: " <<
+            expression << " is " << actual << ", expected " << expected <<
+            " +- " << tolerance << "\n";
+        failures()++;
+    }
+}
+
+} // namespace test
+
+#define CHECK(...)                                                            \
+    ::test::check(                                                            \
+        static_cast<bool>(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+
+#define CHECK_NEAR(actual, expected, tolerance)                               \
+    ::test::checkNear(                                                        \
+        (actual), (expected), (tolerance), #actual, __FILE__, __LINE__)
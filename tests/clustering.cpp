@@ -0,0 +1,185 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/clustering.hpp>
+#include <ecosnail/flat/grid.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+std::vector<Point<double>> blobs(
+    const std::vector<Point<double>>& centers,
+    std::size_t perBlob,
+    double spread,
+    unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::normal_distribution<double> offset(0, spread);
+    std::vector<Point<double>> points;
+    for (std::size_t i = 0; i < perBlob; i++) {
+        for (const auto& center : centers) {
+            points.push_back(
+                center + Vector<double>{offset(random), offset(random)});
+        }
+    }
+    return points;
+}
+
+double squaredDistance(const Point<double>& lhs, const Point<double>& rhs)
+{
+    return squaredLength(lhs - rhs);
+}
+
+void testGridIndex()
+{
+    const auto points = blobs({{0, 0}, {3, 1}}, 500, 1.0, 1);
+    const GridIndex<double> grid(points.data(), points.size(), 0.4);
+    for (std::size_t q = 0; q < points.size(); q += 37) {
+        std::set<std::size_t> found;
+        grid.forEachWithin(points[q], 0.7, [&] (std::size_t i) {
+            found.insert(i);
+        });
+        std::set<std::size_t> expected;
+        for (std::size_t i = 0; i < points.size(); i++) {
+            if (squaredDistance(points[i], points[q]) <= 0.49) {
+                expected.insert(i);
+            }
+        }
+        CHECK(found == expected);
+        CHECK(grid.countWithin(points[q], 0.7, expected.size() + 1) ==
+            expected.size());
+    }
+}
+
+void testKMeans()
+{
+    const std::vector<Point<double>> centers {{0, 0}, {10, 0}, {0, 10}};
+    const auto points = blobs(centers, 1000, 0.5, 2);
+    const auto result = kMeans(points.data(), points.size(), 3);
+
+    CHECK(result.centers.size() == 3);
+    CHECK(result.labels.size() == points.size());
+
+    // each blob is one cluster, centered on the blob
+    std::set<std::size_t> labels;
+    for (std::size_t blob = 0; blob < centers.size(); blob++) {
+        const auto label = result.labels[blob];
+        labels.insert(label);
+        for (std::size_t i = blob; i < points.size(); i += centers.size()) {
+            CHECK(result.labels[i] == label);
+        }
+        CHECK(squaredDistance(result.centers[label], centers[blob]) < 0.01);
+    }
+    CHECK(labels.size() == 3);
+
+    // converged: every point is labelled with its nearest center
+    for (std::size_t i = 0; i < points.size(); i++) {
+        const auto& center = result.centers[result.labels[i]];
+        for (const auto& other : result.centers) {
+            CHECK(squaredDistance(points[i], center) <=
+                squaredDistance(points[i], other) + 1e-9);
+        }
+    }
+}
+
+// Quadratic DBSCAN with the labelling rules documented for dbscan()
+std::vector<std::size_t> referenceDbscan(
+    const std::vector<Point<double>>& points, double eps, std::size_t minPoints)
+{
+    const std::size_t count = points.size();
+    auto near = [&] (std::size_t i, std::size_t j) {
+        return squaredDistance(points[i], points[j]) <= eps * eps;
+    };
+
+    std::vector<bool> core(count);
+    for (std::size_t i = 0; i < count; i++) {
+        std::size_t neighbors = 0;
+        for (std::size_t j = 0; j < count; j++) {
+            neighbors += near(i, j);
+        }
+        core[i] = neighbors >= minPoints;
+    }
+
+    std::vector<std::size_t> component(count, noise);
+    for (std::size_t i = 0; i < count; i++) {
+        if (!core[i] || component[i] != noise) {
+            continue;
+        }
+        std::vector<std::size_t> stack {i};
+        component[i] = i;
+        while (!stack.empty()) {
+            const auto current = stack.back();
+            stack.pop_back();
+            for (std::size_t j = 0; j < count; j++) {
+                if (core[j] && component[j] == noise && near(current, j)) {
+                    component[j] = i;
+                    stack.push_back(j);
+                }
+            }
+        }
+    }
+
+    std::vector<std::size_t> labels(count, noise);
+    std::vector<std::size_t> clusterOf(count, noise);
+    std::size_t clusters = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        std::size_t owner = noise;
+        if (core[i]) {
+            owner = i;
+        } else {
+            for (std::size_t j = 0; j < count && owner == noise; j++) {
+                if (core[j] && near(i, j)) {
+                    owner = j;
+                }
+            }
+        }
+        if (owner == noise) {
+            continue;
+        }
+        auto& cluster = clusterOf[component[owner]];
+        if (cluster == noise) {
+            cluster = clusters++;
+        }
+        labels[i] = cluster;
+    }
+    return labels;
+}
+
+void testDbscan()
+{
+    auto points = blobs({{0, 0}, {6, 0}, {0, 6}}, 300, 0.6, 3);
+    // sparse noise
+    std::mt19937 random(4);
+    std::uniform_real_distribution<double> uniform(-5, 11);
+    for (int i = 0; i < 200; i++) {
+        points.push_back({uniform(random), uniform(random)});
+    }
+
+    for (const auto& [eps, minPoints] :
+            {std::pair{0.3, std::size_t{5}}, std::pair{0.5, std::size_t{8}}}) {
+        const auto labels =
+            dbscan(points.data(), points.size(), eps, minPoints);
+        CHECK(labels == referenceDbscan(points, eps, minPoints));
+    }
+
+    CHECK(dbscan<double>(nullptr, 0, 1.0, 3).empty());
+    const std::vector<Point<double>> lonely {{0, 0}, {10, 10}};
+    CHECK(dbscan(lonely.data(), lonely.size(), 1.0, 2) ==
+        std::vector<std::size_t>(2, noise));
+}
+
+} // namespace
+
+int main()
+{
+    testGridIndex();
+    testKMeans();
+    testDbscan();
+    return test::exitCode();
+}
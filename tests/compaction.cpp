@@ -0,0 +1,93 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/compaction.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+// Predicates returning integers other than 0 and 1 still keep the point:
+// 256 would truncate to a zero byte flag.
+int keepCode(const Point<double>& point)
+{
+    return static_cast<int>(point.x) % 3 == 0 ? 0 : 256;
+}
+
+bool kept(const Point<double>& point)
+{
+    return keepCode(point) != 0;
+}
+
+void testFilter(const std::vector<Point<double>>& points)
+{
+    std::vector<Point<double>> expected;
+    std::vector<std::uint32_t> expectedIndices;
+    for (std::size_t i = 0; i < points.size(); i++) {
+        if (kept(points[i])) {
+            expected.push_back(points[i]);
+            expectedIndices.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+
+    std::vector<std::uint32_t> indices(points.size());
+    indices.resize(
+        filterIndices(points.data(), points.size(), keepCode, indices.data()));
+    CHECK(indices == expectedIndices);
+
+    std::vector<Point<double>> out(points.size());
+    out.resize(filter(points.data(), points.size(), keepCode, out.data()));
+    CHECK(out == expected);
+}
+
+void testPartition(const std::vector<Point<double>>& points)
+{
+    std::vector<Point<double>> expected;
+    for (const auto& point : points) {
+        if (kept(point)) {
+            expected.push_back(point);
+        }
+    }
+    const std::size_t selected = expected.size();
+    for (const auto& point : points) {
+        if (!kept(point)) {
+            expected.push_back(point);
+        }
+    }
+
+    std::vector<Point<double>> out(points.size());
+    CHECK(partitionCopy(points.data(), points.size(), keepCode, out.data()) ==
+        selected);
+    CHECK(out == expected);
+
+    std::vector<double> xs, ys;
+    for (const auto& point : points) {
+        xs.push_back(point.x);
+        ys.push_back(point.y);
+    }
+    std::vector<double> outXs(points.size());
+    std::vector<double> outYs(points.size());
+    const double* source[] = {xs.data(), ys.data()};
+    double* const target[] = {outXs.data(), outYs.data()};
+    CHECK(partitionCopy(source, points.size(), keepCode, target) == selected);
+    for (std::size_t i = 0; i < points.size(); i++) {
+        CHECK(outXs[i] == expected[i].x && outYs[i] == expected[i].y);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    // several compaction blocks, the last one partial
+    std::vector<Point<double>> points;
+    for (std::size_t i = 0; i < 100000; i++) {
+        points.push_back({double(i * 7919 % 100003), double(i)});
+    }
+    testFilter(points);
+    testPartition(points);
+    return test::exitCode();
+}
@@ -0,0 +1,160 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/grid.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+const Rectangle<float> region{{0, 0}, {100, 100}};
+
+// Writers move their own entities while readers query; every reported
+// entity must lie within the query, and once the writers are done every
+// entity must be found exactly once, at its last position.
+void testConcurrentUpdates()
+{
+    constexpr std::size_t writerCount = 4;
+    constexpr std::size_t readerCount = 2;
+    constexpr std::size_t capacity = 4000;
+    constexpr std::size_t rounds = 8;
+    ConcurrentGrid<float> grid(region, 2, capacity);
+    std::vector<Point<float>> expected(capacity);
+
+    for (std::size_t round = 0; round < rounds; round++) {
+        std::atomic<bool> writing{true};
+        std::atomic<std::size_t> misplaced{0};
+        std::atomic<std::size_t> failedUpdates{0};
+
+        std::vector<std::thread> readers;
+        for (std::size_t r = 0; r < readerCount; r++) {
+            readers.emplace_back([&, r] {
+                std::mt19937 random(static_cast<unsigned>(round * 7 + r));
+                std::uniform_real_distribution<float> coordinate(0, 100);
+                do {
+                    const Point<float> center{
+                        coordinate(random), coordinate(random)};
+                    grid.forEachWithin(center, 5, [&] (
+                            std::size_t id, const Point<float>& point) {
+                        const float dx = point.x - center.x;
+                        const float dy = point.y - center.y;
+                        if (id >= capacity || dx * dx + dy * dy > 25) {
+                            misplaced++;
+                        }
+                    });
+                } while (writing.load());
+            });
+        }
+
+        std::vector<std::thread> writers;
+        for (std::size_t w = 0; w < writerCount; w++) {
+            writers.emplace_back([&, w] {
+                std::mt19937 random(static_cast<unsigned>(round * 11 + w));
+                std::uniform_real_distribution<float> coordinate(0, 100);
+                const std::size_t begin = capacity * w / writerCount;
+                const std::size_t end = capacity * (w + 1) / writerCount;
+                for (std::size_t id = begin; id < end; id++) {
+                    const Point<float> point{
+                        coordinate(random), coordinate(random)};
+                    if (grid.move(id, point)) {
+                        expected[id] = point;
+                    } else {
+                        failedUpdates++;
+                    }
+                }
+            });
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        writing = false;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        CHECK(misplaced == 0);
+        CHECK(failedUpdates == 0);
+        CHECK(grid.nodeCount() <= grid.nodeCapacity());
+
+        std::vector<std::size_t> found(capacity);
+        grid.forEachWithin({50, 50}, 100, [&] (
+                std::size_t id, const Point<float>& point) {
+            found[id]++;
+            CHECK(point == expected[id]);
+        });
+        for (std::size_t id = 0; id < capacity; id++) {
+            CHECK(found[id] == 1);
+            CHECK(grid.position(id) == expected[id]);
+        }
+
+        grid.compact();
+        CHECK(grid.nodeCount() == capacity);
+    }
+}
+
+// Updates on an empty pool fail without changing the grid, and leave the
+// node count at the capacity instead of counting past it.
+void testExhaustedPool()
+{
+    ConcurrentGrid<float> grid(region, 10, 4, 4);
+    for (std::size_t id = 0; id < 4; id++) {
+        CHECK(grid.insert(id, {5, 5}));
+    }
+    CHECK(grid.nodeCount() == 4);
+
+    std::vector<std::thread> threads;
+    for (std::size_t id = 0; id < 4; id++) {
+        threads.emplace_back([&grid, id] {
+            for (int i = 0; i < 10000; i++) {
+                grid.move(id, {95, 95});
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    CHECK(grid.nodeCount() == 4);
+    for (std::size_t id = 0; id < 4; id++) {
+        CHECK(grid.position(id) == Point<float>{5, 5});
+    }
+    // moves within a cell need no node
+    CHECK(grid.move(0, {6, 6}));
+
+    grid.remove(3);
+    grid.compact();
+    CHECK(grid.nodeCount() == 3);
+    CHECK(grid.move(0, {95, 95}));
+    std::size_t found = 0;
+    grid.forEachWithin({95, 95}, 1, [&] (std::size_t id, const Point<float>&) {
+        CHECK(id == 0);
+        found++;
+    });
+    CHECK(found == 1);
+}
+
+void testCapacityCheck()
+{
+    bool thrown = false;
+    try {
+        ConcurrentGrid<float> grid(region, 1, 100, 50);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+} // namespace
+
+int main()
+{
+    testConcurrentUpdates();
+    testExhaustedPool();
+    testCapacityCheck();
+    return test::exitCode();
+}
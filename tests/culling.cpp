@@ -0,0 +1,117 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/culling.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+// Several compaction blocks, the last one partial
+constexpr std::size_t count = 70000;
+
+const std::vector<Rectangle<float>> viewports = {
+    {{0, 0}, {100, 100}},
+    {{-50, 20}, {10, 30}},
+    {{200, 200}, {300, 300}},
+    {{-1000, -1000}, {1000, 1000}},
+    {{5, 5}, {5, 5}},
+};
+
+template <class Item, class Visible>
+std::vector<std::uint32_t> bruteForce(
+    const std::vector<Item>& items, Visible&& visible)
+{
+    std::vector<std::uint32_t> result;
+    for (std::size_t i = 0; i < items.size(); i++) {
+        if (visible(items[i])) {
+            result.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    return result;
+}
+
+// Single and multiple viewport culling must both give, in input order, the
+// items a direct test finds visible.
+template <class Item>
+void checkCull(const std::vector<Item>& items)
+{
+    std::vector<std::vector<std::uint32_t>> lists(
+        viewports.size(), std::vector<std::uint32_t>(items.size()));
+    std::vector<std::uint32_t*> pointers;
+    for (auto& list : lists) {
+        pointers.push_back(list.data());
+    }
+    std::vector<std::size_t> sizes(viewports.size());
+    cull(items.data(), items.size(), viewports.data(), viewports.size(),
+        pointers.data(), sizes.data());
+
+    for (std::size_t v = 0; v < viewports.size(); v++) {
+        const auto expected = bruteForce(items, [&] (const Item& item) {
+            if constexpr (std::is_same_v<Item, Circle<float>>) {
+                return intersects(viewports[v], item);
+            } else {
+                return contains(viewports[v], item);
+            }
+        });
+        lists[v].resize(sizes[v]);
+        CHECK(lists[v] == expected);
+
+        std::vector<std::uint32_t> single(items.size());
+        single.resize(
+            cull(items.data(), items.size(), viewports[v], single.data()));
+        CHECK(single == expected);
+    }
+}
+
+void testPoints()
+{
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> coordinate(-100, 200);
+    std::vector<Point<float>> points;
+    for (std::size_t i = 0; i < count; i++) {
+        points.push_back({coordinate(random), coordinate(random)});
+    }
+    // points on the borders are inside
+    points[100] = {0, 0};
+    points[200] = {100, 50};
+    points[300] = {5, 5};
+    checkCull(points);
+
+    CHECK(contains(viewports[0], Point<float>{100, 100}));
+    CHECK(!contains(viewports[0], Point<float>{100.001f, 50}));
+    CHECK(contains(viewports[4], Point<float>{5, 5}));
+}
+
+void testCircles()
+{
+    std::mt19937 random(2);
+    std::uniform_real_distribution<float> coordinate(-100, 200);
+    std::uniform_real_distribution<float> radius(0, 10);
+    std::vector<Circle<float>> circles;
+    for (std::size_t i = 0; i < count; i++) {
+        circles.push_back(
+            {{coordinate(random), coordinate(random)}, radius(random)});
+    }
+    checkCull(circles);
+
+    // touching a side or a corner counts, missing a corner does not
+    CHECK(intersects(viewports[0], Circle<float>{{105, 50}, 5}));
+    CHECK(intersects(viewports[0], Circle<float>{{103, 104}, 5}));
+    CHECK(!intersects(viewports[0], Circle<float>{{104, 104}, 5}));
+    CHECK(intersects(viewports[0], Circle<float>{{50, 50}, 0}));
+}
+
+} // namespace
+
+int main()
+{
+    testPoints();
+    testCircles();
+    return test::exitCode();
+}
@@ -0,0 +1,86 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/curves.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+// Every flattened point lies on the curve, and the polyline stays within
+// the tolerance of it at the midpoints of its segments.
+void testFlatten()
+{
+    const CubicBezier<double> curve{{0, 0}, {10, 20}, {30, -20}, {40, 0}};
+    const double tolerance = 0.01;
+    std::vector<Point<double>> points = {curve.p0};
+    flatten(curve, tolerance, points);
+
+    const std::size_t n = segmentCount(curve, tolerance);
+    CHECK(points.size() == n + 1);
+    for (std::size_t i = 0; i <= n; i++) {
+        const auto expected = curve(double(i) / n);
+        CHECK_NEAR(points[i].x, expected.x, 1e-9);
+        CHECK_NEAR(points[i].y, expected.y, 1e-9);
+    }
+    for (std::size_t i = 0; i < n; i++) {
+        const auto middle = curve((i + 0.5) / n);
+        const auto chord = (points[i] + (points[i + 1] - points[i]) / 2.0);
+        CHECK(length(middle - chord) <= tolerance);
+    }
+}
+
+void testSegmentCounts()
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double inf = std::numeric_limits<double>::infinity();
+    const QuadraticBezier<double> line{{0, 0}, {1, 1}, {2, 2}};
+    CHECK(segmentCount(line, 0.1) == 1);
+    CHECK(segmentCount(QuadraticBezier<double>{{0, 0}, {nan, 0}, {1, 0}},
+        0.1) == 1);
+    CHECK(segmentCount(QuadraticBezier<double>{{0, 0}, {inf, 0}, {1, 0}},
+        0.1) == maxSegmentCount);
+    CHECK(segmentCount(QuadraticBezier<double>{{0, 0}, {1e30, 0}, {1, 0}},
+        1e-30) == maxSegmentCount);
+
+    for (double tolerance : {0.0, -1.0, nan}) {
+        bool thrown = false;
+        try {
+            segmentCount(line, tolerance);
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+    }
+}
+
+// Chaining many curves into one polyline keeps the vector's geometric
+// growth: a handful of reallocations, not one per curve.
+void testChaining()
+{
+    std::vector<Point<double>> points;
+    std::size_t reallocations = 0;
+    for (int i = 0; i < 10000; i++) {
+        const double x = i;
+        const auto* data = points.data();
+        flatten(CubicBezier<double>{{x, 0}, {x, 1}, {x + 1, 1}, {x + 1, 0}},
+            0.01, points);
+        reallocations += points.data() != data;
+    }
+    CHECK(reallocations < 64);
+}
+
+} // namespace
+
+int main()
+{
+    testFlatten();
+    testSegmentCounts();
+    testChaining();
+    return test::exitCode();
+}
@@ -0,0 +1,146 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/dispatch.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+const dispatch::Target targets[] = {
+    dispatch::Target::Generic,
+    dispatch::Target::Avx2,
+    dispatch::Target::Avx512,
+};
+
+// Sizes around the vector widths, including the empty and scalar tails
+const std::size_t sizes[] = {0, 1, 15, 17, 1000};
+
+// Every supported target must agree with a plain scalar loop
+template <class T>
+void testArithmetic(std::size_t count)
+{
+    std::mt19937 random(static_cast<unsigned>(count));
+    std::uniform_real_distribution<T> coordinate(-100, 100);
+    std::vector<Vector<T>> vectors(count);
+    std::vector<Point<T>> lhs(count);
+    std::vector<Point<T>> rhs(count);
+    for (std::size_t i = 0; i < count; i++) {
+        vectors[i] = {coordinate(random), coordinate(random)};
+        lhs[i] = {coordinate(random), coordinate(random)};
+        rhs[i] = i % 5 == 0 ?
+            lhs[i] : Point<T>{coordinate(random), coordinate(random)};
+    }
+    if (count > 1) {
+        vectors[1] = {0, 0};
+    }
+    const T tolerance = 8 * std::numeric_limits<T>::epsilon();
+
+    std::vector<T> out(count);
+    dispatch::length(vectors.data(), count, out.data());
+    for (std::size_t i = 0; i < count; i++) {
+        const T expected = std::sqrt(
+            vectors[i].x * vectors[i].x + vectors[i].y * vectors[i].y);
+        CHECK_NEAR(out[i], expected, tolerance * expected);
+    }
+
+    dispatch::distance(lhs.data(), rhs.data(), count, out.data());
+    for (std::size_t i = 0; i < count; i++) {
+        const T dx = lhs[i].x - rhs[i].x;
+        const T dy = lhs[i].y - rhs[i].y;
+        const T expected = std::sqrt(dx * dx + dy * dy);
+        CHECK_NEAR(out[i], expected, tolerance * expected);
+    }
+
+    auto normalized = vectors;
+    dispatch::normalize(normalized.data(), count);
+    for (std::size_t i = 0; i < count; i++) {
+        const T l = std::sqrt(
+            vectors[i].x * vectors[i].x + vectors[i].y * vectors[i].y);
+        const T x = l == 0 ? T{0} : vectors[i].x / l;
+        const T y = l == 0 ? T{0} : vectors[i].y / l;
+        CHECK_NEAR(normalized[i].x, x, tolerance);
+        CHECK_NEAR(normalized[i].y, y, tolerance);
+    }
+}
+
+// Compaction is exact; outputs hold count elements and no more
+void testCompaction(std::size_t count)
+{
+    std::mt19937 random(static_cast<unsigned>(count));
+    std::vector<std::uint8_t> flags(count);
+    std::vector<float> values(count);
+    std::vector<Point<double>> points(count);
+    std::vector<std::uint32_t> expected;
+    for (std::size_t i = 0; i < count; i++) {
+        // runs of kept and dropped elements as well as scattered ones
+        flags[i] = i % 64 < 20 ? 0 : i % 64 < 40 ?
+            std::uint8_t(random() % 256) : std::uint8_t(random() % 2);
+        values[i] = float(i);
+        points[i] = {double(i), -double(i)};
+        if (flags[i]) {
+            expected.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+
+    std::vector<std::uint32_t> indices(count);
+    const auto size = dispatch::compactIndices(
+        flags.data(), count, indices.data());
+    CHECK(size == expected.size());
+    indices.resize(size);
+    CHECK(indices == expected);
+
+    std::vector<float> keptValues(count);
+    CHECK(dispatch::compact(values.data(), flags.data(), count,
+        keptValues.data()) == expected.size());
+    std::vector<Point<double>> keptPoints(count);
+    CHECK(dispatch::compact(points.data(), flags.data(), count,
+        keptPoints.data()) == expected.size());
+    for (std::size_t i = 0; i < expected.size(); i++) {
+        CHECK(keptValues[i] == float(expected[i]));
+        CHECK(keptPoints[i] == points[expected[i]]);
+    }
+}
+
+void testTargets()
+{
+    std::size_t tested = 0;
+    for (auto target : targets) {
+        if (!dispatch::isSupported(target)) {
+            bool thrown = false;
+            try {
+                dispatch::setTarget(target);
+            } catch (const std::invalid_argument&) {
+                thrown = true;
+            }
+            CHECK(thrown);
+            continue;
+        }
+
+        dispatch::setTarget(target);
+        CHECK(dispatch::currentTarget() == target);
+        for (auto count : sizes) {
+            testArithmetic<float>(count);
+            testArithmetic<double>(count);
+            testCompaction(count);
+        }
+        tested++;
+    }
+    CHECK(tested >= 1);
+    CHECK(dispatch::isSupported(dispatch::bestTarget()));
+}
+
+} // namespace
+
+int main()
+{
+    testTargets();
+    return test::exitCode();
+}
@@ -0,0 +1,139 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/distances.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+// Counts on either side of the row and column tile sizes
+const std::size_t fromCounts[] = {0, 1, 63, 64, 65};
+const std::size_t toCounts[] = {0, 1, 1023, 1024, 1025};
+
+template <class T, std::size_t N>
+std::vector<Point<T, N>> randomPoints(std::mt19937& random, std::size_t count)
+{
+    std::uniform_real_distribution<T> coordinate(-100, 100);
+    std::vector<Point<T, N>> points(count);
+    for (auto& point : points) {
+        for (std::size_t d = 0; d < N; d++) {
+            point[d] = coordinate(random);
+        }
+    }
+    // repeated points make ties for nearest()
+    for (std::size_t i = 1; i < count; i += 7) {
+        points[i] = points[i - 1];
+    }
+    return points;
+}
+
+template <class T, std::size_t N>
+T naiveSquaredDistance(const Point<T, N>& lhs, const Point<T, N>& rhs)
+{
+    T sum = 0;
+    for (std::size_t d = 0; d < N; d++) {
+        sum += (rhs[d] - lhs[d]) * (rhs[d] - lhs[d]);
+    }
+    return sum;
+}
+
+// Every cell of the tiled matrices matches a direct computation
+template <class T, std::size_t N>
+void testMatrix()
+{
+    std::mt19937 random(47);
+    const T tolerance = 4 * std::numeric_limits<T>::epsilon();
+    for (auto fromCount : fromCounts) {
+        for (auto toCount : toCounts) {
+            const auto from = randomPoints<T, N>(random, fromCount);
+            const auto to = randomPoints<T, N>(random, toCount);
+            std::vector<T> squared(fromCount * toCount, T(-1));
+            std::vector<T> plain(fromCount * toCount, T(-1));
+            batch::squaredDistanceMatrix(
+                from.data(), fromCount, to.data(), toCount, squared.data());
+            batch::distanceMatrix(
+                from.data(), fromCount, to.data(), toCount, plain.data());
+
+            for (std::size_t i = 0; i < fromCount; i++) {
+                for (std::size_t j = 0; j < toCount; j++) {
+                    const T expected = naiveSquaredDistance(from[i], to[j]);
+                    const T s = squared[i * toCount + j];
+                    CHECK_NEAR(s, expected, tolerance * expected);
+                    CHECK_NEAR(plain[i * toCount + j], std::sqrt(expected),
+                        tolerance * std::sqrt(expected));
+                }
+            }
+        }
+    }
+}
+
+// nearest() returns the k smallest entries of each matrix row, nearest
+// first and ties by index, with k clamped to the number of points
+template <class T, std::size_t N>
+void testNearest()
+{
+    std::mt19937 random(53);
+    for (auto fromCount : fromCounts) {
+        for (auto toCount : toCounts) {
+            const auto from = randomPoints<T, N>(random, fromCount);
+            const auto to = randomPoints<T, N>(random, toCount);
+            std::vector<T> squared(fromCount * toCount);
+            batch::squaredDistanceMatrix(
+                from.data(), fromCount, to.data(), toCount, squared.data());
+
+            // rows sorted by distance, then index
+            std::vector<std::vector<std::size_t>> orders(fromCount);
+            for (std::size_t i = 0; i < fromCount; i++) {
+                const T* row = squared.data() + i * toCount;
+                auto& order = orders[i];
+                order.resize(toCount);
+                std::iota(order.begin(), order.end(), std::size_t{0});
+                std::sort(order.begin(), order.end(),
+                    [&] (std::size_t lhs, std::size_t rhs) {
+                        return row[lhs] < row[rhs] ||
+                            (row[lhs] == row[rhs] && lhs < rhs);
+                    });
+            }
+
+            for (std::size_t k : {std::size_t{0}, std::size_t{1},
+                    std::size_t{5}, toCount, toCount + 3}) {
+                const std::size_t clamped = std::min(k, toCount);
+                std::vector<std::size_t> indices(fromCount * clamped + 1, 7);
+                std::vector<T> distances(fromCount * clamped + 1, T(7));
+                CHECK(batch::nearest(from.data(), fromCount, to.data(),
+                    toCount, k, indices.data(), distances.data()) == clamped);
+                // nothing is written past the clamped rows
+                CHECK(indices.back() == 7);
+                CHECK(distances.back() == T(7));
+
+                for (std::size_t i = 0; i < fromCount; i++) {
+                    const T* row = squared.data() + i * toCount;
+                    for (std::size_t j = 0; j < clamped; j++) {
+                        CHECK(indices[i * clamped + j] == orders[i][j]);
+                        CHECK(distances[i * clamped + j] ==
+                            std::sqrt(row[orders[i][j]]));
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    testMatrix<double, 2>();
+    testMatrix<float, 3>();
+    testNearest<double, 2>();
+    testNearest<float, 3>();
+    return test::exitCode();
+}
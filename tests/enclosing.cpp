@@ -0,0 +1,296 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/enclosing.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+using Points = std::vector<Point<double>>;
+
+double cross(
+    const Point<double>& a, const Point<double>& b, const Point<double>& c)
+{
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+double distance(const Point<double>& a, const Point<double>& b)
+{
+    return std::hypot(b.x - a.x, b.y - a.y);
+}
+
+// Gift wrapping: counterclockwise from the lowest leftmost point, taking
+// the farthest of collinear candidates so that no vertex is collinear
+Points bruteHull(const Points& points)
+{
+    if (points.empty()) {
+        return {};
+    }
+    const auto start = *std::min_element(points.begin(), points.end(),
+        std::less<Point<double>>{});
+    Points hull;
+    auto current = start;
+    do {
+        hull.push_back(current);
+        auto candidate = current;
+        for (const auto& q : points) {
+            if (q == current) {
+                continue;
+            }
+            const double side = cross(current, candidate, q);
+            if (candidate == current || side < 0 || (side == 0 &&
+                    distance(current, q) > distance(current, candidate))) {
+                candidate = q;
+            }
+        }
+        current = candidate;
+    } while (current != start);
+    return hull;
+}
+
+// Extents of the points along the direction of b - a and across it
+void extents(
+    const Points& points,
+    const Point<double>& a,
+    const Point<double>& b,
+    double& along,
+    double& across)
+{
+    const double length = distance(a, b);
+    const double ux = (b.x - a.x) / length;
+    const double uy = (b.y - a.y) / length;
+    double minAlong = std::numeric_limits<double>::infinity();
+    double maxAlong = -minAlong;
+    double minAcross = minAlong;
+    double maxAcross = -minAlong;
+    for (const auto& p : points) {
+        const double u = (p.x - a.x) * ux + (p.y - a.y) * uy;
+        const double v = (p.y - a.y) * ux - (p.x - a.x) * uy;
+        minAlong = std::min(minAlong, u);
+        maxAlong = std::max(maxAlong, u);
+        minAcross = std::min(minAcross, v);
+        maxAcross = std::max(maxAcross, v);
+    }
+    along = maxAlong - minAlong;
+    across = maxAcross - minAcross;
+}
+
+// The smallest of the circles through two or three of the points that
+// contains all of them
+double bruteEnclosingRadius(const Points& points, double tolerance)
+{
+    if (points.empty()) {
+        return 0;
+    }
+    auto containsAll = [&] (const Point<double>& center, double radius) {
+        for (const auto& p : points) {
+            if (distance(p, center) > radius * (1 + tolerance) + tolerance) {
+                return false;
+            }
+        }
+        return true;
+    };
+    double best = std::numeric_limits<double>::infinity();
+    if (containsAll(points[0], 0)) {
+        best = 0;
+    }
+    for (std::size_t i = 0; i < points.size(); i++) {
+        for (std::size_t j = i + 1; j < points.size(); j++) {
+            const auto& a = points[i];
+            const auto& b = points[j];
+            const Point<double> middle{(a.x + b.x) / 2, (a.y + b.y) / 2};
+            const double radius = distance(a, b) / 2;
+            if (radius < best && containsAll(middle, radius)) {
+                best = radius;
+            }
+            for (std::size_t k = j + 1; k < points.size(); k++) {
+                const auto& c = points[k];
+                const double d = 2 * cross(a, b, c);
+                if (d == 0) {
+                    continue;
+                }
+                const double ab = std::pow(distance(a, b), 2);
+                const double ac = std::pow(distance(a, c), 2);
+                const Point<double> center{
+                    a.x + ((c.y - a.y) * ab - (b.y - a.y) * ac) / d,
+                    a.y + ((b.x - a.x) * ac - (c.x - a.x) * ab) / d};
+                const double r = distance(a, center);
+                if (r < best && containsAll(center, r)) {
+                    best = r;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+void checkShapes(const Points& points)
+{
+    const double tolerance = 1e-9;
+    Points hull(points.size());
+    hull.resize(convexHull(points.data(), points.size(), hull.data()));
+    CHECK(hull == bruteHull(points));
+
+    const auto circle = minimumEnclosingCircle(points.data(), points.size());
+    CHECK_NEAR(circle.radius, bruteEnclosingRadius(points, 1e-12),
+        tolerance * (1 + circle.radius));
+    for (const auto& p : points) {
+        CHECK(distance(p, circle.center) <= circle.radius + tolerance);
+    }
+
+    // diameter, width and the rectangle are attained along directions
+    // between two points
+    double bruteDiameter = 0;
+    double bruteWidth = std::numeric_limits<double>::infinity();
+    double bruteArea = std::numeric_limits<double>::infinity();
+    for (const auto& a : points) {
+        for (const auto& b : points) {
+            if (a == b) {
+                continue;
+            }
+            bruteDiameter = std::max(bruteDiameter, distance(a, b));
+            double along = 0;
+            double across = 0;
+            extents(points, a, b, along, across);
+            bruteWidth = std::min(bruteWidth, across);
+            bruteArea = std::min(bruteArea, along * across);
+        }
+    }
+    if (bruteDiameter == 0) {
+        bruteWidth = 0;
+        bruteArea = 0;
+    }
+    CHECK_NEAR(diameter(hull.data(), hull.size()), bruteDiameter, tolerance);
+    CHECK_NEAR(width(hull.data(), hull.size()), bruteWidth, tolerance);
+
+    const auto rectangle = minimumAreaRectangle(hull.data(), hull.size());
+    CHECK_NEAR(4 * rectangle.halfLength * rectangle.halfWidth, bruteArea,
+        tolerance * (1 + bruteArea));
+    if (!points.empty()) {
+        CHECK_NEAR(length(rectangle.axis), 1, tolerance);
+    }
+    const Vector<double> normal{-rectangle.axis.y, rectangle.axis.x};
+    for (const auto& p : points) {
+        const auto offset = p - rectangle.center;
+        CHECK(std::abs(dot(offset, rectangle.axis)) <=
+            rectangle.halfLength + tolerance);
+        CHECK(std::abs(dot(offset, normal)) <=
+            rectangle.halfWidth + tolerance);
+    }
+}
+
+// Integer coordinates on a small grid make collinear points and
+// duplicates common, and keep the hull orientation tests exact.
+void testRandom()
+{
+    std::mt19937 random(17);
+    for (int round = 0; round < 200; round++) {
+        const int extent = round % 2 ? 4 : 1000;
+        std::uniform_int_distribution<int> coordinate(-extent, extent);
+        Points points(1 + round % 40);
+        for (auto& point : points) {
+            point = {double(coordinate(random)), double(coordinate(random))};
+        }
+        checkShapes(points);
+    }
+
+    std::normal_distribution<double> gaussian(0, 10);
+    for (int round = 0; round < 50; round++) {
+        Points points(3 + round);
+        for (auto& point : points) {
+            point = {gaussian(random), gaussian(random)};
+        }
+        checkShapes(points);
+    }
+}
+
+void testDegenerate()
+{
+    checkShapes({});
+    checkShapes({{3, 4}});
+    checkShapes({{3, 4}, {3, 4}, {3, 4}});
+    checkShapes({{0, 0}, {5, 1}});
+    checkShapes({{0, 0}, {5, 1}, {0, 0}, {5, 1}});
+
+    // collinear points, in no particular order, with repeats
+    Points line;
+    for (int i : {3, -7, 0, 12, 5, 3, -7, 9}) {
+        line.push_back({2.0 * i, -1.0 * i});
+    }
+    checkShapes(line);
+
+    // a square with points along its sides and at its corners repeated
+    Points square;
+    for (int i = 0; i <= 8; i++) {
+        square.push_back({double(i), 0});
+        square.push_back({8, double(i)});
+        square.push_back({double(i), 8});
+        square.push_back({0, double(i)});
+    }
+    checkShapes(square);
+
+    Points hull(square.size());
+    CHECK(convexHull(square.data(), square.size(), hull.data()) == 4);
+    CHECK_NEAR(width(hull.data(), 4), 8, 1e-12);
+    CHECK_NEAR(diameter(hull.data(), 4), 8 * std::sqrt(2.0), 1e-12);
+}
+
+// The batch functions give the same results as the scalar ones
+void testBatch()
+{
+    std::mt19937 random(23);
+    std::uniform_real_distribution<double> coordinate(-50, 50);
+    Points points;
+    std::vector<std::size_t> offsets{0};
+    for (int cluster = 0; cluster < 300; cluster++) {
+        const int size = cluster % 17;
+        for (int i = 0; i < size; i++) {
+            points.push_back({coordinate(random), coordinate(random)});
+        }
+        offsets.push_back(points.size());
+    }
+    const std::size_t clusterCount = offsets.size() - 1;
+
+    std::vector<Circle<double>> circles(clusterCount);
+    batch::minimumEnclosingCircle(
+        points.data(), offsets.data(), clusterCount, circles.data());
+    Points scratch(points.size());
+    std::vector<HullMetrics<double>> metrics(clusterCount);
+    batch::hullMetrics(points.data(), offsets.data(), clusterCount,
+        scratch.data(), metrics.data());
+
+    for (std::size_t i = 0; i < clusterCount; i++) {
+        const auto* cluster = points.data() + offsets[i];
+        const auto size = offsets[i + 1] - offsets[i];
+        const auto circle = minimumEnclosingCircle(cluster, size);
+        CHECK(circles[i].center == circle.center);
+        CHECK(circles[i].radius == circle.radius);
+
+        Points hull(size);
+        hull.resize(convexHull(cluster, size, hull.data()));
+        CHECK(metrics[i].diameter == diameter(hull.data(), hull.size()));
+        CHECK(metrics[i].width == width(hull.data(), hull.size()));
+        const auto rectangle =
+            minimumAreaRectangle(hull.data(), hull.size());
+        CHECK(metrics[i].rectangle.center == rectangle.center);
+        CHECK(metrics[i].rectangle.halfLength == rectangle.halfLength);
+        CHECK(metrics[i].rectangle.halfWidth == rectangle.halfWidth);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    testRandom();
+    testDegenerate();
+    testBatch();
+    return test::exitCode();
+}
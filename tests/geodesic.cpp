@@ -0,0 +1,100 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/geodesic.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+// Reference distances on WGS 84, from GeographicLib and the literature
+void testReferenceDistances()
+{
+    // quarter meridian and half meridian
+    CHECK_NEAR(vincentyDistance({0, 0}, {0, 90}), 10001965.7293, 1e-3);
+    CHECK_NEAR(vincentyDistance({0, -90}, {0, 90}), 20003931.4586, 1e-3);
+    // quarter of the equator
+    CHECK_NEAR(vincentyDistance({0, 0}, {90, 0}), 10018754.1714, 1e-3);
+    // Flinders Peak to Buninyong (Vincenty's direct/inverse test line)
+    CHECK_NEAR(
+        vincentyDistance(
+            {144.42486788888889, -37.951033416666667},
+            {143.92649552777778, -37.652821138888889}),
+        54972.271, 1e-3);
+    CHECK(vincentyDistance({10, 20}, {10, 20}) == 0);
+}
+
+// Nearly antipodal points, where Vincenty's iteration does not converge
+void testAntipodal()
+{
+    // on the equator the geodesic runs over a pole
+    CHECK_NEAR(vincentyDistance({0, 0}, {180, 0}), 20003931.4586, 1e-3);
+    CHECK_NEAR(vincentyDistance({0, 89}, {180, -89}), 20003931.4586, 1e-3);
+    // Karney, "Algorithms for geodesics" (2013), section 4
+    CHECK_NEAR(vincentyDistance({0, -30}, {179.8, 29.9}), 19989832.8276, 1e-3);
+    CHECK_NEAR(vincentyDistance({0, 0}, {179.5, 0.5}), 19936288.579, 1e-3);
+    // both on the equator, but too far apart for the equator to be shortest
+    CHECK(vincentyDistance({0, 0}, {179.7, 0}) <
+        wgs84::semiMajorAxis * 179.7 * detail::pi / 180);
+}
+
+void testConsistency()
+{
+    std::mt19937 random(57);
+    std::uniform_real_distribution<double> longitude(-180, 180);
+    std::uniform_real_distribution<double> latitude(-89.9, 89.9);
+    for (int i = 0; i < 10000; i++) {
+        const Point<double> from {longitude(random), latitude(random)};
+        const Point<double> to {longitude(random), latitude(random)};
+        const double distance = vincentyDistance(from, to);
+        CHECK_NEAR(vincentyDistance(to, from), distance, 1e-4);
+        // both solutions agree where Vincenty's converges
+        CHECK_NEAR(detail::karneyDistance(from, to), distance, 1e-4);
+        CHECK_NEAR(haversineDistance(from, to), distance, distance * 0.006);
+    }
+
+    // no jump where the fallback takes over
+    double previous = vincentyDistance({0, 0}, {179, 0.5});
+    for (double lon = 179.001; lon <= 180; lon += 0.001) {
+        const double distance = vincentyDistance({0, 0}, {lon, 0.5});
+        CHECK(distance >= previous - 1e-6);
+        CHECK(distance - previous < 100);
+        previous = distance;
+    }
+}
+
+void testBatch()
+{
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> longitude(-180, 180);
+    std::uniform_real_distribution<double> latitude(-90, 90);
+    std::vector<Point<double>> points(1000);
+    for (auto& point : points) {
+        point = {longitude(random), latitude(random)};
+    }
+    const Point<double> from {12, -34};
+
+    std::vector<double> vincenty(points.size());
+    std::vector<double> haversine(points.size());
+    batch::vincentyDistance(from, points.data(), points.size(),
+        vincenty.data());
+    batch::haversineDistance(from, points.data(), points.size(),
+        haversine.data());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        CHECK(vincenty[i] == vincentyDistance(from, points[i]));
+        CHECK_NEAR(haversine[i], haversineDistance(from, points[i]), 1e-6);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    testReferenceDistances();
+    testAntipodal();
+    testConsistency();
+    testBatch();
+    return test::exitCode();
+}
@@ -0,0 +1,116 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/numa.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+// The partitions are contiguous, in order, and cover the whole buffer
+template <class T>
+void checkPartitions(const NumaBuffer<T>& buffer)
+{
+    CHECK(buffer.partitionCount() >= 1);
+    std::size_t next = 0;
+    for (std::size_t p = 0; p < buffer.partitionCount(); p++) {
+        const auto& partition = buffer.partition(p);
+        CHECK(partition.offset == next);
+        CHECK(partition.size == 0 || partition.data != nullptr);
+        next = partition.offset + partition.size;
+    }
+    CHECK(next == buffer.size());
+}
+
+// parallelFor() visits every element exactly once, with offsets that match
+// operator[]
+void testFill(std::size_t size, std::size_t minRange)
+{
+    NumaBuffer<std::uint64_t> buffer(size);
+    CHECK(buffer.size() == size);
+    checkPartitions(buffer);
+
+    // ranges are disjoint, so each slot is written by one thread only
+    std::vector<int> visits(size);
+    buffer.parallelFor(
+        [&] (std::uint64_t* first, std::uint64_t* last, std::size_t offset) {
+            for (auto* element = first; element != last; element++) {
+                const std::size_t i = offset + std::size_t(element - first);
+                *element = std::uint64_t(i) * 3 + 1;
+                visits[i]++;
+            }
+        },
+        minRange);
+
+    bool once = true;
+    bool values = true;
+    for (std::size_t i = 0; i < size; i++) {
+        once = once && visits[i] == 1;
+        values = values && buffer[i] == std::uint64_t(i) * 3 + 1;
+    }
+    CHECK(once);
+    CHECK(values);
+
+    // operator[] refers into the partitions
+    const auto& constBuffer = buffer;
+    for (std::size_t p = 0; p < buffer.partitionCount(); p++) {
+        const auto& partition = buffer.partition(p);
+        if (partition.size > 0) {
+            CHECK(&constBuffer[partition.offset] == partition.data);
+            CHECK(&buffer[partition.offset + partition.size - 1] ==
+                partition.data + partition.size - 1);
+        }
+    }
+}
+
+void testPoints()
+{
+    NumaPointBuffer<float> points(5000, NumaPlacement::Interleaved);
+    checkPartitions(points);
+    points.parallelFor(
+        [] (Point<float>* first, Point<float>* last, std::size_t offset) {
+            for (auto* point = first; point != last; point++) {
+                const float i = float(offset + std::size_t(point - first));
+                *point = {i, -i};
+            }
+        },
+        100);
+    bool same = true;
+    for (std::size_t i = 0; i < points.size(); i++) {
+        same = same && points[i] == Point<float>{float(i), -float(i)};
+    }
+    CHECK(same);
+}
+
+void testError()
+{
+    NumaBuffer<int> buffer(10000);
+    bool thrown = false;
+    try {
+        buffer.parallelFor([] (int*, int*, std::size_t offset) {
+            if (offset == 0) {
+                throw std::runtime_error("first range");
+            }
+        }, 100);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+} // namespace
+
+int main()
+{
+    for (std::size_t size : {0, 1, 7, 1000, 100003}) {
+        testFill(size, 1024);
+        testFill(size, 1);
+    }
+    testPoints();
+    testError();
+    return test::exitCode();
+}
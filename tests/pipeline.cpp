@@ -0,0 +1,130 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/pipeline.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+using Chunks = Pipeline<Point<double>>::Chunk;
+
+// A source of the points (i, -i) for i below count
+auto counter(std::size_t count)
+{
+    return [count, next = std::size_t{0}] (Chunks& chunk) mutable {
+        while (next < count && chunk.size() < chunk.capacity()) {
+            chunk.push_back({double(next), -double(next)});
+            next++;
+        }
+        return next < count;
+    };
+}
+
+// Every point arrives once, in order, transformed by every stage, and only
+// the chunks of the pool ever reach the sink.
+void testOrder()
+{
+    for (std::size_t stages : {0, 1, 3}) {
+        for (std::size_t count : {0, 1, 100, 10001}) {
+            Pipeline<Point<double>> pipeline(64, 3);
+            pipeline.source(counter(count));
+            for (std::size_t s = 0; s < stages; s++) {
+                pipeline.stage([] (Chunks& chunk) {
+                    for (auto& point : chunk) {
+                        point.y += 1;
+                    }
+                });
+            }
+            // drop every tenth point, shrinking the chunks
+            pipeline.stage([] (Chunks& chunk) {
+                chunk.erase(std::remove_if(chunk.begin(), chunk.end(),
+                    [] (const Point<double>& point) {
+                        return std::size_t(point.x) % 10 == 0;
+                    }), chunk.end());
+            });
+
+            std::vector<Point<double>> received;
+            std::set<const Point<double>*> buffers;
+            pipeline.sink([&] (const Chunks& chunk) {
+                CHECK(chunk.size() <= 64);
+                received.insert(received.end(), chunk.begin(), chunk.end());
+                buffers.insert(chunk.data());
+            });
+            pipeline.run();
+
+            std::vector<Point<double>> expected;
+            for (std::size_t i = 0; i < count; i++) {
+                if (i % 10 != 0) {
+                    expected.push_back({double(i), double(stages) - i});
+                }
+            }
+            CHECK(received == expected);
+            CHECK(buffers.size() <= 3);
+        }
+    }
+}
+
+struct Failure {};
+
+// The first exception of any stage is rethrown by run(), and the other
+// threads stop instead of waiting forever.
+void testErrors()
+{
+    for (int failing = 0; failing < 3; failing++) {
+        std::atomic<std::size_t> chunks{0};
+        Pipeline<Point<double>> pipeline(16, 2);
+        pipeline
+            .source([&, source = counter(100000)] (Chunks& chunk) mutable {
+                if (failing == 0 && chunks >= 5) {
+                    throw Failure{};
+                }
+                return source(chunk);
+            })
+            .stage([&] (Chunks&) {
+                if (failing == 1 && chunks >= 5) {
+                    throw Failure{};
+                }
+            })
+            .sink([&] (const Chunks&) {
+                if (++chunks == 5 && failing == 2) {
+                    throw Failure{};
+                }
+            });
+
+        bool thrown = false;
+        try {
+            pipeline.run();
+        } catch (const Failure&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+    }
+}
+
+void testChunkCount()
+{
+    bool thrown = false;
+    try {
+        Pipeline<Point<double>> pipeline(16, 0);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+} // namespace
+
+int main()
+{
+    testOrder();
+    testErrors();
+    testChunkCount();
+    return test::exitCode();
+}
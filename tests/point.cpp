@@ -0,0 +1,108 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/layout.hpp>
+#include <ecosnail/flat/point.hpp>
+#include <ecosnail/flat/vector.hpp>
+
+#include <cmath>
+#include <cstddef>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+// 3D coordinates are padded to four components; other sizes are not
+static_assert(sizeof(Point<float, 2>) == 8);
+static_assert(sizeof(Point<float, 3>) == 16);
+static_assert(sizeof(Point<float, 4>) == 16);
+static_assert(sizeof(Point<double, 3>) == 32);
+static_assert(sizeof(Vector<float, 3>) == 16);
+static_assert(alignof(Point<float, 3>) == 16);
+static_assert(sizeof(Point<float, 5>) == 20);
+static_assert(sizeof(Point<float, 3>[4]) == 4 * 4 * sizeof(float));
+
+void testArithmetic3()
+{
+    const Point<double, 3> a{1, 2, 3};
+    const Vector<double, 3> v{0.5, -4, 2};
+    CHECK((a + v == Point<double, 3>{1.5, -2, 5}));
+    CHECK((a - v == Point<double, 3>{0.5, 6, 1}));
+    CHECK((Point<double, 3>{1.5, -2, 5} - a == v));
+    CHECK((v * 2.0 == Vector<double, 3>{1, -8, 4}));
+    CHECK((2.0 * v == v * 2.0));
+    CHECK((v / 2.0 == Vector<double, 3>{0.25, -2, 1}));
+    CHECK((-v == Vector<double, 3>{-0.5, 4, -2}));
+    CHECK(dot(v, v) == 20.25);
+    CHECK(length(v) == 4.5);
+
+    const Vector<double, 3> x{1, 0, 0};
+    const Vector<double, 3> y{0, 1, 0};
+    CHECK((cross(x, y) == Vector<double, 3>{0, 0, 1}));
+    CHECK((cross(y, x) == Vector<double, 3>{0, 0, -1}));
+    CHECK(dot(cross(v, x), v) == 0);
+
+    auto b = a;
+    b += v;
+    b -= v;
+    CHECK(b == a);
+    CHECK(a.z == 3);
+    CHECK(a[2] == 3);
+    CHECK(get<2>(a) == 3);
+    CHECK((Point<double, 3>{} == Point<double, 3>{0, 0, 0}));
+}
+
+void testArithmetic4()
+{
+    const Point<float, 4> a{1, 2, 3, 4};
+    const Vector<float, 4> v{4, 3, 2, 1};
+    CHECK((a + v == Point<float, 4>{5, 5, 5, 5}));
+    CHECK((a - v == Point<float, 4>{-3, -1, 1, 3}));
+    CHECK(dot(v, v) == 30);
+    CHECK(a.w == 4);
+    CHECK(a[3] == 4);
+
+    auto w = v;
+    w *= 2;
+    w /= 4;
+    CHECK((w == Vector<float, 4>{2, 1.5f, 1, 0.5f}));
+    CHECK(w != v);
+    CHECK((Point<float, 4>{0, 0, 0, 0} < a));
+    CHECK(!(a < a));
+    CHECK(a <= a);
+}
+
+// Dimensions past four store their components in an array
+void testArithmetic5()
+{
+    const Vector<double, 5> v{1, 2, 3, 4, 5};
+    const Point<double, 5> p{5, 4, 3, 2, 1};
+    CHECK((p + v == Point<double, 5>{6, 6, 6, 6, 6}));
+    CHECK(dot(v, v) == 55);
+    CHECK(get<4>(v) == 5);
+    CHECK(v[4] == 5);
+}
+
+// A zero vector normalizes to zero instead of NaN
+void testNormalized()
+{
+    CHECK((normalized(Vector<double, 2>{}) == Vector<double, 2>{}));
+    CHECK((normalized(Vector<float, 3>{}) == Vector<float, 3>{}));
+    CHECK((normalized(Vector<double, 4>{}) == Vector<double, 4>{}));
+
+    const auto n = normalized(Vector<double, 3>{3, 0, 4});
+    CHECK_NEAR(n.x, 0.6, 1e-15);
+    CHECK(n.y == 0);
+    CHECK_NEAR(n.z, 0.8, 1e-15);
+    CHECK_NEAR(length(normalized(Vector<float, 4>{1, 2, 3, 4})), 1, 1e-6);
+}
+
+} // namespace
+
+int main()
+{
+    testArithmetic3();
+    testArithmetic4();
+    testArithmetic5();
+    testNormalized();
+    return test::exitCode();
+}
@@ -0,0 +1,172 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/projection.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+// Longitudes and latitudes over the whole Mercator range, its limits, and
+// the poles past them
+std::vector<Point<double>> lonLats()
+{
+    std::mt19937 random(59);
+    std::uniform_real_distribution<double> longitude(-180, 180);
+    std::uniform_real_distribution<double> latitude(
+        -maxMercatorLatitude, maxMercatorLatitude);
+    std::vector<Point<double>> points;
+    for (double lat : {-90.0, -maxMercatorLatitude, -45.0, 0.0, 1e-9, 60.0,
+            maxMercatorLatitude, 90.0}) {
+        for (double lon : {-180.0, -0.5, 0.0, 179.999, 180.0}) {
+            points.push_back({lon, lat});
+        }
+    }
+    for (int i = 0; i < 20000; i++) {
+        points.push_back({longitude(random), latitude(random)});
+    }
+    return points;
+}
+
+double clamped(double latitude)
+{
+    return std::clamp(latitude, -maxMercatorLatitude, maxMercatorLatitude);
+}
+
+// The batch versions agree with the scalar ones to within the documented
+// 1e-7 m and 1e-13 degrees, also when projecting in place
+void testBatchMatchesScalar()
+{
+    const auto points = lonLats();
+    const std::size_t count = points.size();
+    std::vector<Point<double>> out(count);
+    std::vector<Point<double>> back(count);
+    std::vector<Point<double>> inPlace;
+
+    batch::toWebMercator(points.data(), count, out.data());
+    inPlace = points;
+    batch::toWebMercator(inPlace.data(), count, inPlace.data());
+    CHECK(inPlace == out);
+    for (std::size_t i = 0; i < count; i++) {
+        const auto expected = toWebMercator(points[i]);
+        CHECK_NEAR(out[i].x, expected.x, 1e-7);
+        CHECK_NEAR(out[i].y, expected.y, 1e-7);
+    }
+    batch::fromWebMercator(out.data(), count, back.data());
+    for (std::size_t i = 0; i < count; i++) {
+        const auto expected = fromWebMercator(out[i]);
+        CHECK_NEAR(back[i].x, expected.x, 1e-13);
+        CHECK_NEAR(back[i].y, expected.y, 1e-13);
+    }
+
+    for (double parallel : {0.0, 48.8}) {
+        batch::toEquirectangular(points.data(), count, out.data(), parallel);
+        inPlace = points;
+        batch::toEquirectangular(
+            inPlace.data(), count, inPlace.data(), parallel);
+        CHECK(inPlace == out);
+        for (std::size_t i = 0; i < count; i++) {
+            const auto expected = toEquirectangular(points[i], parallel);
+            CHECK_NEAR(out[i].x, expected.x, 1e-7);
+            CHECK_NEAR(out[i].y, expected.y, 1e-7);
+        }
+        batch::fromEquirectangular(out.data(), count, back.data(), parallel);
+        for (std::size_t i = 0; i < count; i++) {
+            const auto expected = fromEquirectangular(out[i], parallel);
+            CHECK_NEAR(back[i].x, expected.x, 1e-13);
+            CHECK_NEAR(back[i].y, expected.y, 1e-13);
+        }
+    }
+
+    // 1e-7 m is this fraction of the tile grid at any zoom level
+    const double fraction = 1e-7 / (2 * detail::pi * earthRadius);
+    for (int zoom : {0, 5, 18}) {
+        const double tiles = std::ldexp(1.0, zoom);
+        batch::lonLatToTile(points.data(), count, out.data(), zoom);
+        inPlace = points;
+        batch::lonLatToTile(inPlace.data(), count, inPlace.data(), zoom);
+        CHECK(inPlace == out);
+        for (std::size_t i = 0; i < count; i++) {
+            const auto expected = lonLatToTile(points[i], zoom);
+            CHECK_NEAR(out[i].x, expected.x, fraction * tiles);
+            CHECK_NEAR(out[i].y, expected.y, fraction * tiles);
+        }
+        batch::tileToLonLat(out.data(), count, back.data(), zoom);
+        for (std::size_t i = 0; i < count; i++) {
+            const auto expected = tileToLonLat(out[i], zoom);
+            CHECK_NEAR(back[i].x, expected.x, 1e-13);
+            CHECK_NEAR(back[i].y, expected.y, 1e-13);
+        }
+    }
+}
+
+// Projecting and unprojecting gives back the input, with latitudes
+// clamped to the Mercator range
+void testRoundTrips()
+{
+    const auto points = lonLats();
+    const std::size_t count = points.size();
+    std::vector<Point<double>> out(count);
+
+    for (const auto& point : points) {
+        const auto mercator = fromWebMercator(toWebMercator(point));
+        CHECK_NEAR(mercator.x, point.x, 1e-12);
+        CHECK_NEAR(mercator.y, clamped(point.y), 1e-12);
+
+        const auto equirectangular =
+            fromEquirectangular(toEquirectangular(point, 30), 30);
+        CHECK_NEAR(equirectangular.x, point.x, 1e-12);
+        CHECK_NEAR(equirectangular.y, point.y, 1e-12);
+
+        const auto tile = tileToLonLat(lonLatToTile(point, 12), 12);
+        CHECK_NEAR(tile.x, point.x, 1e-12);
+        CHECK_NEAR(tile.y, clamped(point.y), 1e-12);
+    }
+
+    batch::toWebMercator(points.data(), count, out.data());
+    batch::fromWebMercator(out.data(), count, out.data());
+    for (std::size_t i = 0; i < count; i++) {
+        CHECK_NEAR(out[i].x, points[i].x, 1e-12);
+        CHECK_NEAR(out[i].y, clamped(points[i].y), 1e-12);
+    }
+    batch::lonLatToTile(points.data(), count, out.data(), 12);
+    batch::tileToLonLat(out.data(), count, out.data(), 12);
+    for (std::size_t i = 0; i < count; i++) {
+        CHECK_NEAR(out[i].x, points[i].x, 1e-12);
+        CHECK_NEAR(out[i].y, clamped(points[i].y), 1e-12);
+    }
+}
+
+void testKnownValues()
+{
+    const double halfWorld = detail::pi * earthRadius;
+    const auto corner = toWebMercator({180, maxMercatorLatitude});
+    CHECK_NEAR(corner.x, halfWorld, 1e-7);
+    CHECK_NEAR(corner.y, halfWorld, 1e-7);
+    CHECK(toWebMercator({0, 90}) == toWebMercator({0, maxMercatorLatitude}));
+
+    const auto center = lonLatToTile({0, 0}, 0);
+    CHECK_NEAR(center.x, 0.5, 1e-15);
+    CHECK_NEAR(center.y, 0.5, 1e-15);
+    const auto topLeft = lonLatToTile({-180, maxMercatorLatitude}, 3);
+    CHECK_NEAR(topLeft.x, 0, 1e-12);
+    CHECK_NEAR(topLeft.y, 0, 1e-12);
+    const auto bottomRight = lonLatToTile({180, -maxMercatorLatitude}, 3);
+    CHECK_NEAR(bottomRight.x, 8, 1e-12);
+    CHECK_NEAR(bottomRight.y, 8, 1e-12);
+}
+
+} // namespace
+
+int main()
+{
+    testBatchMatchesScalar();
+    testRoundTrips();
+    testKnownValues();
+    return test::exitCode();
+}
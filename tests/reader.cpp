@@ -0,0 +1,159 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/reader.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+using Reader = PointReader<float>;
+
+// A temporary file of count points (i, -i), followed by trailingBytes
+// bytes of a partial point
+class PointFile {
+public:
+    PointFile(std::size_t count, std::size_t trailingBytes)
+    {
+        const int fd = mkstemp(_path);
+        CHECK(fd >= 0);
+        std::vector<Point<float>> points;
+        for (std::size_t i = 0; i < count; i++) {
+            points.push_back({float(i), -float(i)});
+        }
+        const std::size_t bytes =
+            count * sizeof(Point<float>) + trailingBytes;
+        std::vector<char> data(bytes, 'x');
+        std::copy(
+            reinterpret_cast<const char*>(points.data()),
+            reinterpret_cast<const char*>(points.data() + count),
+            data.data());
+        CHECK(::write(fd, data.data(), bytes) == ssize_t(bytes));
+        ::close(fd);
+    }
+
+    PointFile(const PointFile&) = delete;
+    PointFile& operator=(const PointFile&) = delete;
+
+    ~PointFile()
+    {
+        ::unlink(_path);
+    }
+
+    std::string path() const
+    {
+        return _path;
+    }
+
+    void truncate()
+    {
+        CHECK(::truncate(_path, 0) == 0);
+    }
+
+private:
+    char _path[32] = "/tmp/ecosnail-flat-XXXXXX";
+};
+
+const ReadBackend backends[] = {ReadBackend::IoUring, ReadBackend::Threads};
+
+// Chunks arrive whole and in order, the last one short, and the trailing
+// partial point is dropped. The vector passed to next() is recycled, so
+// only the slots' own buffers are ever handed out.
+void testOrder()
+{
+    constexpr std::size_t count = 10000;
+    const PointFile file(count, 5);
+    for (auto backend : backends) {
+        Reader reader(file.path(), 1024, 3, backend);
+        CHECK(reader.size() == count);
+
+        std::vector<Point<float>> chunk;
+        std::set<const Point<float>*> buffers;
+        std::size_t read = 0;
+        while (reader.next(chunk)) {
+            CHECK(chunk.size() == std::min<std::size_t>(1024, count - read));
+            for (std::size_t i = 0; i < chunk.size(); i++) {
+                const auto expected = float(read + i);
+                CHECK(chunk[i] == Point<float>{expected, -expected});
+            }
+            read += chunk.size();
+            buffers.insert(chunk.data());
+        }
+        CHECK(read == count);
+        CHECK(chunk.empty());
+        CHECK(buffers.size() <= 4);
+        CHECK(!reader.next(chunk));
+    }
+}
+
+void testEmpty()
+{
+    const PointFile file(0, 7);
+    for (auto backend : backends) {
+        Reader reader(file.path(), 16, 2, backend);
+        CHECK(reader.size() == 0);
+        std::vector<Point<float>> chunk(3);
+        CHECK(!reader.next(chunk));
+        CHECK(chunk.empty());
+    }
+}
+
+// A file that shrinks while it is read fails the reader for good
+void testErrors()
+{
+    for (auto backend : backends) {
+        PointFile file(1000, 0);
+        Reader reader(file.path(), 10, 1, backend);
+        file.truncate();
+
+        std::vector<Point<float>> chunk;
+        std::size_t chunks = 0;
+        int error = 0;
+        try {
+            while (reader.next(chunk)) {
+                chunks++;
+            }
+        } catch (const std::system_error& e) {
+            error = e.code().value();
+        }
+        CHECK(error != 0);
+        CHECK(chunks <= 1);
+
+        for (int attempt = 0; attempt < 2; attempt++) {
+            int again = 0;
+            try {
+                reader.next(chunk);
+            } catch (const std::system_error& e) {
+                again = e.code().value();
+            }
+            CHECK(again == error);
+        }
+    }
+
+    bool thrown = false;
+    try {
+        Reader reader("/nonexistent/ecosnail-flat-points");
+    } catch (const std::system_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+} // namespace
+
+int main()
+{
+    testOrder();
+    testEmpty();
+    testErrors();
+    return test::exitCode();
+}
@@ -0,0 +1,188 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/sampling.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+double squaredDistance(const Point<double>& lhs, const Point<double>& rhs)
+{
+    const double dx = lhs.x - rhs.x;
+    const double dy = lhs.y - rhs.y;
+    return dx * dx + dy * dy;
+}
+
+// No two picked points are closer than the radius, and every point left
+// out is closer than the radius to one that was picked
+void testSubsample()
+{
+    std::mt19937 random(41);
+    std::uniform_real_distribution<double> coordinate(0, 50);
+    std::vector<Point<double>> points(3000);
+    for (auto& point : points) {
+        point = {coordinate(random), coordinate(random)};
+    }
+    // exact duplicates keep at most one copy
+    for (std::size_t i = 0; i < 100; i++) {
+        points.push_back(points[i]);
+    }
+
+    const double radius = 1.5;
+    const auto picked = poissonDiskSubsample(
+        points.data(), points.size(), radius, 7);
+    CHECK(!picked.empty());
+    std::vector<bool> kept(points.size());
+    for (std::size_t i = 0; i < picked.size(); i++) {
+        CHECK(picked[i] < points.size());
+        CHECK(i == 0 || picked[i - 1] < picked[i]);
+        kept[picked[i]] = true;
+    }
+    for (std::size_t i = 0; i < picked.size(); i++) {
+        for (std::size_t j = i + 1; j < picked.size(); j++) {
+            CHECK(squaredDistance(points[picked[i]], points[picked[j]]) >=
+                radius * radius);
+        }
+    }
+    for (std::size_t i = 0; i < points.size(); i++) {
+        if (kept[i]) {
+            continue;
+        }
+        bool covered = false;
+        for (auto j : picked) {
+            covered = covered ||
+                squaredDistance(points[i], points[j]) < radius * radius;
+        }
+        CHECK(covered);
+    }
+
+    CHECK(poissonDiskSubsample(
+        points.data(), points.size(), radius, 7) == picked);
+    CHECK(poissonDiskSubsample<double>(nullptr, 0, radius).empty());
+}
+
+// Samples stay inside the rectangle, apart from each other, and fill it
+void testSample()
+{
+    const Point<double> min{-10, 5};
+    const Point<double> max{20, 25};
+    const double radius = 0.75;
+    const auto samples = poissonDiskSample(min, max, radius, 3);
+    for (const auto& sample : samples) {
+        CHECK(sample.x >= min.x && sample.x <= max.x);
+        CHECK(sample.y >= min.y && sample.y <= max.y);
+    }
+    for (std::size_t i = 0; i < samples.size(); i++) {
+        for (std::size_t j = i + 1; j < samples.size(); j++) {
+            CHECK(squaredDistance(samples[i], samples[j]) >= radius * radius);
+        }
+    }
+
+    // Disks of half the radius around the samples are disjoint, which
+    // bounds the count from above. Bridson's fill leaves no gaps wide
+    // enough for a new sample in practice, so disks of twice the radius
+    // cover the rectangle, which bounds it from below.
+    const double area = (max.x - min.x) * (max.y - min.y);
+    const double pi = std::acos(-1.0);
+    CHECK(double(samples.size()) <
+        (max.x - min.x + radius) * (max.y - min.y + radius) /
+            (pi * radius * radius / 4));
+    CHECK(double(samples.size()) > area / (pi * 4 * radius * radius));
+}
+
+void testInvalidRadius()
+{
+    const std::vector<Point<double>> points = {{0, 0}, {1, 1}};
+    for (double radius : {0.0, -1.0, double(NAN)}) {
+        bool thrown = false;
+        try {
+            poissonDiskSubsample(points.data(), points.size(), radius);
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+
+        thrown = false;
+        try {
+            poissonDiskSample<double>({0, 0}, {10, 10}, radius);
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+    }
+}
+
+// One output point per occupied cell, in order of each cell's first point
+void testDownsample()
+{
+    std::mt19937 random(43);
+    std::normal_distribution<double> coordinate(0, 40);
+    std::vector<Point<double>> points(200000);
+    for (auto& point : points) {
+        point = {coordinate(random), coordinate(random)};
+    }
+
+    const double cellSize = 2.5;
+    struct Cell {
+        std::size_t first = 0;
+        std::size_t size = 0;
+        Vector<double> sum;
+    };
+    std::map<std::pair<std::int64_t, std::int64_t>, Cell> cells;
+    for (std::size_t i = 0; i < points.size(); i++) {
+        const auto key = std::make_pair(
+            std::int64_t(std::floor(points[i].x / cellSize)),
+            std::int64_t(std::floor(points[i].y / cellSize)));
+        auto [it, inserted] = cells.try_emplace(key);
+        if (inserted) {
+            it->second.first = i;
+        }
+        it->second.size++;
+        it->second.sum += points[i] - Point<double>{};
+    }
+    std::vector<const Cell*> ordered;
+    for (const auto& cell : cells) {
+        ordered.push_back(&cell.second);
+    }
+    std::sort(ordered.begin(), ordered.end(),
+        [] (const Cell* lhs, const Cell* rhs) {
+            return lhs->first < rhs->first;
+        });
+
+    const auto first = gridDownsample(
+        points.data(), points.size(), cellSize, CellReduction::First);
+    const auto average = gridDownsample(
+        points.data(), points.size(), cellSize, CellReduction::Average);
+    CHECK(first.size() == cells.size());
+    CHECK(average.size() == cells.size());
+    for (std::size_t i = 0; i < ordered.size() && i < first.size(); i++) {
+        const auto& cell = *ordered[i];
+        CHECK(first[i] == points[cell.first]);
+        const auto centroid = cell.sum / double(cell.size);
+        CHECK_NEAR(average[i].x, centroid.x, 1e-9);
+        CHECK_NEAR(average[i].y, centroid.y, 1e-9);
+    }
+
+    CHECK(gridDownsample<double>(nullptr, 0, cellSize).empty());
+}
+
+} // namespace
+
+int main()
+{
+    testSubsample();
+    testSample();
+    testInvalidRadius();
+    testDownsample();
+    return test::exitCode();
+}
@@ -0,0 +1,174 @@
+#include "check.hpp"
+
+#if __has_include(<experimental/simd>)
+
+#include <ecosnail/flat/simd.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+using Packet = simd<float, 8>;
+constexpr std::size_t lanes = Packet::size();
+
+template <std::size_t N>
+std::vector<Point<float, N>> randomPoints(std::mt19937& random)
+{
+    std::uniform_real_distribution<float> coordinate(-10, 10);
+    std::vector<Point<float, N>> points(lanes);
+    for (auto& point : points) {
+        for (std::size_t c = 0; c < N; c++) {
+            point[c] = coordinate(random);
+        }
+    }
+    return points;
+}
+
+// Storing a loaded packet gives back the input, in either layout, and
+// every lane holds the point it was loaded from
+template <std::size_t N>
+void testRoundTrips()
+{
+    std::mt19937 random(61);
+    const auto points = randomPoints<N>(random);
+
+    Point<Packet, N> packet;
+    loadAos(packet, points.data());
+    for (std::size_t lane = 0; lane < lanes; lane++) {
+        for (std::size_t c = 0; c < N; c++) {
+            CHECK(packet[c][lane] == points[lane][c]);
+        }
+    }
+    std::vector<Point<float, N>> aos(lanes);
+    storeAos(packet, aos.data());
+    CHECK(aos == points);
+
+    std::vector<float> arrays[N];
+    const float* source[N];
+    float* target[N];
+    for (std::size_t c = 0; c < N; c++) {
+        arrays[c].resize(lanes);
+        for (std::size_t lane = 0; lane < lanes; lane++) {
+            arrays[c][lane] = points[lane][c];
+        }
+        source[c] = arrays[c].data();
+    }
+    Point<Packet, N> fromSoa;
+    loadSoa(fromSoa, source);
+    CHECK(all_of(fromSoa == packet));
+
+    std::vector<float> stored[N];
+    for (std::size_t c = 0; c < N; c++) {
+        stored[c].assign(lanes, -1);
+        target[c] = stored[c].data();
+    }
+    storeSoa(fromSoa, target);
+    for (std::size_t c = 0; c < N; c++) {
+        CHECK(stored[c] == arrays[c]);
+    }
+
+    // vectors load the same way
+    std::vector<Vector<float, N>> vectors(lanes);
+    for (std::size_t lane = 0; lane < lanes; lane++) {
+        vectors[lane] = points[lane] - Point<float, N>{};
+    }
+    Vector<Packet, N> vectorPacket;
+    loadAos(vectorPacket, vectors.data());
+    std::vector<Vector<float, N>> storedVectors(lanes);
+    storeAos(vectorPacket, storedVectors.data());
+    CHECK(storedVectors == vectors);
+}
+
+// Comparisons of packets give one result per lane, matching the scalar
+// comparison of the points in that lane
+void testComparisons()
+{
+    std::mt19937 random(67);
+    auto lhs = randomPoints<2>(random);
+    auto rhs = randomPoints<2>(random);
+    // equal, dominating, partly equal and incomparable lanes besides the
+    // random ones
+    rhs[0] = lhs[0];
+    rhs[1] = {lhs[1].x + 1, lhs[1].y + 1};
+    rhs[2] = {lhs[2].x, lhs[2].y + 1};
+    rhs[3] = {lhs[3].x - 1, lhs[3].y - 1};
+    rhs[4] = {lhs[4].x + 1, lhs[4].y - 1};
+
+    Point<Packet, 2> left;
+    Point<Packet, 2> right;
+    loadAos(left, lhs.data());
+    loadAos(right, rhs.data());
+    const auto equal = left == right;
+    const auto unequal = left != right;
+    const auto less = left < right;
+    const auto lessEqual = left <= right;
+    const auto greater = left > right;
+    const auto greaterEqual = left >= right;
+    for (std::size_t lane = 0; lane < lanes; lane++) {
+        CHECK(equal[lane] == (lhs[lane] == rhs[lane]));
+        CHECK(unequal[lane] == (lhs[lane] != rhs[lane]));
+        CHECK(less[lane] == (lhs[lane] < rhs[lane]));
+        CHECK(lessEqual[lane] == (lhs[lane] <= rhs[lane]));
+        CHECK(greater[lane] == (lhs[lane] > rhs[lane]));
+        CHECK(greaterEqual[lane] == (lhs[lane] >= rhs[lane]));
+    }
+    CHECK(equal[0] && less[1] && less[2] && greater[3]);
+    CHECK(!lessEqual[4] && !greaterEqual[4] && unequal[4]);
+
+    const auto difference = right - left;
+    const auto vectorEqual = difference == difference * 1.0f;
+    CHECK(all_of(vectorEqual));
+}
+
+// Zero-length lanes normalize to zero while the others get unit length
+void testNormalized()
+{
+    std::vector<Vector<float, 3>> vectors(lanes);
+    for (std::size_t lane = 0; lane < lanes; lane++) {
+        vectors[lane] = lane % 3 == 0 ?
+            Vector<float, 3>{} : Vector<float, 3>{float(lane), 1, -2};
+    }
+    Vector<Packet, 3> packet;
+    loadAos(packet, vectors.data());
+    std::vector<Vector<float, 3>> normal(lanes);
+    storeAos(normalized(packet), normal.data());
+    const auto lengths = length(packet);
+    for (std::size_t lane = 0; lane < lanes; lane++) {
+        CHECK_NEAR(lengths[lane], length(vectors[lane]), 1e-6);
+        if (lane % 3 == 0) {
+            CHECK(normal[lane] == Vector<float, 3>{});
+        } else {
+            const auto expected = normalized(vectors[lane]);
+            for (std::size_t c = 0; c < 3; c++) {
+                CHECK_NEAR(normal[lane][c], expected[c], 1e-6);
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    testRoundTrips<2>();
+    testRoundTrips<3>();
+    testRoundTrips<4>();
+    testComparisons();
+    testNormalized();
+    return test::exitCode();
+}
+
+#else
+
+// Packets need <experimental/simd>; without it there is nothing to test
+int main()
+{
+    return 0;
+}
+
+#endif
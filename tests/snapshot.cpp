@@ -0,0 +1,145 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/snapshot.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+using Buffer = SnapshotBuffer<Point<float>>;
+
+// Snapshots keep the frame they were taken from, whatever the writer does
+// afterwards, and publish() fails while every other slot is pinned.
+void testFrames()
+{
+    Buffer buffer(3000, 2);
+    CHECK(buffer.chunkCount() == 3);
+    for (std::size_t i = 0; i < buffer.size(); i++) {
+        buffer.set(i, {float(i), 1});
+    }
+    CHECK(buffer.publish());
+
+    auto second = [&] {
+        const auto first = buffer.read();
+        CHECK(first.frame() == 1);
+        buffer.set(5, {-1, -1});
+        CHECK(buffer[5] == Point<float>{-1, -1});
+        CHECK(first[5] == Point<float>{5, 1});
+
+        CHECK(buffer.publish());
+        auto next = buffer.read();
+        CHECK(next.frame() == 2);
+        CHECK(next[5] == Point<float>{-1, -1});
+        CHECK(next[2999] == Point<float>{2999, 1});
+
+        buffer.set(2000, {0, 0});
+        CHECK(!buffer.publish());
+        CHECK(first[5] == Point<float>{5, 1});
+        return next;
+    }();
+    CHECK(buffer.publish());
+
+    // unchanged chunks are shared between frames, changed ones are not
+    const auto third = buffer.read();
+    CHECK(third.frame() == 3);
+    CHECK(third.coordinates(0, 0) == second.coordinates(0, 0));
+    CHECK(third.coordinates(1, 0) != second.coordinates(1, 0));
+    CHECK(third.coordinates(2, 0) == second.coordinates(2, 0));
+    CHECK(second[2000] == Point<float>{2000, 1});
+    CHECK(third[2000] == Point<float>{0, 0});
+}
+
+// Once the slots have cycled, copies reuse the same few buffers
+void testRecycling()
+{
+    Buffer buffer(1024, 3);
+    std::vector<const float*> seen;
+    for (int frame = 0; frame < 100; frame++) {
+        buffer.set(0, {float(frame), 0});
+        CHECK(buffer.publish());
+        const auto* data = buffer.read().coordinates(0, 0);
+        bool known = false;
+        for (const auto* other : seen) {
+            known = known || other == data;
+        }
+        if (!known) {
+            seen.push_back(data);
+        }
+    }
+    CHECK(seen.size() <= 4);
+}
+
+// A writer fills one chunk per frame with a counter while readers check
+// that every chunk they see is whole and that frames only move forward.
+void testConcurrentReaders()
+{
+    constexpr std::size_t chunkCount = 8;
+    constexpr int updates = 2000;
+    Buffer buffer(chunkCount * Buffer::chunkSize);
+    std::atomic<bool> writing{true};
+    std::atomic<std::size_t> torn{0};
+    std::atomic<std::size_t> backwards{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; r++) {
+        readers.emplace_back([&] {
+            std::uint64_t lastFrame = 0;
+            do {
+                const auto snapshot = buffer.read();
+                if (snapshot.frame() < lastFrame) {
+                    backwards++;
+                }
+                lastFrame = snapshot.frame();
+                for (std::size_t c = 0; c < snapshot.chunkCount(); c++) {
+                    const float* xs = snapshot.coordinates(c, 0);
+                    const float* ys = snapshot.coordinates(c, 1);
+                    for (std::size_t i = 0; i < Buffer::chunkSize; i++) {
+                        if (xs[i] != xs[0] || ys[i] != -xs[0]) {
+                            torn++;
+                            break;
+                        }
+                    }
+                }
+            } while (writing.load());
+        });
+    }
+
+    for (int update = 1; update <= updates; update++) {
+        const std::size_t chunk = update % chunkCount;
+        float* xs = buffer.writableCoordinates(chunk, 0);
+        float* ys = buffer.writableCoordinates(chunk, 1);
+        for (std::size_t i = 0; i < Buffer::chunkSize; i++) {
+            xs[i] = float(update);
+            ys[i] = -float(update);
+        }
+        buffer.publish();
+    }
+    writing = false;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    CHECK(torn == 0);
+    CHECK(backwards == 0);
+    while (!buffer.publish()) { }
+    const auto last = buffer.read();
+    for (std::size_t c = 0; c < chunkCount; c++) {
+        const int expected = updates - int((updates - c) % chunkCount);
+        CHECK(last[c * Buffer::chunkSize].x == float(expected));
+    }
+}
+
+} // namespace
+
+int main()
+{
+    testFrames();
+    testRecycling();
+    testConcurrentReaders();
+    return test::exitCode();
+}
@@ -0,0 +1,195 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/stroke.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+struct Mesh {
+    std::vector<StrokeVertex<double>> vertices;
+    std::vector<std::uint32_t> indices;
+};
+
+Mesh strokeOf(
+    const std::vector<Point<double>>& points, const StrokeStyle<double>& style)
+{
+    const auto size = strokeSize(points.data(), points.size(), style);
+    Mesh mesh;
+    mesh.vertices.resize(size.vertices);
+    mesh.indices.resize(size.indices);
+    const auto written = strokePolyline(points.data(), points.size(), style,
+        mesh.vertices.data(), mesh.indices.data());
+    CHECK(written.vertices == size.vertices);
+    CHECK(written.indices == size.indices);
+    return mesh;
+}
+
+double cross(const Vector<double>& lhs, const Vector<double>& rhs)
+{
+    return lhs.x * rhs.y - lhs.y * rhs.x;
+}
+
+double area(const Mesh& mesh)
+{
+    double sum = 0;
+    for (std::size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        const auto& a = mesh.vertices[mesh.indices[i]].position;
+        const auto& b = mesh.vertices[mesh.indices[i + 1]].position;
+        const auto& c = mesh.vertices[mesh.indices[i + 2]].position;
+        sum += std::abs(cross(b - a, c - a)) / 2;
+    }
+    return sum;
+}
+
+// Every vertex off the center line must be labelled -1 on the left of the
+// polyline and 1 on its right, judged from the closest segment.
+void checkSides(
+    const std::vector<Point<double>>& points,
+    const Mesh& mesh,
+    double halfWidth)
+{
+    for (const auto& vertex : mesh.vertices) {
+        double closest = INFINITY;
+        double offset = 0;
+        for (std::size_t i = 0; i + 1 < points.size(); i++) {
+            const auto segment = points[i + 1] - points[i];
+            const auto relative = vertex.position - points[i];
+            const double t = std::clamp(
+                dot(relative, segment) / squaredLength(segment), 0.0, 1.0);
+            const double distance = length(relative - segment * t);
+            if (distance < closest) {
+                closest = distance;
+                offset = cross(normalized(segment), relative);
+            }
+        }
+        CHECK(closest <= halfWidth * 1.5);
+        if (std::abs(offset) < 1e-9) {
+            // center vertices, and round cap tips
+            CHECK(vertex.side == 0 || std::abs(vertex.side) == 1);
+        } else {
+            CHECK(vertex.side == (offset > 0 ? -1 : 1));
+        }
+    }
+    for (auto index : mesh.indices) {
+        CHECK(index < mesh.vertices.size());
+    }
+}
+
+void testCaps()
+{
+    const std::vector<Point<double>> line {{0, 0}, {10, 0}};
+    StrokeStyle<double> style;
+    style.width = 2;
+    style.tolerance = 0.01;
+
+    style.cap = LineCap::Butt;
+    auto mesh = strokeOf(line, style);
+    checkSides(line, mesh, 1);
+    CHECK_NEAR(area(mesh), 20, 1e-9);
+
+    style.cap = LineCap::Square;
+    mesh = strokeOf(line, style);
+    checkSides(line, mesh, 1);
+    CHECK_NEAR(area(mesh), 24, 1e-9);
+    for (const auto& vertex : mesh.vertices) {
+        if (vertex.position.x == -1 || vertex.position.x == 11) {
+            CHECK(vertex.side == (vertex.position.y > 0 ? -1 : 1));
+        }
+    }
+
+    style.cap = LineCap::Round;
+    mesh = strokeOf(line, style);
+    checkSides(line, mesh, 1);
+    CHECK_NEAR(area(mesh), 20 + detail::pi, 0.05);
+    for (const auto& vertex : mesh.vertices) {
+        if (vertex.position.y > 1e-9) {
+            CHECK(vertex.side == -1);
+        } else if (vertex.position.y < -1e-9) {
+            CHECK(vertex.side == 1);
+        }
+    }
+}
+
+void testJoins()
+{
+    // a left turn, a right turn, and a closing zero-length segment
+    const std::vector<Point<double>> path {
+        {0, 0}, {10, 0}, {10, 10}, {20, 10}, {20, 10}};
+    StrokeStyle<double> style;
+    style.width = 2;
+    for (auto join : {LineJoin::Miter, LineJoin::Bevel, LineJoin::Round}) {
+        for (auto cap : {LineCap::Butt, LineCap::Square, LineCap::Round}) {
+            style.join = join;
+            style.cap = cap;
+            const auto mesh = strokeOf(path, style);
+            checkSides(path, mesh, 1);
+            CHECK(mesh.vertices.back().distance == 30);
+        }
+    }
+
+    // miters are clipped to bevels beyond the limit
+    const std::vector<Point<double>> spike {{0, 0}, {10, 0}, {0, 1}};
+    style.join = LineJoin::Miter;
+    style.cap = LineCap::Butt;
+    style.miterLimit = 4;
+    const auto mesh = strokeOf(spike, style);
+    for (const auto& vertex : mesh.vertices) {
+        CHECK(vertex.position.x <= 11 + 1e-9);
+    }
+}
+
+void testEmpty()
+{
+    StrokeStyle<double> style;
+    const std::vector<Point<double>> single {{1, 1}};
+    CHECK(strokeSize(single.data(), single.size(), style).vertices == 0);
+    const std::vector<Point<double>> repeated {{1, 1}, {1, 1}};
+    CHECK(strokeSize(repeated.data(), repeated.size(), style).indices == 0);
+}
+
+// Round joins and caps need a positive tolerance; other styles ignore it
+void testTolerance()
+{
+    const std::vector<Point<double>> points {{0, 0}, {4, 0}, {4, 4}};
+    for (double tolerance : {0.0, -1.0, double(NAN)}) {
+        for (int round = 0; round < 2; round++) {
+            StrokeStyle<double> style;
+            style.tolerance = tolerance;
+            if (round == 0) {
+                style.join = LineJoin::Round;
+            } else {
+                style.cap = LineCap::Round;
+            }
+            bool thrown = false;
+            try {
+                strokeSize(points.data(), points.size(), style);
+            } catch (const std::invalid_argument&) {
+                thrown = true;
+            }
+            CHECK(thrown);
+        }
+
+        StrokeStyle<double> style;
+        style.tolerance = tolerance;
+        style.join = LineJoin::Bevel;
+        CHECK(strokeSize(points.data(), points.size(), style).indices > 0);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    testCaps();
+    testJoins();
+    testEmpty();
+    testTolerance();
+    return test::exitCode();
+}
@@ -0,0 +1,207 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/tiles.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+// A temporary directory for pyramid files, removed with its contents
+class Directory {
+public:
+    Directory()
+    {
+        CHECK(::mkdtemp(_path) != nullptr);
+    }
+
+    Directory(const Directory&) = delete;
+    Directory& operator=(const Directory&) = delete;
+
+    ~Directory()
+    {
+        for (const auto& file : _files) {
+            ::unlink(file.c_str());
+        }
+        ::rmdir(_path);
+    }
+
+    std::string file(const std::string& name)
+    {
+        _files.push_back(std::string{_path} + "/" + name);
+        return _files.back();
+    }
+
+private:
+    char _path[32] = "/tmp/ecosnail-flat-XXXXXX";
+    std::vector<std::string> _files;
+};
+
+bool exists(const std::string& path)
+{
+    struct stat info;
+    return ::stat(path.c_str(), &info) == 0;
+}
+
+// Clusters, exact duplicates and a sparse background, so that the pyramid
+// has deep and shallow tiles, and a cell that cannot be split
+std::vector<Point<float>> testPoints()
+{
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> background(-1000, 1000);
+    std::normal_distribution<float> cluster(0, 1);
+    std::vector<Point<float>> points;
+    for (int i = 0; i < 500; i++) {
+        points.push_back({background(random), background(random)});
+    }
+    for (const Point<float> center : {Point<float>{100, 100}, {-300, 50}}) {
+        for (int i = 0; i < 1500; i++) {
+            points.push_back(
+                {center.x + cluster(random), center.y + cluster(random)});
+        }
+    }
+    for (int i = 0; i < 200; i++) {
+        points.push_back({7, -7});
+    }
+    std::shuffle(points.begin(), points.end(), random);
+    return points;
+}
+
+bool before(const Point<float>& lhs, const Point<float>& rhs)
+{
+    return lhs.x < rhs.x || (lhs.x == rhs.x && lhs.y < rhs.y);
+}
+
+double squaredDistance(const Point<float>& lhs, const Point<float>& rhs)
+{
+    const double dx = double(lhs.x) - double(rhs.x);
+    const double dy = double(lhs.y) - double(rhs.y);
+    return dx * dx + dy * dy;
+}
+
+// Queries over a small pyramid return what a linear scan does
+void testQueries()
+{
+    Directory directory;
+    const auto path = directory.file("points.tiles");
+    const auto points = testPoints();
+    TilePyramidOptions options;
+    options.tileCapacity = 64;
+    options.maxLevel = 10;
+    options.writeBuffer = 16;
+    buildTilePyramid(path, points.data(), points.size(), options);
+    CHECK(!exists(path + ".tmp"));
+
+    const TilePyramid<float> pyramid(path, 4);
+    CHECK(pyramid.size() == points.size());
+    CHECK(pyramid.tileCount() > 10);
+
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> coordinate(-1100, 1100);
+    std::uniform_real_distribution<float> extent(0, 300);
+    for (int query = 0; query < 100; query++) {
+        Rectangle<float> rectangle;
+        rectangle.min = {coordinate(random), coordinate(random)};
+        if (query % 10 == 0) {
+            // around a cluster, and exactly on the duplicates
+            rectangle.min = query % 20 ?
+                Point<float>{95, 95} : Point<float>{7, -7};
+        }
+        rectangle.max = {
+            rectangle.min.x + extent(random),
+            rectangle.min.y + extent(random)};
+
+        std::vector<Point<float>> expected;
+        for (const auto& point : points) {
+            if (contains(rectangle, point)) {
+                expected.push_back(point);
+            }
+        }
+        std::vector<Point<float>> found;
+        pyramid.forEachInside(rectangle, [&] (const Point<float>& point) {
+            found.push_back(point);
+        });
+        std::sort(expected.begin(), expected.end(), before);
+        std::sort(found.begin(), found.end(), before);
+        CHECK(found == expected);
+
+        const Point<float> center{coordinate(random), coordinate(random)};
+        const std::size_t k = query % 7 == 0 ? 300 : std::size_t(query % 13);
+        auto sorted = points;
+        std::sort(sorted.begin(), sorted.end(), [&] (
+                const Point<float>& lhs, const Point<float>& rhs) {
+            return squaredDistance(lhs, center) < squaredDistance(rhs, center);
+        });
+        const auto nearest = pyramid.nearest(center, k);
+        CHECK(nearest.size() == k);
+        for (std::size_t i = 0; i < nearest.size(); i++) {
+            // ties may come in any order, so compare distances only
+            CHECK(squaredDistance(nearest[i], center) ==
+                squaredDistance(sorted[i], center));
+        }
+    }
+}
+
+// An empty pyramid answers every query with nothing
+void testEmpty()
+{
+    Directory directory;
+    const auto path = directory.file("empty.tiles");
+    buildTilePyramid<float>(path, nullptr, 0);
+
+    const TilePyramid<float> pyramid(path);
+    CHECK(pyramid.size() == 0);
+    CHECK(pyramid.tileCount() == 0);
+    std::size_t found = 0;
+    pyramid.forEachInside({{-10, -10}, {10, 10}}, [&] (const Point<float>&) {
+        found++;
+    });
+    CHECK(found == 0);
+    CHECK(pyramid.nearest({0, 0}, 5).empty());
+}
+
+// A failed build leaves no temporary file behind; here the rename fails,
+// as the destination is a directory that is not empty
+void testFailure()
+{
+    Directory directory;
+    const auto path = directory.file("directory.tiles");
+    CHECK(::mkdir(path.c_str(), 0755) == 0);
+    const auto child = path + "/child";
+    const int fd = ::open(child.c_str(), O_WRONLY | O_CREAT, 0644);
+    CHECK(fd >= 0);
+    ::close(fd);
+
+    const std::vector<Point<float>> points = {{0, 0}, {1, 1}};
+    bool thrown = false;
+    try {
+        buildTilePyramid(path, points.data(), points.size());
+    } catch (const std::system_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(!exists(path + ".tmp"));
+    ::unlink(child.c_str());
+    ::rmdir(path.c_str());
+}
+
+} // namespace
+
+int main()
+{
+    testQueries();
+    testEmpty();
+    testFailure();
+    return test::exitCode();
+}
@@ -0,0 +1,146 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/tracked.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+template <class T>
+using Points = std::vector<Point<T>>;
+
+// Queries match a recomputation from scratch. Integer coordinates keep the
+// sums exact, so even the centroid must match to the last bit.
+template <class T>
+void checkQueries(const TrackedPoints<T>& tracked, const Points<T>& points)
+{
+    CHECK(tracked.size() == points.size());
+    CHECK(std::equal(points.begin(), points.end(), tracked.data()));
+
+    const auto& bounds = tracked.bounds();
+    if (points.empty()) {
+        CHECK(bounds.min.x > bounds.max.x);
+        CHECK(bounds.min.y > bounds.max.y);
+    } else {
+        Rectangle<T> expected{points[0], points[0]};
+        for (const auto& point : points) {
+            expected.min.x = std::min(expected.min.x, point.x);
+            expected.min.y = std::min(expected.min.y, point.y);
+            expected.max.x = std::max(expected.max.x, point.x);
+            expected.max.y = std::max(expected.max.y, point.y);
+        }
+        CHECK(bounds.min == expected.min);
+        CHECK(bounds.max == expected.max);
+    }
+
+    Vector<T> sum {};
+    for (const auto& point : points) {
+        sum += point - Point<T>{};
+    }
+    const auto centroid = points.empty() ?
+        Point<T>{} : Point<T>{} + sum / T(points.size());
+    CHECK(tracked.centroid() == centroid);
+
+    Points<T> hull(points.size());
+    hull.resize(convexHull(points.data(), points.size(), hull.data()));
+    CHECK(tracked.hull() == hull);
+}
+
+// Random edits through every modifier, with queries in between so that
+// some caches are reused and others recomputed
+template <class T>
+void testRandomEdits()
+{
+    std::mt19937 random(37);
+    std::uniform_int_distribution<int> coordinate(-1000, 1000);
+    auto randomPoint = [&] {
+        return Point<T>{T(coordinate(random)), T(coordinate(random))};
+    };
+
+    Points<T> initial(700);
+    for (auto& point : initial) {
+        point = randomPoint();
+    }
+    TrackedPoints<T> tracked(initial);
+    Points<T> points = initial;
+    checkQueries(tracked, points);
+
+    for (int step = 0; step < 3000; step++) {
+        const int operation = int(random() % 100);
+        if (operation < 30 && !points.empty()) {
+            const auto i = random() % points.size();
+            const auto point = randomPoint();
+            tracked.set(i, point);
+            points[i] = point;
+        } else if (operation < 40 && !points.empty()) {
+            const auto begin = random() % points.size();
+            const auto end = std::min<std::size_t>(
+                points.size(), begin + random() % 600);
+            auto* modified = tracked.modify(begin, end);
+            for (std::size_t i = begin; i < end; i++) {
+                modified[i - begin] = randomPoint();
+                points[i] = modified[i - begin];
+            }
+        } else if (operation < 70) {
+            const auto point = randomPoint();
+            tracked.push(point);
+            points.push_back(point);
+        } else if (operation < 98 && !points.empty()) {
+            tracked.pop();
+            points.pop_back();
+        } else if (operation < 99) {
+            tracked.clear();
+            points.clear();
+        }
+
+        // one quantity at a time, so the others go stale for longer
+        switch (random() % 5) {
+            case 0: tracked.bounds(); break;
+            case 1: tracked.centroid(); break;
+            case 2: tracked.hull(); break;
+            case 3: checkQueries(tracked, points); break;
+            default: break;
+        }
+    }
+    checkQueries(tracked, points);
+}
+
+// Points written outside the range given to modify() only count once
+// markChanged() is called
+void testMarkChanged()
+{
+    TrackedPoints<double> tracked(Points<double>{{0, 0}, {4, 0}, {0, 3}});
+    checkQueries(tracked, {{0, 0}, {4, 0}, {0, 3}});
+
+    auto* points = tracked.modify(0, 0);
+    points[1] = {10, 10};
+    CHECK(tracked.bounds().max == Point<double>{4, 3});
+    tracked.markChanged(1, 2);
+    checkQueries(tracked, {{0, 0}, {10, 10}, {0, 3}});
+}
+
+void testEmpty()
+{
+    TrackedPoints<double> tracked;
+    checkQueries(tracked, {});
+    tracked.push({1, 2});
+    checkQueries(tracked, {{1, 2}});
+    tracked.pop();
+    checkQueries(tracked, {});
+}
+
+} // namespace
+
+int main()
+{
+    testRandomEdits<double>();
+    testRandomEdits<float>();
+    testMarkChanged();
+    testEmpty();
+    return test::exitCode();
+}
@@ -0,0 +1,187 @@
+#include "check.hpp"
+
+#include <ecosnail/flat/fastmath.hpp>
+#include <ecosnail/flat/triangulation.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace ecosnail::flat;
+
+namespace {
+
+double triangleArea(
+    const std::vector<Point<double>>& points,
+    const std::vector<std::uint32_t>& indices)
+{
+    double sum = 0;
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const auto& a = points[indices[i]];
+        const auto& b = points[indices[i + 1]];
+        const auto& c = points[indices[i + 2]];
+        sum += std::abs(
+            (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)) / 2;
+    }
+    return sum;
+}
+
+double ringArea(
+    const std::vector<Point<double>>& points,
+    std::size_t begin,
+    std::size_t end)
+{
+    double sum = 0;
+    for (std::size_t i = begin, j = end - 1; i < end; j = i++) {
+        sum += (points[j].x - points[i].x) * (points[j].y + points[i].y);
+    }
+    return std::abs(sum) / 2;
+}
+
+void addCircle(
+    std::vector<Point<double>>& points,
+    std::size_t count,
+    double radius,
+    double wobble)
+{
+    for (std::size_t i = 0; i < count; i++) {
+        const double angle = 2 * detail::pi * i / count;
+        const double r = radius * (1 + wobble * ((i % 2) ? 1 : -1));
+        points.push_back({r * std::cos(angle), r * std::sin(angle)});
+    }
+}
+
+// A jagged ring with a hole: both paths must tile it exactly
+void testSimple()
+{
+    std::vector<Point<double>> points;
+    addCircle(points, 1500, 10, 0.1);
+    const std::size_t holeStart = points.size();
+    addCircle(points, 1200, 3, 0.05);
+    const double expected = ringArea(points, 0, holeStart) -
+        ringArea(points, holeStart, points.size());
+
+    std::vector<std::uint32_t> monotone;
+    CHECK(monotoneTriangulate(
+        points.data(), points.size(), &holeStart, 1, monotone));
+    CHECK(monotone.size() == 3 * (points.size() + 2 - 2));
+    CHECK_NEAR(triangleArea(points, monotone), expected, 1e-9 * expected);
+
+    std::vector<std::uint32_t> ears;
+    earcut(points.data(), points.size(), &holeStart, 1, ears);
+    CHECK_NEAR(triangleArea(points, ears), expected, 1e-9 * expected);
+}
+
+// Collinear points along the sides of a square are dropped, not split on
+void testCollinear()
+{
+    std::vector<Point<double>> points;
+    const std::size_t side = 400;
+    for (std::size_t i = 0; i < side; i++) {
+        points.push_back({double(i), 0});
+    }
+    for (std::size_t i = 0; i < side; i++) {
+        points.push_back({double(side), double(i)});
+    }
+    for (std::size_t i = 0; i < side; i++) {
+        points.push_back({double(side - i), double(side)});
+    }
+    for (std::size_t i = 0; i < side; i++) {
+        points.push_back({0, double(side - i)});
+    }
+
+    std::vector<std::uint32_t> indices;
+    CHECK(monotoneTriangulate(
+        points.data(), points.size(), nullptr, 0, indices));
+    CHECK(indices.size() == 3 * 2);
+    CHECK_NEAR(triangleArea(points, indices), side * side, 1e-9);
+}
+
+// Rings the sweep cannot handle are rejected without output, and
+// triangulate() falls back to ear clipping for them instead of crashing.
+void testDegenerate()
+{
+    // a ring circling the same few vertices over and over
+    std::vector<Point<double>> repeated;
+    const Point<double> corners[] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}, {2, 2}};
+    for (std::size_t i = 0; i < 1500; i++) {
+        repeated.push_back(corners[i % 5]);
+    }
+
+    // a star polygon whose every edge crosses others
+    std::vector<Point<double>> crossing;
+    const std::size_t count = 1501;
+    for (std::size_t i = 0; i < count; i++) {
+        const double angle = 2 * detail::pi * (2 * i % count) / count;
+        crossing.push_back({std::cos(angle), std::sin(angle)});
+    }
+
+    // spikes and duplicates around a square, with a repeated hole
+    std::vector<Point<double>> spiky;
+    for (std::size_t i = 0; i < 1200; i++) {
+        const double t = double(i) / 300;
+        const Point<double> corner = t < 1 ? Point<double>{t, 0} :
+            t < 2 ? Point<double>{1, t - 1} :
+            t < 3 ? Point<double>{3 - t, 1} : Point<double>{0, 4 - t};
+        spiky.push_back(corner);
+        if (i % 7 == 0) {
+            spiky.push_back({corner.x + 0.5, corner.y + 0.5});
+            spiky.push_back(corner);
+        }
+    }
+    const std::size_t spikyHole = spiky.size();
+    for (std::size_t i = 0; i < 3; i++) {
+        spiky.push_back({0.25, 0.25});
+        spiky.push_back({0.75, 0.25});
+        spiky.push_back({0.5, 0.75});
+    }
+
+    for (const auto* points : {&repeated, &crossing}) {
+        std::vector<std::uint32_t> indices = {7, 8, 9};
+        CHECK(!monotoneTriangulate(
+            points->data(), points->size(), nullptr, 0, indices));
+        CHECK(indices == std::vector<std::uint32_t>{7, 8, 9});
+
+        indices.clear();
+        triangulate(points->data(), points->size(), nullptr, 0, indices);
+        CHECK(indices.size() % 3 == 0);
+        for (auto index : indices) {
+            CHECK(index < points->size());
+        }
+    }
+
+    std::vector<std::uint32_t> indices;
+    triangulate(spiky.data(), spiky.size(), &spikyHole, 1, indices);
+    CHECK(indices.size() % 3 == 0);
+    for (auto index : indices) {
+        CHECK(index < spiky.size());
+    }
+}
+
+// Appending many polygons to one buffer must keep the vector's geometric
+// growth: a handful of reallocations, not one per polygon.
+void testAppending()
+{
+    const std::vector<Point<double>> square = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+    std::vector<std::uint32_t> indices;
+    std::size_t reallocations = 0;
+    for (int polygon = 0; polygon < 10000; polygon++) {
+        const auto* data = indices.data();
+        triangulate(square.data(), square.size(), nullptr, 0, indices);
+        reallocations += indices.data() != data;
+    }
+    CHECK(indices.size() == 10000 * 6);
+    CHECK(reallocations < 64);
+}
+
+} // namespace
+
+int main()
+{
+    testSimple();
+    testCollinear();
+    testDegenerate();
+    testAppending();
+    return test::exitCode();
+}